@@ -0,0 +1,348 @@
+// Benchmark/CoordinatorLoopback.cpp
+// 分布式协调器的回环测试：在本机启动 DistributedCoordinator，用线程模拟若干 SimAgent
+// (相同的文本协议，评估用固定延迟与解析代价代替 SimWorker)，依次检查
+//   multi_agent  多个 Agent 并发评估：每个任务恰好仿真一次，结果与代价函数一致
+//   reconnect    Agent 断线后重连：旧连接上的任务继续运行并在新连接上回报，协调器直接采用而不重复派发；
+//                遗留任务排在队首时，后面的新任务照常派发到空闲槽位，不会卡住队列
+//   agent_lost   Agent 断线不再回来：其任务重新派发给其他 Agent 并全部完成
+// 全部通过返回 0，否则返回 1。
+//
+// 用法: CoordinatorLoopback [--agents 3] [--slots 2] [--jobs 60] [--latency-ms 20] [--orphan-ms 1000]
+
+#include "../Optimize/Utils/NetUtils.h" // 必须最先包含 (winsock2.h 早于 windows.h)
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include "../Optimize/Utils/DistributedCoordinator.h"
+
+static double loopbackCost(const std::vector<double>& params) {
+    double sum = 0.0;
+    for (double p : params) sum += p * p;
+    return sum;
+}
+
+// 模拟的计算节点：收到 EVAL 后等待 latencyMs 再回传 RESULT。
+// 与 SimAgent 一样，结果总是发往当前连接；断线期间完成的评估被丢弃
+class LoopbackAgent {
+public:
+    LoopbackAgent(const std::string& name, int slots, int port, int latencyMs)
+        : m_name(name), m_slots(slots), m_port(port), m_latencyMs(latencyMs) {}
+
+    ~LoopbackAgent() { stop(); }
+
+    bool connect() {
+        NetUtils::socket_t s = NetUtils::connectTo("127.0.0.1", m_port);
+        if (s == NetUtils::INVALID) return false;
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            m_sock = s;
+        }
+        send("HELLO " + m_name + " " + std::to_string(m_slots));
+        m_reader = std::thread(&LoopbackAgent::serve, this, s);
+        return true;
+    }
+
+    // 模拟网络中断：关闭连接，已接收的评估继续运行
+    void disconnect() {
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            if (m_sock != NetUtils::INVALID) NetUtils::shutdownSocket(m_sock);
+        }
+        if (m_reader.joinable()) m_reader.join();
+    }
+
+    void stop() {
+        disconnect();
+        std::vector<std::thread> evals;
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            evals.swap(m_evals);
+        }
+        for (auto& t : evals) t.join();
+    }
+
+    void setLatency(int latencyMs) { m_latencyMs = latencyMs; }
+
+    // 本节点收到的 EVAL 次数 (jobId -> 次数)
+    std::map<int, int> received() const {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        return m_received;
+    }
+
+    int receivedCount() const {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        int total = 0;
+        for (const auto& kv : m_received) total += kv.second;
+        return total;
+    }
+
+private:
+    bool send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        if (m_sock == NetUtils::INVALID) return false;
+        return NetUtils::sendLine(m_sock, line);
+    }
+
+    void serve(NetUtils::socket_t s) {
+        NetUtils::LineReader reader(s);
+        std::string line;
+        while (true) {
+            int r = reader.readLine(line, 200);
+            if (r < 0) break;
+            if (r == 0) {
+                send("HEARTBEAT 0");
+                continue;
+            }
+            std::istringstream ss(line);
+            std::string cmd;
+            ss >> cmd;
+            if (cmd == "EVAL") startEval(ss);
+            else if (cmd == "BYE") break;
+            // KEEP / DROP：没有输出目录需要处理
+        }
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        NetUtils::closeSocket(m_sock);
+        m_sock = NetUtils::INVALID;
+    }
+
+    // EVAL <jobId> <stentType> <timeoutMs> <nParams> <p>... <patientName>
+    void startEval(std::istringstream& ss) {
+        int jobId = -1, timeoutMs = 0;
+        size_t n = 0;
+        std::string stentType;
+        ss >> jobId >> stentType >> timeoutMs >> n;
+        std::vector<double> params(n);
+        for (auto& p : params) ss >> p;
+        if (!ss || jobId < 0) {
+            std::cerr << "[" << m_name << "] Malformed EVAL request: " << ss.str() << std::endl;
+            return;
+        }
+        int latencyMs = m_latencyMs;
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_received[jobId]++;
+        m_evals.emplace_back([this, jobId, params, latencyMs]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+            std::ostringstream msg;
+            msg << std::setprecision(17) << "RESULT " << jobId << " " << loopbackCost(params) << " " << latencyMs << " 0 1 solve " << latencyMs;
+            send(msg.str());
+        });
+    }
+
+    std::string m_name;
+    int m_slots;
+    int m_port;
+    std::atomic<int> m_latencyMs;
+    std::thread m_reader;
+    std::mutex m_sendMutex;
+    NetUtils::socket_t m_sock = NetUtils::INVALID;
+    mutable std::mutex m_stateMutex;
+    std::map<int, int> m_received;
+    std::vector<std::thread> m_evals;
+};
+
+struct Submitted {
+    std::vector<double> params;
+    RemoteEvaluation remote;
+};
+
+// 在独立线程中提交一次评估
+static std::thread submit(DistributedCoordinator& coordinator, Submitted& job) {
+    return std::thread([&coordinator, &job]() {
+        job.remote = coordinator.evaluate("loopback", "A", job.params, 60000);
+        coordinator.release(job.remote.jobId, false, job.remote.result.cost);
+    });
+}
+
+static bool waitUntil(const std::function<bool()>& condition, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+static double phaseMs(const WorkerResult& result, const std::string& name) {
+    for (const auto& phase : result.phases) if (phase.first == name) return phase.second;
+    return -1.0;
+}
+
+class Checker {
+public:
+    explicit Checker(const std::string& scenario) : m_scenario(scenario) {}
+
+    void expect(bool ok, const std::string& what) {
+        if (ok) return;
+        m_failures++;
+        std::cerr << "  [FAIL] " << m_scenario << ": " << what << std::endl;
+    }
+
+    bool report() const {
+        std::cout << (m_failures == 0 ? "[PASS] " : "[FAIL] ") << m_scenario << std::endl;
+        return m_failures == 0;
+    }
+
+private:
+    std::string m_scenario;
+    int m_failures = 0;
+};
+
+static void checkResults(Checker& check, const std::vector<Submitted>& jobs) {
+    for (const auto& job : jobs) {
+        std::string id = "job " + std::to_string(job.remote.jobId);
+        check.expect(!job.remote.result.timedOut, id + " failed");
+        check.expect(std::abs(job.remote.result.cost - loopbackCost(job.params)) < 1e-12, id + " returned a wrong cost");
+        check.expect(!job.remote.agentName.empty(), id + " has no agent");
+    }
+}
+
+// ==========================================
+// 场景
+// ==========================================
+static bool runMultiAgent(int agents, int slots, int jobCount, int latencyMs) {
+    Checker check("multi_agent");
+    DistributedCoordinator coordinator;
+    int port = coordinator.start(0);
+    if (port < 0) return false;
+
+    std::vector<std::unique_ptr<LoopbackAgent>> nodes;
+    for (int a = 0; a < agents; ++a) {
+        nodes.emplace_back(new LoopbackAgent("node" + std::to_string(a), slots, port, latencyMs));
+        check.expect(nodes.back()->connect(), "node" + std::to_string(a) + " cannot connect");
+    }
+    check.expect(coordinator.waitForAgents(agents, 5000), "agents did not register");
+
+    std::vector<Submitted> jobs(jobCount);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < jobCount; ++i) {
+        jobs[i].params = { 0.01 * i, 1.0 - 0.02 * i };
+        clients.push_back(submit(coordinator, jobs[i]));
+    }
+    for (auto& t : clients) t.join();
+    checkResults(check, jobs);
+
+    std::map<int, int> evals;
+    for (auto& node : nodes) {
+        for (const auto& kv : node->received()) evals[kv.first] += kv.second;
+    }
+    for (const auto& job : jobs) {
+        check.expect(evals[job.remote.jobId] == 1, "job " + std::to_string(job.remote.jobId) + " simulated "
+            + std::to_string(evals[job.remote.jobId]) + " times");
+    }
+
+    coordinator.stop();
+    for (auto& node : nodes) node->stop();
+    return check.report();
+}
+
+static bool runReconnect(int orphanMs) {
+    Checker check("reconnect");
+    DistributedCoordinator coordinator;
+    int port = coordinator.start(0);
+    if (port < 0) return false;
+
+    LoopbackAgent node("node", 3, port, orphanMs);
+    check.expect(node.connect(), "node cannot connect");
+    check.expect(coordinator.waitForAgents(1, 5000), "agent did not register");
+
+    // 两个长任务派发后断线，随即重连
+    std::vector<Submitted> jobs(3);
+    jobs[0].params = { 0.5, 0.25 };
+    jobs[1].params = { -1.0, 2.0 };
+    jobs[2].params = { 3.0, 0.125 };
+    std::vector<std::thread> clients;
+    clients.push_back(submit(coordinator, jobs[0]));
+    clients.push_back(submit(coordinator, jobs[1]));
+    check.expect(waitUntil([&] { return node.receivedCount() == 2; }, 5000), "initial jobs were not dispatched");
+
+    node.disconnect();
+    check.expect(waitUntil([&] { return coordinator.agentCount() == 0; }, 5000), "lost connection was not detected");
+    node.setLatency(10);
+    check.expect(node.connect(), "node cannot reconnect");
+    check.expect(coordinator.waitForAgents(1, 5000), "agent did not re-register");
+
+    // 重新排队的两个遗留任务在队首，第三个槽位空闲：新任务应立即派发
+    clients.push_back(submit(coordinator, jobs[2]));
+    for (auto& t : clients) t.join();
+    checkResults(check, jobs);
+
+    auto evals = node.received();
+    for (const auto& job : jobs) {
+        check.expect(evals[job.remote.jobId] == 1, "job " + std::to_string(job.remote.jobId) + " simulated "
+            + std::to_string(evals[job.remote.jobId]) + " times");
+    }
+    double waitMs = phaseMs(jobs[2].remote.result, "slot_wait");
+    check.expect(waitMs >= 0.0 && waitMs < orphanMs / 2, "new job waited " + std::to_string(waitMs)
+        + " ms behind the orphaned jobs");
+
+    coordinator.stop();
+    node.stop();
+    return check.report();
+}
+
+static bool runAgentLost(int slots, int latencyMs) {
+    Checker check("agent_lost");
+    DistributedCoordinator coordinator;
+    int port = coordinator.start(0);
+    if (port < 0) return false;
+
+    LoopbackAgent leaving("leaving", slots, port, 10 * latencyMs);
+    check.expect(leaving.connect(), "leaving node cannot connect");
+    check.expect(coordinator.waitForAgents(1, 5000), "agent did not register");
+
+    std::vector<Submitted> jobs(2 * slots);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < (int)jobs.size(); ++i) {
+        jobs[i].params = { 0.1 * i, 0.2 };
+        clients.push_back(submit(coordinator, jobs[i]));
+    }
+    check.expect(waitUntil([&] { return leaving.receivedCount() == slots; }, 5000), "jobs were not dispatched");
+
+    LoopbackAgent staying("staying", slots, port, latencyMs);
+    check.expect(staying.connect(), "staying node cannot connect");
+    check.expect(coordinator.waitForAgents(2, 5000), "second agent did not register");
+    leaving.stop();
+
+    for (auto& t : clients) t.join();
+    checkResults(check, jobs);
+    check.expect(staying.receivedCount() == (int)jobs.size(), "surviving agent ran " + std::to_string(staying.receivedCount())
+        + " of " + std::to_string(jobs.size()) + " jobs");
+
+    coordinator.stop();
+    staying.stop();
+    return check.report();
+}
+
+int main(int argc, char* argv[]) {
+    int agents = 3, slots = 2, jobs = 60, latencyMs = 20, orphanMs = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (arg == "--agents") agents = std::stoi(next());
+        else if (arg == "--slots") slots = std::stoi(next());
+        else if (arg == "--jobs") jobs = std::stoi(next());
+        else if (arg == "--latency-ms") latencyMs = std::stoi(next());
+        else if (arg == "--orphan-ms") orphanMs = std::stoi(next());
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    bool ok = true;
+    ok = runMultiAgent(agents, slots, jobs, latencyMs) && ok;
+    ok = runReconnect(orphanMs) && ok;
+    ok = runAgentLost(slots, latencyMs) && ok;
+    std::cout << (ok ? "All loopback scenarios passed." : "Loopback scenarios FAILED.") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+// Benchmark/KernelBench.cpp
+// GeometryUtils / MaterialMapper 内核基准测试 (无 GPU、无病人数据)
+// 另含优化器侧的 TrustRegionBO：累计约 3000 个观测后单次 ask/tell 的耗时，
+// 以及 ProfileKernel 与旧 Kochanek 样条轮廓拟合 (本地复刻) 的耗时与数值差异
+//
+// 用法: KernelBench [--sizes small,medium,large] [--threads 1,2,4] [--reps 5]
+//                   [--out kernel_bench.json] [--label <commit>]
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+#include <random>
+#include <cmath>
+#include <omp.h>
+#include <vtkSMPTools.h>
+#include "SyntheticMesh.h"
+#include "../SimWork/Core/GeometryUtils.h"
+#include "../SimWork/Core/MaterialMapper.h"
+#include "../SimWork/Core/SimulationRunner.h"
+#include "../SimWork/Core/ProfileKernel.h"
+#include "solver/TetModel.h"
+#include "../Optimize/Utils/TrustRegionBO.h"
+
+namespace fs = std::filesystem;
+
+struct BenchResult {
+    std::string kernel;
+    std::string size;
+    int threads;
+    long long elements;   // 输入规模 (点数或单元数)
+    std::vector<double> samplesMs;
+};
+
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+// 先预热一次，再计时 reps 次
+static std::vector<double> measure(int reps, const std::function<void()>& fn) {
+    fn();
+    std::vector<double> samples;
+    for (int i = 0; i < reps; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return samples;
+}
+
+static void writeJson(std::ostream& out, const std::string& label, const std::vector<BenchResult>& results) {
+    out << "{\n  \"label\": \"" << label << "\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::vector<double> sorted = r.samplesMs;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+        out << "    {\"kernel\": \"" << r.kernel << "\", \"size\": \"" << r.size
+            << "\", \"threads\": " << r.threads << ", \"elements\": " << r.elements
+            << ", \"reps\": " << sorted.size()
+            << ", \"min_ms\": " << sorted.front()
+            << ", \"median_ms\": " << sorted[sorted.size() / 2]
+            << ", \"mean_ms\": " << mean << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// ==========================================
+// 旧轮廓拟合的本地复刻 (与 ProfileKernel 对照)
+// ==========================================
+// 原 computeSliceAndFit：36 桶平均半径 -> 空桶按顺序填补 -> [0.25, 0.5, 0.25] 周期平滑 ->
+// 闭合 vtkKochanekSpline (张力 0.5) 在 t = i / 10 (i = 0..359) 处重采样 -> 多边形面积与周长。
+// 结点等距时张力 0.5、偏置/连续性为 0 的 Kochanek 样条即切线为 0.25 (p[i+1] - p[i-1]) 的三次 Hermite 样条
+static bool kochanekReplicaFit(const double* x, const double* y, size_t n, std::vector<double>& radii,
+    double& area, double& circumference)
+{
+    const int NUM_BINS = 36;
+    const double twoPi = 2.0 * 3.14159265358979323846;
+    if (n < 10) return false;
+
+    double sumR[NUM_BINS] = {};
+    int count[NUM_BINS] = {};
+    for (size_t i = 0; i < n; ++i) {
+        double theta = std::atan2(y[i], x[i]);
+        if (theta < 0) theta += twoPi;
+        int idx = std::clamp((int)(theta / twoPi * NUM_BINS), 0, NUM_BINS - 1);
+        sumR[idx] += std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        count[idx]++;
+    }
+    for (int i = 0; i < NUM_BINS; ++i) {
+        if (count[i] > 0) continue;
+        int left = (i - 1 + NUM_BINS) % NUM_BINS;
+        while (count[left] == 0 && left != i) left = (left - 1 + NUM_BINS) % NUM_BINS;
+        int right = (i + 1) % NUM_BINS;
+        while (count[right] == 0 && right != i) right = (right + 1) % NUM_BINS;
+        if (count[left] == 0 || count[right] == 0) return false;
+        sumR[i] = 0.5 * (sumR[left] / count[left] + sumR[right] / count[right]);
+        count[i] = 1;
+    }
+    double knots[NUM_BINS];
+    for (int i = 0; i < NUM_BINS; ++i) {
+        int prev = (i - 1 + NUM_BINS) % NUM_BINS;
+        int next = (i + 1) % NUM_BINS;
+        knots[i] = 0.25 * sumR[prev] / count[prev] + 0.5 * sumR[i] / count[i] + 0.25 * sumR[next] / count[next];
+    }
+    auto knot = [&](int k) { return knots[((k % NUM_BINS) + NUM_BINS) % NUM_BINS]; };
+
+    radii.resize(360);
+    for (int i = 0; i < 360; ++i) {
+        double t = i / 10.0;
+        int k = (int)t;
+        double s = t - k, s2 = s * s, s3 = s2 * s;
+        double m0 = 0.25 * (knot(k + 1) - knot(k - 1));
+        double m1 = 0.25 * (knot(k + 2) - knot(k));
+        radii[i] = (2 * s3 - 3 * s2 + 1) * knot(k) + (s3 - 2 * s2 + s) * m0 + (-2 * s3 + 3 * s2) * knot(k + 1) + (s3 - s2) * m1;
+    }
+    area = circumference = 0.0;
+    for (int i = 0; i < 360; ++i) {
+        int j = (i + 1) % 360;
+        double ti = i * twoPi / 360.0, tj = j * twoPi / 360.0;
+        double xi = radii[i] * std::cos(ti), yi = radii[i] * std::sin(ti);
+        double xj = radii[j] * std::cos(tj), yj = radii[j] * std::sin(tj);
+        area += 0.5 * std::abs(xi * yj - yi * xj);
+        circumference += std::hypot(xj - xi, yj - yi);
+    }
+    return true;
+}
+
+// 类似支架截面的合成轮廓：半径 11-14 mm，轻微椭圆，加上支架波峰形成的周期性起伏与测量噪声；
+// 点坐标相对质心 (与 GeometryUtils 传给 ProfileKernel 的输入相同)
+static void makeStrutProfiles(int count, unsigned int seed, ProfileKernel::Batch& batch) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    const double twoPi = 2.0 * 3.14159265358979323846;
+    batch.clear();
+    for (int p = 0; p < count; ++p) {
+        double radius = 11.0 + 3.0 * uniform(rng);
+        double ellipticity = 0.08 * uniform(rng);
+        double tilt = twoPi * uniform(rng);
+        int crowns = 9 + (int)(7 * uniform(rng));
+        double crownDepth = 0.15 + 0.25 * uniform(rng);
+        int points = 400 + (int)(400 * uniform(rng));
+        std::vector<double> px(points), py(points);
+        double cx = 0.0, cy = 0.0;
+        for (int i = 0; i < points; ++i) {
+            double theta = twoPi * uniform(rng);
+            double r = radius * (1.0 + ellipticity * std::cos(2.0 * (theta - tilt)))
+                - crownDepth * std::abs(std::sin(0.5 * crowns * theta)) + noise(rng);
+            px[i] = r * std::cos(theta);
+            py[i] = r * std::sin(theta);
+            cx += px[i];
+            cy += py[i];
+        }
+        cx /= points;
+        cy /= points;
+        for (int i = 0; i < points; ++i) batch.push(px[i] - cx, py[i] - cy);
+        batch.close();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> sizeNames = { "small", "medium", "large" };
+    std::vector<int> threadCounts = { 1, 2, 4 };
+    int reps = 5;
+    std::string outPath = "kernel_bench.json";
+    std::string label = "local";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i], val = argv[i + 1];
+        if (key == "--sizes") sizeNames = splitList(val);
+        else if (key == "--threads") { threadCounts.clear(); for (auto& t : splitList(val)) threadCounts.push_back(std::stoi(t)); }
+        else if (key == "--reps") reps = std::max(1, std::stoi(val));
+        else if (key == "--out") outPath = val;
+        else if (key == "--label") label = val;
+    }
+
+    fs::path workDir = fs::temp_directory_path() / "simwork_kernel_bench";
+    fs::create_directories(workDir);
+
+    // 解剖区域 (闭合圆柱带)，与 SimWorker 中的区域/优先级一致
+    std::string annulusStl = (workDir / "AorticAnnulus.stl").string();
+    std::string curtainStl = (workDir / "AortomitralCurtain.stl").string();
+    std::string ventricleStl = (workDir / "LeftVentricular.stl").string();
+
+    std::vector<BenchResult> results;
+    const double noShift[3] = { 0.0, 0.0, 0.0 };
+    const double targetShift[3] = { 0.8, -0.5, 0.3 };
+    const std::vector<double> sliceHeights = { -4.5, 16.9, 35.9 };
+
+    std::map<std::string, double> params = {
+        { "AorticAnnulus_E", 2.0e6 }, { "AortomitralCurtain_E", 0.5e5 }, { "LeftVentricular_E", 8.0e6 },
+    };
+
+    for (const auto& size : SyntheticMesh::standardSizes()) {
+        if (std::find(sizeNames.begin(), sizeNames.end(), size.name) == sizeNames.end()) continue;
+
+        // ---- 准备输入 (不计时) ----
+        auto simPoly = SyntheticMesh::makeStentLattice(size, 12.5, 0.0, noShift);
+        auto targetPoly = SyntheticMesh::makeStentLattice(size, 12.0, 0.06, targetShift);
+        long long stentPoints = simPoly->GetNumberOfPoints();
+
+        std::string inpPath = (workDir / ("vessel_" + size.name + ".inp")).string();
+        auto vesselSize = SyntheticMesh::writeTetVesselInp(inpPath, size, 13.0, 2.0, -10.0, 40.0);
+        SyntheticMesh::writeRegionCylinderSTL(annulusStl, 16.0, -2.0, 6.0, size.vesselTheta);
+        SyntheticMesh::writeRegionCylinderSTL(curtainStl, 16.0, 6.0, 12.0, size.vesselTheta);
+        SyntheticMesh::writeRegionCylinderSTL(ventricleStl, 16.0, -12.0, -2.0, size.vesselTheta);
+
+        std::cout << "[Bench] size=" << size.name << " stentPoints=" << stentPoints
+            << " vesselNodes=" << vesselSize.first << " vesselTets=" << vesselSize.second << std::endl;
+
+        Simulation::TetModel vessel(inpPath, inpPath, "vessel");
+
+        SimulationConfig config;
+        config.outputRoot = workDir.string() + "/";
+        SimulationRunner runner(config);
+
+        for (int threads : threadCounts) {
+            vtkSMPTools::Initialize(threads);
+            omp_set_num_threads(threads);
+            auto add = [&](const std::string& kernel, long long elements, const std::function<void()>& fn) {
+                results.push_back({ kernel, size.name, threads, elements, measure(reps, fn) });
+                std::cout << "  " << kernel << " threads=" << threads << " median="
+                    << results.back().samplesMs[results.back().samplesMs.size() / 2] << " ms" << std::endl;
+            };
+
+            add("alignToCentroid", stentPoints, [&]() {
+                GeometryUtils::alignToCentroid(targetPoly, simPoly);
+            });
+
+            vtkSmartPointer<vtkPolyData> aligned;
+            add("alignToICP", stentPoints, [&]() {
+                aligned = GeometryUtils::alignToICP(targetPoly, simPoly);
+            });
+
+            add("computeErrors", stentPoints, [&]() {
+                GeometryUtils::computeErrors(aligned, simPoly);
+            });
+
+            // 与一次评估相同：仿真与真值各 3 个截面
+            add("computeSliceAndFit_x6", stentPoints, [&]() {
+                for (double h : sliceHeights) {
+                    GeometryUtils::ProfileData simProfile, targetProfile;
+                    GeometryUtils::computeSliceAndFit(simPoly, Eigen::Vector3d(0, h, 0), Eigen::Vector3d(0, 1, 0), simProfile);
+                    GeometryUtils::computeSliceAndFit(aligned, Eigen::Vector3d(0, h, 0), Eigen::Vector3d(0, 1, 0), targetProfile);
+                }
+            });
+
+            // LossFunction 的实际调用方式：每个模型一次切割所有高度，批量拟合
+            add("computeSlicesAndFit_batch_x6", stentPoints, [&]() {
+                std::vector<Eigen::Vector3d> origins;
+                for (double h : sliceHeights) origins.push_back(Eigen::Vector3d(0, h, 0));
+                std::vector<GeometryUtils::ProfileData> simProfiles, targetProfiles;
+                GeometryUtils::computeSlicesAndFit(simPoly, origins, Eigen::Vector3d(0, 1, 0), simProfiles);
+                GeometryUtils::computeSlicesAndFit(aligned, origins, Eigen::Vector3d(0, 1, 0), targetProfiles);
+            });
+
+            auto mapper = std::make_shared<MaterialMapper>();
+            add("MaterialMapper::initialize", vesselSize.second, [&]() {
+                mapper = std::make_shared<MaterialMapper>();
+                mapper->addRegion("AorticAnnulus", annulusStl, 10);
+                mapper->addRegion("AortomitralCurtain", curtainStl, 5);
+                mapper->addRegion("LeftVentricular", ventricleStl, 1);
+                mapper->initialize();
+            });
+
+            add("MaterialMapper::applyMaterials", vesselSize.second, [&]() {
+                mapper->applyMaterials(&vessel, params, 2.5);
+            });
+
+            std::string tecplotPath = (workDir / ("modulus_" + size.name + ".dat")).string();
+            add("exportElasticModulusToTecplot", vesselSize.second, [&]() {
+                runner.exportElasticModulusToTecplot(&vessel, tecplotPath, "Bench_ElasticModulus");
+            });
+        }
+    }
+
+    // ---- TrustRegionBO：观测数累计到 boObservations 后单次 ask(1) + tell 的耗时 ----
+    // 预填充按 8 个一批走正常的 ask/tell 流程 (不计时)，计时期间观测数继续增长
+    const int boDim = 5;
+    const int boObservations = 3000;
+    auto boObjective = [](const std::vector<double>& x) {
+        double sum = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            double d = x[i] - 0.3 - 0.05 * i;
+            sum += d * d;
+        }
+        return sum;
+    };
+    for (int threads : threadCounts) {
+        TrustRegionBO::Options boOptions;
+        boOptions.threads = threads;
+        TrustRegionBO bo(boDim, boOptions);
+        while (bo.observations() < boObservations) {
+            auto points = bo.ask(8);
+            std::vector<double> costs;
+            for (const auto& p : points) costs.push_back(boObjective(p));
+            bo.tell(points, costs);
+        }
+        auto samples = measure(reps, [&]() {
+            auto points = bo.ask(1);
+            bo.tell(points, { boObjective(points[0]) });
+        });
+        results.push_back({ "TrustRegionBO::ask_tell", "n" + std::to_string(boObservations), threads, bo.observations(), samples });
+        std::cout << "  TrustRegionBO::ask_tell threads=" << threads << " observations=" << bo.observations()
+            << " localPoints=" << bo.localPoints() << " median=" << samples[samples.size() / 2] << " ms" << std::endl;
+    }
+
+    // ---- ProfileKernel 与旧 Kochanek 样条拟合：耗时与数值差异 (单线程) ----
+    const int profileCount = 200;
+    ProfileKernel::Batch profileBatch;
+    makeStrutProfiles(profileCount, 2024, profileBatch);
+    ProfileKernel::Result kernelResult;
+    auto kernelSamples = measure(reps, [&]() {
+        ProfileKernel::fit(profileBatch, kernelResult);
+    });
+    results.push_back({ "ProfileKernel::fit", "profiles" + std::to_string(profileCount), 1, profileCount, kernelSamples });
+
+    std::vector<std::vector<double>> replicaRadii(profileCount);
+    std::vector<double> replicaArea(profileCount), replicaCircumference(profileCount);
+    std::vector<unsigned char> replicaValid(profileCount);
+    auto replicaSamples = measure(reps, [&]() {
+        for (int p = 0; p < profileCount; ++p) {
+            size_t begin = profileBatch.offsets[p], n = profileBatch.offsets[p + 1] - begin;
+            replicaValid[p] = kochanekReplicaFit(&profileBatch.x[begin], &profileBatch.y[begin], n,
+                replicaRadii[p], replicaArea[p], replicaCircumference[p]);
+        }
+    });
+    results.push_back({ "KochanekReplica::fit", "profiles" + std::to_string(profileCount), 1, profileCount, replicaSamples });
+
+    double rmsSum = 0.0, rmsMax = 0.0, areaMax = 0.0, circumferenceMax = 0.0;
+    int compared = 0;
+    for (int p = 0; p < profileCount; ++p) {
+        if (!replicaValid[p] || !kernelResult.valid[p]) continue;
+        double sq = 0.0;
+        for (int i = 0; i < ProfileKernel::kSamples; ++i) {
+            double d = kernelResult.radii[p * ProfileKernel::kSamples + i] - replicaRadii[p][i];
+            sq += d * d;
+        }
+        double rms = std::sqrt(sq / ProfileKernel::kSamples);
+        rmsSum += rms;
+        rmsMax = std::max(rmsMax, rms);
+        areaMax = std::max(areaMax, std::abs(kernelResult.area[p] - replicaArea[p]) / replicaArea[p]);
+        circumferenceMax = std::max(circumferenceMax,
+            std::abs(kernelResult.circumference[p] - replicaCircumference[p]) / replicaCircumference[p]);
+        compared++;
+    }
+    std::cout << "[Bench] ProfileKernel vs Kochanek replica (" << compared << " profiles): median "
+        << kernelSamples[kernelSamples.size() / 2] << " ms vs " << replicaSamples[replicaSamples.size() / 2] << " ms" << std::endl;
+    std::cout << "  radius RMS diff mean=" << (compared ? rmsSum / compared : 0.0) << " mm max=" << rmsMax
+        << " mm, area rel diff max=" << areaMax << ", circumference rel diff max=" << circumferenceMax << std::endl;
+
+    std::ofstream out(outPath);
+    writeJson(out, label, results);
+    std::cout << "[Bench] Results written to " << outPath << std::endl;
+    return 0;
+}
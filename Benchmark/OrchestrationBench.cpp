@@ -0,0 +1,181 @@
+// Benchmark/OrchestrationBench.cpp
+// 端到端编排吞吐基准：用 MockWorker 替代 SimWorker，测量
+// 评估吞吐 (evals/s)、调度延迟 (槽位等待 + 进程开销) 以及各优化模式达到目标值的时间。
+//
+// 用法: OrchestrationBench --mock <MockWorker 路径>
+//         [--modes cmaes,bayesopt,turbo] [--concurrency 1,2,4,8] [--generations 20]
+//         [--cost rosenbrock] [--latency-ms 100] [--fail-rate 0.05] [--timeout-rate 0.0]
+//         [--timeout-ms 5000] [--target 1.0] [--out orchestration_bench.json] [--label <commit>]
+//         [--restart none|ipop|bipop] [--populations 1]
+//         [--layouts compact,numa_spread,unpinned] [--threads 0,2,4]
+//
+// --layouts 与 --threads 比较 CPU 布局策略 ("多而瘦" 与 "少而胖" 的 Worker)：每种组合分别运行，
+// threads 为 0 时按 物理核数 / 并发数 均分。MockWorker 的代价不占 CPU，需用真实 SimWorker 才能反映差异
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cstdlib>
+#include "../Optimize/Utils/OptimizerModes.h"
+
+namespace fs = std::filesystem;
+
+struct RunRecord {
+    std::string mode;
+    int concurrency;
+    std::string layout;
+    int threads;             // 每个 Worker 的线程预算 (实际生效值)
+    OptimizationSummary summary;
+    double timeToTarget; // 秒，未达到为 -1
+};
+
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+static void setEnv(const std::string& key, const std::string& value) {
+#ifdef _WIN32
+    _putenv_s(key.c_str(), value.c_str());
+#else
+    setenv(key.c_str(), value.c_str(), 1);
+#endif
+}
+
+static double phaseP(const OptimizationSummary& s, const std::string& phase, bool p95) {
+    auto it = s.phasePercentiles.find(phase);
+    if (it == s.phasePercentiles.end()) return 0.0;
+    return p95 ? it->second.second : it->second.first;
+}
+
+int main(int argc, char* argv[]) {
+    std::string mockExe;
+    std::vector<std::string> modes = { "cmaes", "bayesopt" };
+    std::vector<int> concurrencies = { 1, 2, 4, 8 };
+    int generations = 20;
+    double target = 1.0;
+    int timeoutMs = 5000;
+    std::string outPath = "orchestration_bench.json";
+    std::string label = "local";
+    RestartStrategy restart = RestartStrategy::None;
+    int populations = 1;
+    std::vector<WorkerLayout> layouts = { WorkerLayout::Compact };
+    std::vector<int> threadOptions = { 0 };
+
+    // MockWorker 的默认行为
+    setEnv("MOCK_COST", "rosenbrock");
+    setEnv("MOCK_LATENCY_MS", "100");
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i], val = argv[i + 1];
+        if (key == "--mock") mockExe = val;
+        else if (key == "--modes") modes = splitList(val);
+        else if (key == "--concurrency") { concurrencies.clear(); for (auto& c : splitList(val)) concurrencies.push_back(std::stoi(c)); }
+        else if (key == "--generations") generations = std::stoi(val);
+        else if (key == "--target") target = std::stod(val);
+        else if (key == "--timeout-ms") timeoutMs = std::stoi(val);
+        else if (key == "--out") outPath = val;
+        else if (key == "--label") label = val;
+        else if (key == "--restart") restart = val == "ipop" ? RestartStrategy::IPOP : (val == "bipop" ? RestartStrategy::BIPOP : RestartStrategy::None);
+        else if (key == "--populations") populations = std::stoi(val);
+        else if (key == "--layouts") {
+            layouts.clear();
+            for (auto& name : splitList(val)) {
+                WorkerLayout layout;
+                if (CpuTopology::parseLayout(name, layout)) layouts.push_back(layout);
+                else std::cerr << "[Bench] Unknown layout '" << name << "' ignored." << std::endl;
+            }
+        }
+        else if (key == "--threads") { threadOptions.clear(); for (auto& t : splitList(val)) threadOptions.push_back(std::stoi(t)); }
+        else if (key == "--cost") setEnv("MOCK_COST", val);
+        else if (key == "--latency-ms") setEnv("MOCK_LATENCY_MS", val);
+        else if (key == "--fail-rate") setEnv("MOCK_FAIL_RATE", val);
+        else if (key == "--timeout-rate") setEnv("MOCK_TIMEOUT_RATE", val);
+    }
+    if (mockExe.empty() || !fs::exists(mockExe)) {
+        std::cerr << "[Bench] --mock <MockWorker executable> is required." << std::endl;
+        return -1;
+    }
+
+    fs::path workDir = fs::temp_directory_path() / "orchestration_bench";
+    std::vector<ParameterSpec> specs = defaultParameterSpecs();
+
+    std::vector<RunRecord> records;
+    CpuTopology topology = CpuTopology::detect();
+    std::cout << "[Bench] CPU: " << topology.describe() << std::endl;
+
+    // 模式 x 并发数 x 布局 x 线程预算 的全部组合
+    struct RunConfig { std::string mode; int concurrency; WorkerLayout layout; int threads; };
+    std::vector<RunConfig> configs;
+    for (const auto& mode : modes)
+        for (int concurrency : concurrencies)
+            for (WorkerLayout layout : layouts)
+                for (int threads : threadOptions) configs.push_back({ mode, concurrency, layout, threads });
+
+    for (const auto& config : configs) {
+        const std::string& mode = config.mode;
+        const int concurrency = config.concurrency;
+        const WorkerLayout layout = config.layout;
+        const int threads = config.threads;
+        // 每次运行使用全新的病人目录，避免日志/输出相互影响
+        std::string runName = mode + "_c" + std::to_string(concurrency) + "_" + CpuTopology::layoutName(layout)
+            + "_t" + std::to_string(threads);
+        fs::path patientRoot = workDir / runName;
+        fs::remove_all(patientRoot);
+        fs::create_directories(patientRoot / "mesh");
+        fs::create_directories(patientRoot / "output");
+
+        PatientContext patient{ runName, (patientRoot / "mesh").string() + "/", (patientRoot / "output").string() + "/", "VenusA_L26" };
+        OptimizerSettings settings;
+        settings.workerExe = mockExe;
+        settings.timeoutMs = timeoutMs;
+        settings.maxGenerations = generations;
+        settings.concurrency = concurrency;
+        settings.restartStrategy = restart;
+        settings.cmaesPopulations = populations;
+        settings.cpuLayout.layout = layout;
+        settings.cpuLayout.threadsPerWorker = threads;
+        int effectiveThreads = topology.plan(concurrency, settings.cpuLayout).front().threads;
+
+        RunRecord record{ mode, concurrency, CpuTopology::layoutName(layout), effectiveThreads, OptimizationSummary(), -1.0 };
+        if (mode == "cmaes") record.summary = runCMAESOptimization(patient, specs, settings);
+        else if (mode == "bayesopt") record.summary = runBayesOptOptimization(patient, specs, settings);
+        else if (mode == "turbo") record.summary = runTrustRegionBOOptimization(patient, specs, settings);
+        else continue;
+
+        for (const auto& point : record.summary.bestTrace) {
+            if (point.second <= target) { record.timeToTarget = point.first; break; }
+        }
+        records.push_back(record);
+    }
+
+    std::ofstream out(outPath);
+    out << "{\n  \"label\": \"" << label << "\",\n  \"target\": " << target
+        << ",\n  \"restart\": \"" << RestartScheduler::name(restart) << "\",\n  \"populations\": " << populations << ",\n  \"runs\": [\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& r = records[i];
+        const auto& s = r.summary;
+        out << "    {\"mode\": \"" << r.mode << "\", \"concurrency\": " << r.concurrency
+            << ", \"layout\": \"" << r.layout << "\", \"threads_per_worker\": " << r.threads
+            << ", \"evaluations\": " << s.evaluations
+            << ", \"wall_s\": " << s.wallSeconds
+            << ", \"evals_per_sec\": " << (s.wallSeconds > 0 ? s.evaluations / s.wallSeconds : 0.0)
+            << ", \"slot_wait_p50_ms\": " << phaseP(s, "slot_wait", false)
+            << ", \"slot_wait_p95_ms\": " << phaseP(s, "slot_wait", true)
+            << ", \"process_overhead_p50_ms\": " << phaseP(s, "process_overhead", false)
+            << ", \"process_overhead_p95_ms\": " << phaseP(s, "process_overhead", true)
+            << ", \"best_cost\": " << s.bestCost
+            << ", \"time_to_target_s\": " << r.timeToTarget
+            << ", \"stop_reason\": \"" << s.stopReason << "\"}"
+            << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    std::cout << "[Bench] Results written to " << outPath << std::endl;
+    return 0;
+}
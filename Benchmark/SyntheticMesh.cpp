@@ -0,0 +1,168 @@
+// Benchmark/SyntheticMesh.cpp
+
+#include "SyntheticMesh.h"
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkTriangle.h>
+#include <vtkCylinderSource.h>
+#include <vtkTriangleFilter.h>
+#include <vtkSTLWriter.h>
+#include <Eigen/Dense>
+#include <cstdio>
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+namespace SyntheticMesh {
+
+    static const double PI = 3.14159265358979323846;
+
+    std::vector<SizeSpec> standardSizes() {
+        return {
+            // name      cells rings seg   theta axial radial
+            { "small",     12,   6,   4,    48,   40,   2 },
+            { "medium",    18,   9,  10,    96,   80,   3 },
+            { "large",     24,  12,  24,   160,  140,   4 },
+        };
+    }
+
+    vtkSmartPointer<vtkPolyData> makeStentLattice(const SizeSpec& size,
+        double radius, double ovality, const double shift[3]) {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        auto triangles = vtkSmartPointer<vtkCellArray>::New();
+
+        // 轴向覆盖所有标准切片高度 (约 -8mm ~ 38mm)
+        const double yMin = -8.0, yMax = 38.0;
+        const double ringHeight = (yMax - yMin) / size.stentRings;
+        const double strutWidth = 0.4; // 支杆径向厚度 (mm)
+        const int apexCount = 2 * size.stentCells;
+
+        auto surfacePoint = [&](double theta, double y, double dr) {
+            double r = radius * (1.0 + ovality * std::cos(2.0 * theta)) + dr;
+            return Eigen::Vector3d(r * std::cos(theta) + shift[0], y + shift[1], r * std::sin(theta) + shift[2]);
+        };
+
+        for (int ring = 0; ring < size.stentRings; ++ring) {
+            double yLow = yMin + ring * ringHeight;
+            double yHigh = yLow + ringHeight;
+            for (int a = 0; a < apexCount; ++a) {
+                // 锯齿形支杆：相邻顶点交替位于环的上下沿
+                double theta0 = 2.0 * PI * a / apexCount;
+                double theta1 = 2.0 * PI * (a + 1) / apexCount;
+                double y0 = (a % 2 == 0) ? yLow : yHigh;
+                double y1 = (a % 2 == 0) ? yHigh : yLow;
+
+                // 径向带状支杆：每个采样点生成内外两个顶点
+                vtkIdType base = points->GetNumberOfPoints();
+                for (int s = 0; s <= size.strutSegments; ++s) {
+                    double t = (double)s / size.strutSegments;
+                    double theta = theta0 + t * (theta1 - theta0);
+                    double y = y0 + t * (y1 - y0);
+                    Eigen::Vector3d inner = surfacePoint(theta, y, -0.5 * strutWidth);
+                    Eigen::Vector3d outer = surfacePoint(theta, y, 0.5 * strutWidth);
+                    points->InsertNextPoint(inner.x(), inner.y(), inner.z());
+                    points->InsertNextPoint(outer.x(), outer.y(), outer.z());
+                }
+                for (int s = 0; s < size.strutSegments; ++s) {
+                    vtkIdType i0 = base + 2 * s, o0 = i0 + 1, i1 = i0 + 2, o1 = i0 + 3;
+                    vtkIdType tri0[3] = { i0, o0, o1 };
+                    vtkIdType tri1[3] = { i0, o1, i1 };
+                    triangles->InsertNextCell(3, tri0);
+                    triangles->InsertNextCell(3, tri1);
+                }
+            }
+        }
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+        poly->SetPolys(triangles);
+        return poly;
+    }
+
+    std::pair<int, int> writeTetVesselInp(const std::string& filepath, const SizeSpec& size,
+        double innerRadius, double thickness, double yMin, double yMax) {
+        std::FILE* f = std::fopen(filepath.c_str(), "w");
+        if (!f) return { 0, 0 };
+
+        const int nT = size.vesselTheta;       // 周向周期，不重复首尾节点
+        const int nY = size.vesselAxial + 1;
+        const int nR = size.vesselRadial + 1;
+        auto nodeId = [&](int it, int iy, int ir) {
+            return 1 + ((it % nT) * nY + iy) * nR + ir; // INP 为 1-based
+        };
+
+        std::vector<Eigen::Vector3d> nodes((size_t)nT * nY * nR);
+        std::fprintf(f, "*Heading\nSynthetic tetrahedral vessel\n*Part, name=AORTA\n*Node\n");
+        for (int it = 0; it < nT; ++it) {
+            double theta = 2.0 * PI * it / nT;
+            for (int iy = 0; iy < nY; ++iy) {
+                double y = yMin + (yMax - yMin) * iy / (nY - 1);
+                for (int ir = 0; ir < nR; ++ir) {
+                    double r = innerRadius + thickness * ir / (nR - 1);
+                    int id = nodeId(it, iy, ir);
+                    nodes[id - 1] = Eigen::Vector3d(r * std::cos(theta), y, r * std::sin(theta));
+                    std::fprintf(f, "%d, %.6f, %.6f, %.6f\n", id, nodes[id - 1].x(), nodes[id - 1].y(), nodes[id - 1].z());
+                }
+            }
+        }
+
+        // Kuhn 剖分：每个六面体沿 000 -> 111 的 6 条路径拆成 6 个四面体，结构化网格下相容
+        static const int perms[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+        std::fprintf(f, "*Element, type=C3D4, elset=AORTA\n");
+        int elemId = 0;
+        for (int it = 0; it < nT; ++it) {
+            for (int iy = 0; iy < nY - 1; ++iy) {
+                for (int ir = 0; ir < nR - 1; ++ir) {
+                    for (const auto& perm : perms) {
+                        std::array<int, 3> c = { 0, 0, 0 };
+                        std::array<int, 4> tet;
+                        tet[0] = nodeId(it, iy, ir);
+                        for (int k = 0; k < 3; ++k) {
+                            c[perm[k]] = 1;
+                            tet[k + 1] = nodeId(it + c[0], iy + c[1], ir + c[2]);
+                        }
+                        // 保证正体积
+                        const Eigen::Vector3d& p0 = nodes[tet[0] - 1];
+                        double vol = (nodes[tet[1] - 1] - p0).dot((nodes[tet[2] - 1] - p0).cross(nodes[tet[3] - 1] - p0));
+                        if (vol < 0) std::swap(tet[2], tet[3]);
+                        std::fprintf(f, "%d, %d, %d, %d, %d\n", ++elemId, tet[0], tet[1], tet[2], tet[3]);
+                    }
+                }
+            }
+        }
+
+        // 两端截面作为固定边界
+        std::fprintf(f, "*Nset, nset=BOUNDARY\n");
+        int perLine = 0;
+        for (int it = 0; it < nT; ++it) {
+            for (int iy : { 0, nY - 1 }) {
+                for (int ir = 0; ir < nR; ++ir) {
+                    std::fprintf(f, perLine == 15 ? "%d\n" : "%d, ", nodeId(it, iy, ir));
+                    perLine = (perLine + 1) % 16;
+                }
+            }
+        }
+        if (perLine != 0) std::fprintf(f, "\n");
+        std::fprintf(f, "*End Part\n");
+        std::fclose(f);
+        return { (int)nodes.size(), elemId };
+    }
+
+    void writeRegionCylinderSTL(const std::string& filepath, double radius, double yMin, double yMax, int resolution) {
+        auto cylinder = vtkSmartPointer<vtkCylinderSource>::New();
+        cylinder->SetCenter(0.0, 0.5 * (yMin + yMax), 0.0);
+        cylinder->SetHeight(yMax - yMin);
+        cylinder->SetRadius(radius);
+        cylinder->SetResolution(resolution);
+        cylinder->CappingOn();
+
+        auto triangulate = vtkSmartPointer<vtkTriangleFilter>::New();
+        triangulate->SetInputConnection(cylinder->GetOutputPort());
+
+        auto writer = vtkSmartPointer<vtkSTLWriter>::New();
+        writer->SetFileName(filepath.c_str());
+        writer->SetInputConnection(triangulate->GetOutputPort());
+        writer->SetFileTypeToBinary();
+        writer->Write();
+    }
+}
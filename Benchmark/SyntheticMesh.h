@@ -0,0 +1,44 @@
+// Benchmark/SyntheticMesh.h
+
+#pragma once
+#include <string>
+#include <vector>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+// 合成网格生成器：无需病人数据即可驱动几何/材料内核的基准测试
+namespace SyntheticMesh {
+
+    // 网格规模档位
+    struct SizeSpec {
+        std::string name;       // "small" / "medium" / "large" ...
+        int stentCells;         // 支架周向菱形单元数
+        int stentRings;         // 支架轴向环数
+        int strutSegments;      // 每根支杆的细分段数
+        int vesselTheta;        // 血管周向分段
+        int vesselAxial;        // 血管轴向分段
+        int vesselRadial;       // 血管壁厚方向分段
+    };
+
+    // 预设档位 (从小到大)
+    std::vector<SizeSpec> standardSizes();
+
+    /**
+     * @brief 生成支架状的菱形格栅圆柱面 (三角形带状支杆)
+     * @param ovality 截面椭圆度 (0 = 正圆)，用于生成与仿真结果略有差异的 "真值"
+     * @param shift   整体平移，用于测试对齐算法
+     */
+    vtkSmartPointer<vtkPolyData> makeStentLattice(const SizeSpec& size,
+        double radius, double ovality, const double shift[3]);
+
+    /**
+     * @brief 生成四面体化的血管壁 (空心圆柱)，写出为 Abaqus INP
+     * 单元集合名为 AORTA (供 MaterialMapper 识别)，底部节点写入 BOUNDARY 节点集
+     * @return 节点数与单元数
+     */
+    std::pair<int, int> writeTetVesselInp(const std::string& filepath, const SizeSpec& size,
+        double innerRadius, double thickness, double yMin, double yMax);
+
+    // 生成闭合的圆柱区域 STL (用作 MaterialMapper 的解剖区域)
+    void writeRegionCylinderSTL(const std::string& filepath, double radius, double yMin, double yMax, int resolution);
+}
@@ -0,0 +1,120 @@
+// MockWorker/MockWorker.cpp
+// 与 SimWorker 相同输入/输出协议的模拟 Worker：
+// 读取归一化参数，等待一段可配置的延迟后返回解析代价函数值，用于在几分钟内测试编排与优化器设置。
+//
+// 通过环境变量配置 (均为可选)：
+//   MOCK_COST          rosenbrock (默认) | rastrigin | sphere
+//   MOCK_LATENCY_MS    平均延迟 (默认 100)
+//   MOCK_JITTER        延迟的相对抖动幅度 [0,1] (默认 0.2)
+//   MOCK_FAIL_RATE     返回 1e6 (求解失败) 的概率 (默认 0)
+//   MOCK_TIMEOUT_RATE  挂起直到被 Optimizer 超时杀死的概率 (默认 0)
+//   MOCK_STALL_RATE    "求解" 到一半后停止推进 (进度不再更新) 的概率 (默认 0)，用于测试停滞检测
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+#include "../SimWork/Core/PhaseProfiler.h"
+#include "../Optimize/Utils/ProgressChannel.h"
+
+static double envDouble(const char* name, double fallback) {
+    const char* v = std::getenv(name);
+    return (v && *v) ? std::atof(v) : fallback;
+}
+
+static std::string envString(const char* name, const std::string& fallback) {
+    const char* v = std::getenv(name);
+    return (v && *v) ? std::string(v) : fallback;
+}
+
+// 归一化参数 u ∈ [0,1] 映射到各函数的常用定义域
+static double analyticCost(const std::string& name, const std::vector<double>& u) {
+    const double PI = 3.14159265358979323846;
+    double f = 0.0;
+    if (name == "rastrigin") {
+        // x ∈ [-5.12, 5.12]，最优 u = 0.5
+        f = 10.0 * u.size();
+        for (double ui : u) {
+            double x = -5.12 + 10.24 * ui;
+            f += x * x - 10.0 * std::cos(2.0 * PI * x);
+        }
+    }
+    else if (name == "sphere") {
+        // 最优 u = 0.5
+        for (double ui : u) f += (ui - 0.5) * (ui - 0.5);
+    }
+    else {
+        // rosenbrock: x ∈ [-2, 2]，最优 x = 1 (u = 0.75)
+        for (size_t i = 0; i + 1 < u.size(); ++i) {
+            double x = -2.0 + 4.0 * u[i];
+            double y = -2.0 + 4.0 * u[i + 1];
+            f += 100.0 * (y - x * x) * (y - x * x) + (1.0 - x) * (1.0 - x);
+        }
+    }
+    return f;
+}
+
+int main(int argc, char* argv[]) {
+    ScopedPhase totalPhase("worker_total");
+    if (argc < 3) return -1;
+    std::string inFile = argv[1];
+    std::string outFile = argv[2];
+    ProgressChannel progress;
+    if (argc >= 4) progress.open(argv[3], false);
+
+    std::ifstream in(inFile);
+    if (!in.is_open()) return -2;
+
+    std::string meshRoot, outputRoot, stentTypeStr;
+    std::getline(in, meshRoot);
+    std::getline(in, outputRoot);
+    std::getline(in, stentTypeStr);
+
+    int size;
+    std::vector<double> params;
+    if (in >> size) {
+        double val;
+        while (in >> val) params.push_back(val);
+    }
+
+    std::random_device rd;
+    std::mt19937_64 rng(((unsigned long long)rd() << 32) ^ (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count());
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    // 超时：挂起，由 Optimizer 负责杀死进程
+    if (uni(rng) < envDouble("MOCK_TIMEOUT_RATE", 0.0)) {
+        while (true) std::this_thread::sleep_for(std::chrono::seconds(60));
+    }
+
+    double latencyMs = envDouble("MOCK_LATENCY_MS", 100.0);
+    double jitter = envDouble("MOCK_JITTER", 0.2);
+    latencyMs *= 1.0 + jitter * (2.0 * uni(rng) - 1.0);
+    bool stall = uni(rng) < envDouble("MOCK_STALL_RATE", 0.0);
+    {
+        // 以 10 ms 为一个 "时间步" 模拟求解循环并上报进度
+        ScopedPhase phase("mock_latency");
+        const int steps = std::max(1, (int)(latencyMs / 10.0));
+        const double stepUs = std::max(0.0, latencyMs) * 1000.0 / steps;
+        for (int step = 1; step <= steps; ++step) {
+            std::this_thread::sleep_for(std::chrono::microseconds((long long)stepUs));
+            if (stall && step > steps / 2) {
+                while (true) std::this_thread::sleep_for(std::chrono::seconds(60));
+            }
+            progress.update((double)step / steps, 1.0, step);
+        }
+        progress.setState(ProgressRecord::PostProcessing);
+    }
+
+    double cost = (uni(rng) < envDouble("MOCK_FAIL_RATE", 0.0)) ? 1e6 : analyticCost(envString("MOCK_COST", "rosenbrock"), params);
+
+    totalPhase.stop();
+    std::ofstream out(outFile);
+    out << cost << "\n";
+    PhaseProfiler::instance().writeTo(out);
+    return 0;
+}
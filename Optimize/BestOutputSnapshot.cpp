@@ -0,0 +1,190 @@
+#include "BestOutputSnapshot.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <stdio.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+#endif
+// Utils/BestOutputSnapshot.cpp
+
+namespace fs = std::filesystem;
+
+BestOutputSnapshotter::BestOutputSnapshotter(const std::string& outputDir)
+    : m_outputDir(outputDir), m_bestDir(fs::path(outputDir) / "best_output")
+{
+    // 清理上次异常退出残留的临时目录
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_outputDir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind(".best_output.", 0) == 0) fs::remove_all(entry.path(), ec);
+    }
+    m_worker = std::thread(&BestOutputSnapshotter::workerLoop, this);
+}
+
+BestOutputSnapshotter::~BestOutputSnapshotter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    if (m_worker.joinable()) m_worker.join();
+}
+
+void BestOutputSnapshotter::publish(const std::string& evalDir, double cost, int evalId) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({ evalDir, cost, evalId, true });
+    }
+    m_cv.notify_one();
+}
+
+void BestOutputSnapshotter::discard(const std::string& evalDir) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({ evalDir, 0.0, 0, false });
+    }
+    m_cv.notify_one();
+}
+
+void BestOutputSnapshotter::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+}
+
+void BestOutputSnapshotter::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_jobs.empty()) break; // m_stop 且队列已清空
+
+            // 多个待发布快照只保留最优的一个，其余直接删除
+            job = m_jobs.front();
+            m_jobs.pop_front();
+            if (job.publish) {
+                for (auto& other : m_jobs) {
+                    if (!other.publish) continue;
+                    if (other.cost < job.cost) std::swap(job, other);
+                    other.publish = false;
+                }
+            }
+            m_busy = true;
+        }
+
+        std::error_code ec;
+        fs::path src(job.evalDir);
+        if (job.publish && job.cost < m_publishedCost) {
+            auto t0 = std::chrono::steady_clock::now();
+            fs::path staging = m_outputDir / (".best_output.staging." + std::to_string(job.evalId));
+            if (buildStaging(src, staging, job.cost, job.evalId) && swapIntoPlace(staging, job.evalId)) {
+                m_publishedCost = job.cost;
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                std::cout << "  >>> [Snapshot] best_output <- eval " << job.evalId << " (cost " << job.cost << ", " << ms << " ms)" << std::endl;
+            }
+            else {
+                std::cerr << "  >>> [Snapshot] Failed to publish eval " << job.evalId << std::endl;
+            }
+            fs::remove_all(staging, ec);
+        }
+        // 快照中的硬链接持有各自的 inode，删除评估目录不影响 best_output
+        fs::remove_all(src, ec);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy = false;
+        }
+        m_idleCv.notify_all();
+    }
+}
+
+// 目录布局与旧版 best_output 保持一致：evalDir/output/* 放在根部，evalDir 顶层文件 (如 elastic_modulus.dat) 一并保留
+bool BestOutputSnapshotter::buildStaging(const fs::path& src, const fs::path& staging, double cost, int evalId) {
+    std::error_code ec;
+    fs::remove_all(staging, ec);
+    if (!fs::create_directories(staging, ec)) return false;
+
+    auto mirror = [&](const fs::path& root, const fs::path& dstRoot, bool recursive) {
+        if (!fs::exists(root, ec)) return true;
+        if (recursive) {
+            for (auto it = fs::recursive_directory_iterator(root, ec); it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (ec) return false;
+                fs::path rel = fs::relative(it->path(), root, ec);
+                fs::path dst = dstRoot / rel;
+                if (it->is_directory(ec)) fs::create_directories(dst, ec);
+                else if (it->is_regular_file(ec) && !linkOrCopy(it->path(), dst)) return false;
+            }
+        }
+        else {
+            for (const auto& entry : fs::directory_iterator(root, ec)) {
+                if (entry.is_regular_file(ec) && !linkOrCopy(entry.path(), dstRoot / entry.path().filename())) return false;
+            }
+        }
+        return true;
+    };
+    if (!mirror(src / "output", staging, true)) return false;
+    if (!mirror(src, staging, false)) return false;
+
+    std::ofstream info(staging / "best_info.txt");
+    info << "eval " << evalId << "\ncost " << cost << "\n";
+    return info.good();
+}
+
+// 用临时目录替换 best_output：Linux 上用 renameat2(RENAME_EXCHANGE) 原子交换，
+// 其他平台退化为两次 rename (中间有极短的窗口 best_output 不存在)
+bool BestOutputSnapshotter::swapIntoPlace(const fs::path& staging, int evalId) {
+    std::error_code ec;
+    if (!fs::exists(m_bestDir, ec)) {
+        fs::rename(staging, m_bestDir, ec);
+        return !ec;
+    }
+#if defined(__linux__) && defined(SYS_renameat2) && defined(RENAME_EXCHANGE)
+    if (syscall(SYS_renameat2, AT_FDCWD, staging.c_str(), AT_FDCWD, m_bestDir.c_str(), RENAME_EXCHANGE) == 0) {
+        return true; // staging 现在持有旧快照，由调用方删除
+    }
+#endif
+    fs::path old = m_outputDir / (".best_output.old." + std::to_string(evalId));
+    fs::rename(m_bestDir, old, ec);
+    if (ec) return false;
+    fs::rename(staging, m_bestDir, ec);
+    if (ec) {
+        fs::rename(old, m_bestDir, ec); // 回滚
+        return false;
+    }
+    fs::remove_all(old, ec);
+    return true;
+}
+
+bool BestOutputSnapshotter::linkOrCopy(const fs::path& src, const fs::path& dst) {
+    std::error_code ec;
+    fs::create_hard_link(src, dst, ec);
+    if (!ec) return true;
+    if (reflink(src, dst)) return true;
+    fs::copy_file(src, dst, fs::copy_options::overwrite_existing, ec);
+    return !ec;
+}
+
+// 写时复制克隆 (btrfs/XFS 等支持 FICLONE 的文件系统)
+bool BestOutputSnapshotter::reflink(const fs::path& src, const fs::path& dst) {
+#if defined(__linux__) && defined(FICLONE)
+    int in = open(src.c_str(), O_RDONLY);
+    if (in < 0) return false;
+    int out = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) { close(in); return false; }
+    bool ok = ioctl(out, FICLONE, in) == 0;
+    close(in);
+    close(out);
+    if (!ok) unlink(dst.c_str());
+    return ok;
+#else
+    (void)src; (void)dst;
+    return false;
+#endif
+}
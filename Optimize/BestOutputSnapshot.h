@@ -0,0 +1,53 @@
+// Utils/BestOutputSnapshot.h
+#pragma once
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <filesystem>
+
+// best_output 快照：在后台线程中把某次评估的输出目录硬链接 (失败时 reflink/复制) 到临时目录，
+// 再原子地替换为 best_output。只会发布比当前已发布结果更优的快照，可被多个评估线程并发调用。
+// 要求：发布后源目录不再被改写 (每次评估使用独立的输出目录)。
+class BestOutputSnapshotter {
+public:
+    // outputDir: 病人输出目录 (末尾带 /)，best_output 位于其下
+    explicit BestOutputSnapshotter(const std::string& outputDir);
+    ~BestOutputSnapshotter(); // 等待所有排队任务完成
+
+    // 发布 evalDir 为新的 best_output (异步)；cost 不优于已发布结果时仅删除 evalDir
+    void publish(const std::string& evalDir, double cost, int evalId);
+
+    // 删除不再需要的评估目录 (异步)
+    void discard(const std::string& evalDir);
+
+    // 阻塞直到队列清空
+    void wait();
+
+private:
+    struct Job {
+        std::string evalDir;
+        double cost;
+        int evalId;
+        bool publish;
+    };
+
+    void workerLoop();
+    bool buildStaging(const std::filesystem::path& src, const std::filesystem::path& staging, double cost, int evalId);
+    bool swapIntoPlace(const std::filesystem::path& staging, int evalId);
+    static bool linkOrCopy(const std::filesystem::path& src, const std::filesystem::path& dst);
+    static bool reflink(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+    std::filesystem::path m_outputDir;
+    std::filesystem::path m_bestDir;
+    double m_publishedCost = 1e300;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_idleCv;
+    std::deque<Job> m_jobs;
+    bool m_busy = false;
+    bool m_stop = false;
+    std::thread m_worker;
+};
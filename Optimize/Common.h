@@ -2,8 +2,19 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 #include "Common/Common.h"
 
+// 归一化坐标 u ∈ [0,1] 与物理量之间的映射 (优化器、日志显示与 Worker 反归一化共用)
+//   Linear    x = min + u (max - min)
+//   Log       x = min (max/min)^u，要求 min > 0；跨数量级的模量在 u 上等比例分布
+//   Logit     u 经缩放的 sigmoid 映射到区间，两端分辨率更高 (如接近上限 0.5 的泊松比)
+//   Piecewise 按 knots (u, x) 分段线性，u 与 x 均严格递增，应包含 (0, min) 与 (1, max)
+enum class ParamTransform { Linear, Log, Logit, Piecewise };
+
 // 单个优化参数的定义（解决需求 2：灵活参数）
 struct ParameterSpec {
     std::string name;       // 例如 "Vessel_E", "Plaque_Nu"
@@ -11,6 +22,120 @@ struct ParameterSpec {
     std::string paramType;  // "E" (杨氏模量) 或 "Nu" (泊松比)
     double minVal;          // 真实物理量的下限
     double maxVal;          // 真实物理量的上限
+    ParamTransform transform = ParamTransform::Linear;
+    std::vector<std::pair<double, double>> knots;   // 仅 Piecewise 使用
+
+    // 归一化 -> 物理量 (u 钳制到 [0,1])
+    double toPhysical(double u) const {
+        u = std::max(0.0, std::min(1.0, u));
+        switch (transform) {
+        case ParamTransform::Log:
+            if (minVal > 0.0 && maxVal > 0.0) return minVal * std::pow(maxVal / minVal, u);
+            break;
+        case ParamTransform::Logit: {
+            double lo = sigmoid(-LOGIT_SLOPE), hi = sigmoid(LOGIT_SLOPE);
+            double f = (sigmoid(LOGIT_SLOPE * (2.0 * u - 1.0)) - lo) / (hi - lo);
+            return minVal + f * (maxVal - minVal);
+        }
+        case ParamTransform::Piecewise:
+            if (knots.size() >= 2) return interpolate(u, false);
+            break;
+        default:
+            break;
+        }
+        return minVal + u * (maxVal - minVal);
+    }
+
+    // 物理量 -> 归一化 (结果钳制到 [0,1])
+    double toNormalized(double x) const {
+        double u = 0.0;
+        switch (transform) {
+        case ParamTransform::Log:
+            if (minVal > 0.0 && maxVal > 0.0) {
+                u = std::log(std::max(x, minVal) / minVal) / std::log(maxVal / minVal);
+                break;
+            }
+            u = (x - minVal) / (maxVal - minVal);
+            break;
+        case ParamTransform::Logit: {
+            double lo = sigmoid(-LOGIT_SLOPE), hi = sigmoid(LOGIT_SLOPE);
+            double f = std::max(0.0, std::min(1.0, (x - minVal) / (maxVal - minVal)));
+            double y = std::max(1e-12, std::min(1.0 - 1e-12, lo + f * (hi - lo)));
+            u = (std::log(y / (1.0 - y)) / LOGIT_SLOPE + 1.0) * 0.5;
+            break;
+        }
+        case ParamTransform::Piecewise:
+            u = knots.size() >= 2 ? interpolate(x, true) : (x - minVal) / (maxVal - minVal);
+            break;
+        default:
+            u = (x - minVal) / (maxVal - minVal);
+            break;
+        }
+        return std::max(0.0, std::min(1.0, u));
+    }
+
+private:
+    static constexpr double LOGIT_SLOPE = 4.0;
+    static double sigmoid(double z) { return 1.0 / (1.0 + std::exp(-z)); }
+
+    // inverse = false: u -> x；inverse = true: x -> u (两端之外线性外推后由调用方钳制)
+    double interpolate(double v, bool inverse) const {
+        auto in = [inverse](const std::pair<double, double>& k) { return inverse ? k.second : k.first; };
+        auto out = [inverse](const std::pair<double, double>& k) { return inverse ? k.first : k.second; };
+        size_t j = 1;
+        while (j + 1 < knots.size() && v > in(knots[j])) ++j;
+        const auto& a = knots[j - 1];
+        const auto& b = knots[j];
+        double t = (v - in(a)) / (in(b) - in(a));
+        return out(a) + t * (out(b) - out(a));
+    }
+};
+
+// 不低于该值的误差视为求解失败的惩罚 (Worker 求解失败返回 1e6，缺少输出、超时等为 1e9)
+constexpr double PENALTY_THRESHOLD = 1e5;
+
+// 默认的五个材料参数 (Optimizer、SimWorker 与基准程序共用，变换必须一致)
+// 杨氏模量跨 1.5~2 个数量级，使用对数映射
+inline std::vector<ParameterSpec> defaultParameterSpecs() {
+    std::vector<ParameterSpec> specs;
+    specs.push_back({ "Aorta_E", "Aorta", "E", 0.1e6, 10e6, ParamTransform::Log });
+    specs.push_back({ "Valve_E", "Valve", "E", 0.1e6, 5e6, ParamTransform::Log });
+    specs.push_back({ "AorticAnnulus_E", "AorticAnnulus", "E", 0.1e6, 20e6, ParamTransform::Log });
+    specs.push_back({ "AortomitralCurtain_E", "AortomitralCurtain", "E", 0.1e6, 5e6, ParamTransform::Log });
+    specs.push_back({ "LeftVentricular_E", "LeftVentricular", "E", 0.5e6, 30e6, ParamTransform::Log });
+    return specs;
+}
+
+// 以归一化坐标保存的缓存 (runtime_history.csv、feasibility.csv、screening.csv) 的首行签名：
+// 各参数的名称、变换与边界。任何一项改变后旧缓存中的坐标含义不同，签名不一致的缓存被忽略或重建
+inline std::string transformSignature(const std::vector<ParameterSpec>& specs) {
+    static const char* names[] = { "linear", "log", "logit", "piecewise" };
+    std::ostringstream out;
+    out.precision(12);
+    out << "# transforms";
+    for (const auto& s : specs) {
+        out << " " << s.name << ":" << names[(int)s.transform] << ":" << s.minVal << ":" << s.maxVal;
+        if (s.transform == ParamTransform::Piecewise) {
+            for (const auto& k : s.knots) out << ":" << k.first << "/" << k.second;
+        }
+    }
+    return out.str();
+}
+
+// 误差函数的权重与切片位置 (Worker 计算误差与离线重新评分共用，见 Core/LossFunction.h)
+struct LossConfig {
+    double hausdorffWeight = 0.2;       // 点集 RMSE 的权重 (useHausdorff 时生效)
+    double radiusWeight = 1.0;          // 切面半径 RMSE 的权重
+    double areaWeight = 2.0;            // 切面面积相对误差的权重
+    double missingSlicePenalty = 10.0;  // 单个切面拟合失败的惩罚
+    double noSlicePenalty = 100.0;      // 所有切面都失败时的惩罚
+    std::vector<double> sliceHeights;   // 切片高度 (mm)，为空时使用支架型号的标准高度
+
+    // 测量值模式：仿真切面与目标切面的测量值 (长/短轴、面积、周长) 比较，目标测量值每个病人只计算一次并缓存
+    // (或直接来自临床测量)，评估时不再配准/切割目标网格，也不计点集距离项。没有目标 STL 时自动使用该模式
+    bool measuredSlices = false;
+    double axisWeight = 1.0;            // 长/短轴绝对误差均值 (mm) 的权重
+    double circumferenceWeight = 1.0;   // 周长相对误差的权重
 };
 
 // 仿真环境配置（解决需求 1：暴露设置）
@@ -27,4 +152,12 @@ struct SimulationConfig {
 
     bool useHausdorff = false;
     std::string targetMeshPath;
+
+    // [新增] 配准与距离误差使用的体素降采样边长 (0 表示全分辨率)；目标模型的降采样结果缓存在 targetMeshPath + ".lod"
+    double lodVoxelSize = 0.0;
+
+    // [新增] 目标切面测量值 (TargetSliceData) 的缓存/临床测量文件，见 LossFunction::loadOrMeasureTargets
+    std::string targetSlicesPath;
+
+    LossConfig loss;
 };
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "CpuTopology.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+#include <filesystem>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static bool readInt(const std::string& path, int& value) {
+    std::ifstream in(path);
+    return static_cast<bool>(in >> value);
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+#ifdef __linux__
+    // 只统计当前进程允许使用的 CPU (taskset / cgroup cpuset 的限制)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    const std::string root = "/sys/devices/system/cpu/";
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() < 4 || name.compare(0, 3, "cpu") != 0 || !std::all_of(name.begin() + 3, name.end(), ::isdigit)) continue;
+        int id = std::stoi(name.substr(3));
+        if (haveMask && (id >= CPU_SETSIZE || !CPU_ISSET(id, &allowed))) continue;
+
+        int coreId = id, package = 0, node = 0;
+        readInt(root + name + "/topology/core_id", coreId);
+        readInt(root + name + "/topology/physical_package_id", package);
+        for (const auto& sub : fs::directory_iterator(entry.path(), ec)) {
+            std::string subName = sub.path().filename().string();
+            if (subName.size() > 4 && subName.compare(0, 4, "node") == 0 && std::all_of(subName.begin() + 4, subName.end(), ::isdigit)) {
+                node = std::stoi(subName.substr(4));
+                break;
+            }
+        }
+        topology.m_cpus.push_back({ id, package * 65536 + coreId, node });
+    }
+#endif
+    if (topology.m_cpus.empty()) {
+        // 拓扑不可用：每个逻辑 CPU 视为一个物理核，单节点
+        int n = std::max(1u, std::thread::hardware_concurrency());
+        for (int i = 0; i < n; ++i) topology.m_cpus.push_back({ i, i, 0 });
+    }
+    std::sort(topology.m_cpus.begin(), topology.m_cpus.end(), [](const Cpu& a, const Cpu& b) { return a.id < b.id; });
+    return topology;
+}
+
+std::vector<CpuTopology::Core> CpuTopology::cores() const {
+    std::map<std::pair<int, int>, Core> byKey;   // (节点, 物理核) -> 逻辑 CPU，按节点排序
+    for (const auto& cpu : m_cpus) {
+        Core& core = byKey[{ cpu.node, cpu.core }];
+        core.node = cpu.node;
+        core.cpus.push_back(cpu.id);
+    }
+    std::vector<Core> out;
+    for (auto& entry : byKey) out.push_back(std::move(entry.second));
+    // 同一节点内按第一个逻辑 CPU 排序，使相邻槽位分得编号连续的核
+    std::stable_sort(out.begin(), out.end(), [](const Core& a, const Core& b) {
+        return a.node != b.node ? a.node < b.node : a.cpus.front() < b.cpus.front();
+    });
+    return out;
+}
+
+int CpuTopology::physicalCores() const {
+    return (int)cores().size();
+}
+
+int CpuTopology::numaNodes() const {
+    std::set<int> nodes;
+    for (const auto& cpu : m_cpus) nodes.insert(cpu.node);
+    return std::max(1, (int)nodes.size());
+}
+
+std::vector<WorkerCpuSet> CpuTopology::plan(int slots, const CpuLayoutPolicy& policy) const {
+    slots = std::max(1, slots);
+    std::vector<Core> allCores = cores();
+    const int total = std::max(1, (int)allCores.size());
+    std::vector<WorkerCpuSet> sets(slots);
+
+    // 把 cores[begin, begin + count) (循环取用，核不足时槽位之间会重叠) 分给一个槽位
+    auto assign = [&](WorkerCpuSet& set, const std::vector<const Core*>& pool, int begin, int count) {
+        std::set<int> nodes;
+        for (int k = 0; k < count; ++k) {
+            const Core* core = pool[(begin + k) % pool.size()];
+            nodes.insert(core->node);
+            if (policy.useSmt) set.cpus.insert(set.cpus.end(), core->cpus.begin(), core->cpus.end());
+            else set.cpus.push_back(core->cpus.front());
+        }
+        std::sort(set.cpus.begin(), set.cpus.end());
+        set.cpus.erase(std::unique(set.cpus.begin(), set.cpus.end()), set.cpus.end());
+        set.node = nodes.size() == 1 ? *nodes.begin() : -1;
+    };
+
+    if (policy.layout == WorkerLayout::Unpinned) {
+        int threads = policy.threadsPerWorker > 0 ? policy.threadsPerWorker : std::max(1, total / slots);
+        for (auto& set : sets) set.threads = threads;
+        return sets;
+    }
+
+    if (policy.layout == WorkerLayout::Compact) {
+        std::vector<const Core*> pool;
+        for (const auto& core : allCores) pool.push_back(&core);
+        int perSlot = policy.threadsPerWorker > 0 ? std::min(policy.threadsPerWorker, total) : std::max(1, total / slots);
+        for (int s = 0; s < slots; ++s) {
+            assign(sets[s], pool, s * perSlot, perSlot);
+            sets[s].threads = policy.threadsPerWorker > 0 ? policy.threadsPerWorker : perSlot;
+        }
+        return sets;
+    }
+
+    // NumaSpread：槽位 s 落在第 (s mod 节点数) 个节点，节点内的物理核由落在该节点的槽位均分
+    std::map<int, std::vector<const Core*>> byNode;
+    for (const auto& core : allCores) byNode[core.node].push_back(&core);
+    std::vector<int> nodeIds;
+    for (const auto& entry : byNode) nodeIds.push_back(entry.first);
+    const int nodeCount = (int)nodeIds.size();
+    for (int n = 0; n < nodeCount; ++n) {
+        const auto& pool = byNode[nodeIds[n]];
+        int slotsHere = slots / nodeCount + (n < slots % nodeCount ? 1 : 0);
+        if (slotsHere == 0) continue;
+        int nodeCores = (int)pool.size();
+        int perSlot = policy.threadsPerWorker > 0 ? std::min(policy.threadsPerWorker, nodeCores) : std::max(1, nodeCores / slotsHere);
+        for (int k = 0; k < slotsHere; ++k) {
+            WorkerCpuSet& set = sets[n + k * nodeCount];
+            assign(set, pool, k * perSlot, perSlot);
+            set.threads = policy.threadsPerWorker > 0 ? policy.threadsPerWorker : perSlot;
+        }
+    }
+    return sets;
+}
+
+const char* CpuTopology::layoutName(WorkerLayout layout) {
+    switch (layout) {
+    case WorkerLayout::Unpinned: return "unpinned";
+    case WorkerLayout::Compact: return "compact";
+    case WorkerLayout::NumaSpread: return "numa_spread";
+    }
+    return "unknown";
+}
+
+bool CpuTopology::parseLayout(const std::string& name, WorkerLayout& layout) {
+    for (WorkerLayout candidate : { WorkerLayout::Unpinned, WorkerLayout::Compact, WorkerLayout::NumaSpread }) {
+        if (name == layoutName(candidate)) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string CpuTopology::describe() const {
+    std::ostringstream ss;
+    ss << logicalCpus() << " logical CPUs, " << physicalCores() << " physical cores, " << numaNodes() << " NUMA node(s)";
+    return ss.str();
+}
+
+std::string CpuTopology::describe(const std::vector<WorkerCpuSet>& sets, const CpuLayoutPolicy& policy) {
+    std::ostringstream ss;
+    ss << "layout " << layoutName(policy.layout);
+    for (size_t s = 0; s < sets.size(); ++s) {
+        ss << (s == 0 ? ": " : "; ") << "slot " << s << " -> " << sets[s].threads << " threads";
+        if (!sets[s].cpus.empty()) ss << " on CPUs " << sets[s].cpuList();
+        if (sets[s].node >= 0) ss << " (node " << sets[s].node << ")";
+    }
+    return ss.str();
+}
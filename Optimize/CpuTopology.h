@@ -0,0 +1,104 @@
+// Utils/CpuTopology.h
+#pragma once
+#include <string>
+#include <vector>
+
+// 本机 CPU 拓扑与 Worker 槽位的 CPU 划分
+//
+// 多个 SimWorker 并发时，每个 Worker 默认都按整机核数启动 OpenMP/VTK/Eigen 线程，严重超订。
+// Optimizer 按布局策略把物理核 (及 NUMA 节点) 分给各槽位，Worker 绑定到分得的 CPU，
+// 并把所有并行区的线程数限制在预算内 (SimWorker 侧见 ThreadBudget)。
+// 拓扑来自 /sys/devices/system/cpu (只统计当前进程允许使用的 CPU)；其他平台按逻辑 CPU 数处理为单节点。
+
+// 布局策略：
+//   Unpinned   只限制线程数 (物理核数 / 槽位数)，不绑核
+//   Compact    每个槽位独占一段连续的物理核 (按 NUMA 节点排序，整除时槽位不跨节点)
+//   NumaSpread 槽位轮流分配到各 NUMA 节点，节点内再均分物理核 (槽位从不跨节点，内存就近分配)
+enum class WorkerLayout { Unpinned, Compact, NumaSpread };
+
+struct CpuLayoutPolicy {
+    WorkerLayout layout = WorkerLayout::Compact;
+    int threadsPerWorker = 0;   // 每个 Worker 的线程数/物理核数；0 表示按 物理核数 / 槽位数 均分 ("多而瘦" 与 "少而胖" 由槽位数与该值决定)
+    bool useSmt = true;         // 超线程兄弟是否一并分给同一槽位 (线程数仍按物理核计)
+};
+
+// 单个槽位分得的 CPU 与线程预算
+struct WorkerCpuSet {
+    std::vector<int> cpus;      // 为空表示不绑核
+    int threads = 0;            // 并行区线程数上限 (0 表示不限制)
+    int node = -1;              // 所在 NUMA 节点 (-1 表示跨节点或未知)
+
+    // "0-3,8-11" 格式 (与 /sys 的 cpulist、taskset -c 相同)
+    std::string cpuList() const {
+        std::string out;
+        for (size_t i = 0; i < cpus.size();) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+            if (!out.empty()) out += ",";
+            out += std::to_string(cpus[i]);
+            if (j > i) out += "-" + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+        return out;
+    }
+};
+
+class CpuTopology {
+public:
+    struct Cpu {
+        int id;         // 逻辑 CPU 编号
+        int core;       // 物理核编号 (全局唯一，由 package + core_id 组合而成)
+        int node;       // NUMA 节点
+    };
+
+    static CpuTopology detect();
+
+    const std::vector<Cpu>& cpus() const { return m_cpus; }
+    int logicalCpus() const { return (int)m_cpus.size(); }
+    int physicalCores() const;
+    int numaNodes() const;
+
+    // 按策略为 slots 个槽位划分 CPU，返回与槽位编号对应的集合
+    std::vector<WorkerCpuSet> plan(int slots, const CpuLayoutPolicy& policy) const;
+
+    static const char* layoutName(WorkerLayout layout);
+    static bool parseLayout(const std::string& name, WorkerLayout& layout);
+
+    // "0-3,8-11" 格式 (内联，SimWorker 解析输入文件时也使用)
+    static bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+        cpus.clear();
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(',', start);
+            if (end == std::string::npos) end = text.size();
+            std::string range = text.substr(start, end - start);
+            start = end + 1;
+            if (range.empty()) continue;
+            size_t dash = range.find('-');
+            try {
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                if (first < 0 || last < first) return false;
+                for (int c = first; c <= last; ++c) cpus.push_back(c);
+            }
+            catch (...) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 拓扑与划分结果的单行摘要，打印到日志
+    std::string describe() const;
+    static std::string describe(const std::vector<WorkerCpuSet>& sets, const CpuLayoutPolicy& policy);
+
+private:
+    // 物理核：所属节点 + 其全部逻辑 CPU (按编号排序)
+    struct Core {
+        int node;
+        std::vector<int> cpus;
+    };
+    std::vector<Core> cores() const;
+
+    std::vector<Cpu> m_cpus;
+};
@@ -0,0 +1,441 @@
+#include "NetUtils.h" // 必须最先包含 (winsock2.h 早于 windows.h)
+#include "DistributedCoordinator.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <set>
+#include <algorithm>
+// Utils/DistributedCoordinator.cpp
+
+using Clock = std::chrono::steady_clock;
+
+struct AgentConnection {
+    int id = 0;
+    std::string name;
+    std::string peer;
+    int slots = 1;
+    NetUtils::socket_t sock = NetUtils::INVALID;
+    std::mutex sendMutex;              // 保护 sock 的发送与关闭 (在协调器 m_mutex 之后获取)
+    std::set<int> running;             // 已派发、未返回的任务 (受协调器 m_mutex 保护)
+    std::map<int, Clock::time_point> orphaned;   // 上一次连接遗留、可能仍在运行的任务及截止时间 (占用槽位，受 m_mutex 保护)
+    Clock::time_point lastSeen;
+    bool alive = false;
+    std::atomic<bool> finished{ false }; // 读线程已退出，可以回收
+};
+
+DistributedCoordinator::DistributedCoordinator() : DistributedCoordinator(Options()) {}
+
+DistributedCoordinator::DistributedCoordinator(const Options& options) : m_options(options) {}
+
+DistributedCoordinator::~DistributedCoordinator() {
+    stop();
+}
+
+int DistributedCoordinator::start(int port) {
+    NetUtils::initialize();
+    NetUtils::socket_t s = NetUtils::listenOn(port);
+    if (s == NetUtils::INVALID) {
+        std::cerr << "[Coordinator] Failed to listen on port " << port << std::endl;
+        return -1;
+    }
+    m_listenSocket = (intptr_t)s;
+    int actualPort = NetUtils::localPort(s);
+    m_running = true;
+    m_acceptThread = std::thread(&DistributedCoordinator::acceptLoop, this);
+    m_monitorThread = std::thread(&DistributedCoordinator::monitorLoop, this);
+    std::cout << "[Coordinator] Listening on port " << actualPort << std::endl;
+    return actualPort;
+}
+
+void DistributedCoordinator::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_acceptThread.joinable()) m_acceptThread.join();
+    if (m_monitorThread.joinable()) m_monitorThread.join();
+    NetUtils::closeSocket((NetUtils::socket_t)m_listenSocket);
+    m_listenSocket = -1;
+
+    std::vector<std::shared_ptr<AgentConnection>> agents;
+    std::vector<std::pair<std::shared_ptr<AgentConnection>, std::thread>> readers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        agents = m_agents;
+        readers.swap(m_readerThreads);
+        // 仍在等待的评估全部以失败返回
+        for (auto& kv : m_jobs) {
+            if (!kv.second.done) failJobLocked(kv.second, "coordinator stopped");
+        }
+        m_queue.clear();
+    }
+    for (auto& agent : agents) {
+        std::lock_guard<std::mutex> lock(agent->sendMutex);
+        if (agent->sock != NetUtils::INVALID) {
+            NetUtils::sendLine(agent->sock, "BYE");
+            NetUtils::shutdownSocket(agent->sock);
+        }
+    }
+    for (auto& reader : readers) if (reader.second.joinable()) reader.second.join();
+    m_cv.notify_all();
+}
+
+bool DistributedCoordinator::waitForAgents(int minAgents, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto ready = [&] { return (int)m_agents.size() >= minAgents || !m_running; };
+    if (timeoutMs < 0) m_cv.wait(lock, ready);
+    else m_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+    return (int)m_agents.size() >= minAgents;
+}
+
+int DistributedCoordinator::agentCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_agents.size();
+}
+
+int DistributedCoordinator::totalSlots() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int total = 0;
+    for (const auto& agent : m_agents) total += agent->slots;
+    return total;
+}
+
+RemoteEvaluation DistributedCoordinator::evaluate(const std::string& patientName, const std::string& stentTypeStr,
+    const std::vector<double>& params, int timeoutMs)
+{
+    auto queued = Clock::now();
+    int jobId;
+    Outgoing out;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        jobId = ++m_nextJobId;
+        Job& job = m_jobs[jobId];
+        job.id = jobId;
+        job.patientName = patientName;
+        job.stentTypeStr = stentTypeStr;
+        job.params = params;
+        job.timeoutMs = timeoutMs;
+        if (!m_running) failJobLocked(job, "coordinator not running");
+        else {
+            m_queue.push_back(jobId);
+            dispatchLocked(out);
+        }
+    }
+    sendAll(out);
+
+    RemoteEvaluation remote;
+    remote.jobId = jobId;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [&] { return m_jobs[jobId].done; });
+    const Job& job = m_jobs[jobId];
+    remote.result = job.result;
+    remote.agentName = job.agentName;
+
+    // 排队等待 (没有空闲 Agent 槽位) 与网络/调度开销，与本地模式的阶段名保持一致
+    double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - queued).count();
+    double waitMs = job.attempts > 0 ? std::chrono::duration<double, std::milli>(job.dispatchedAt - queued).count() : totalMs;
+    remote.result.phases.emplace_back("slot_wait", waitMs);
+    remote.result.phases.emplace_back("network_overhead", std::max(0.0, totalMs - waitMs - job.result.wallMs));
+    remote.result.wallMs = totalMs - waitMs;
+    return remote;
+}
+
+void DistributedCoordinator::release(int jobId, bool keepAsBest, double cost) {
+    std::shared_ptr<AgentConnection> target;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_jobs.find(jobId);
+        if (it == m_jobs.end()) return;
+        int agentId = it->second.agentId;
+        m_jobs.erase(it);
+        for (auto& agent : m_agents) {
+            if (agent->id == agentId) { target = agent; break; }
+        }
+    }
+    if (!target) return;
+    std::ostringstream msg;
+    msg << std::setprecision(17);
+    if (keepAsBest) msg << "KEEP " << jobId << " " << cost;
+    else msg << "DROP " << jobId;
+    sendAll({ { target, msg.str() } });
+}
+
+void DistributedCoordinator::acceptLoop() {
+    NetUtils::socket_t server = (NetUtils::socket_t)m_listenSocket;
+    while (m_running) {
+        std::string peer;
+        NetUtils::socket_t c = NetUtils::acceptClient(server, 500, peer);
+        if (c == NetUtils::INVALID) continue;
+
+        auto agent = std::make_shared<AgentConnection>();
+        agent->sock = c;
+        agent->peer = peer;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 回收已退出的读线程 (finished 在线程释放所有锁之后才置位，join 不会等待 m_mutex)
+        for (auto it = m_readerThreads.begin(); it != m_readerThreads.end();) {
+            if (it->first->finished) {
+                it->second.join();
+                it = m_readerThreads.erase(it);
+            }
+            else ++it;
+        }
+        m_readerThreads.emplace_back(agent, std::thread(&DistributedCoordinator::readerLoop, this, agent));
+    }
+}
+
+void DistributedCoordinator::readerLoop(std::shared_ptr<AgentConnection> agent) {
+    NetUtils::LineReader reader(agent->sock);
+    std::string line;
+
+    // 1. 握手：HELLO <name> <slots>
+    bool registered = false;
+    if (reader.readLine(line, 5000) == 1) {
+        std::istringstream ss(line);
+        std::string cmd;
+        ss >> cmd >> agent->name >> agent->slots;
+        registered = ss && cmd == "HELLO" && agent->slots > 0;
+    }
+    if (registered) {
+        Outgoing out;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            agent->id = ++m_nextAgentId;
+            agent->alive = m_running;
+            agent->lastSeen = Clock::now();
+            if (agent->alive) {
+                m_agents.push_back(agent);
+                std::cout << "[Coordinator] Agent '" << agent->name << "' (" << agent->peer << ") registered with "
+                    << agent->slots << " slots. Online: " << m_agents.size() << std::endl;
+                // 重连：上一次连接的任务可能仍在节点上运行，回报或到期前占用槽位
+                auto orphans = m_orphanedJobs.find(agent->name);
+                if (orphans != m_orphanedJobs.end()) {
+                    agent->orphaned.swap(orphans->second);
+                    m_orphanedJobs.erase(orphans);
+                    std::cout << "[Coordinator] Agent '" << agent->name << "' may still be running " << agent->orphaned.size()
+                        << " job(s) from its previous connection" << std::endl;
+                }
+                dispatchLocked(out);
+            }
+        }
+        m_cv.notify_all();
+        sendAll(out);
+    }
+    else {
+        std::cerr << "[Coordinator] Rejected connection from " << agent->peer << " (bad handshake)" << std::endl;
+    }
+
+    // 2. 消息循环
+    while (registered && m_running) {
+        int r = reader.readLine(line, 1000);
+        if (r < 0) break;
+        Outgoing out;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!agent->alive) break;
+            if (r == 0) continue;
+            agent->lastSeen = Clock::now();
+            if (line.rfind("RESULT ", 0) == 0) handleResult(agent, line, out);
+            // HEARTBEAT 只用于刷新 lastSeen
+        }
+        sendAll(out);
+    }
+
+    // 3. 连接断开：重新派发该 Agent 上未完成的任务
+    Outgoing out;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (agent->alive) markLostLocked(agent, m_running ? "connection closed" : "coordinator stopped");
+        dispatchLocked(out);
+    }
+    sendAll(out);
+    {
+        std::lock_guard<std::mutex> lock(agent->sendMutex);
+        NetUtils::closeSocket(agent->sock);
+        agent->sock = NetUtils::INVALID;
+    }
+    agent->finished = true;
+}
+
+void DistributedCoordinator::handleResult(const std::shared_ptr<AgentConnection>& agent, const std::string& line, Outgoing& out) {
+    std::istringstream ss(line);
+    std::string cmd;
+    int jobId = -1, status = 0;
+    size_t nPhases = 0;
+    WorkerResult result;
+    ss >> cmd >> jobId >> result.cost >> result.wallMs >> status >> nPhases;
+    if (!ss) {
+        std::cerr << "[Coordinator] Malformed result from " << agent->name << ": " << line << std::endl;
+        return;
+    }
+    result.timedOut = status != 0;
+    result.stalled = status == 2;
+    if (result.stalled) result.stallReason = "stalled on agent " + agent->name;
+    for (size_t i = 0; i < nPhases; ++i) {
+        std::string name;
+        double ms;
+        if (!(ss >> name >> ms)) break;
+        result.phases.emplace_back(name, ms);
+    }
+
+    agent->running.erase(jobId);
+    bool orphaned = agent->orphaned.erase(jobId) > 0;
+    auto it = m_jobs.find(jobId);
+    if (orphaned && it != m_jobs.end() && !it->second.done && it->second.agentId < 0) {
+        // 重连前的运行先于重新派发完成：直接采用其结果，撤出队列，避免同一任务仿真两次
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), jobId), m_queue.end());
+        it->second.agentId = agent->id;
+    }
+    if (it == m_jobs.end() || it->second.done || it->second.agentId != agent->id) {
+        // 已被重新派发或按超时处理的过期结果，让 Agent 删除其输出
+        out.emplace_back(agent, "DROP " + std::to_string(jobId));
+    }
+    else {
+        it->second.result = result;
+        it->second.agentName = agent->name;
+        it->second.done = true;
+        m_cv.notify_all();
+    }
+    dispatchLocked(out);
+}
+
+void DistributedCoordinator::markLostLocked(const std::shared_ptr<AgentConnection>& agent, const std::string& reason) {
+    agent->alive = false;
+    {
+        std::lock_guard<std::mutex> sendLock(agent->sendMutex);
+        if (agent->sock != NetUtils::INVALID) NetUtils::shutdownSocket(agent->sock);
+    }
+    m_agents.erase(std::remove(m_agents.begin(), m_agents.end(), agent), m_agents.end());
+
+    // 节点上的 Worker 不随连接终止：记下这些任务的截止时间，同名 Agent 重连后据此占用槽位。
+    // 新连接可能先于旧连接被判定丢失完成注册，此时直接记到新连接上
+    std::shared_ptr<AgentConnection> successor;
+    for (auto& other : m_agents) {
+        if (other->alive && other->name == agent->name) successor = other;
+    }
+    auto& orphans = successor ? successor->orphaned : m_orphanedJobs[agent->name];
+    orphans.insert(agent->orphaned.begin(), agent->orphaned.end());
+    agent->orphaned.clear();
+
+    int requeued = 0;
+    for (int jobId : agent->running) {
+        auto it = m_jobs.find(jobId);
+        if (it == m_jobs.end() || it->second.done) continue;
+        Job& job = it->second;
+        orphans[jobId] = job.dispatchedAt + std::chrono::milliseconds((long long)job.timeoutMs + m_options.deadlineGraceMs);
+        job.agentId = -1;
+        if (job.attempts >= m_options.maxAttempts) {
+            failJobLocked(job, "lost on " + std::to_string(job.attempts) + " agents");
+        }
+        else {
+            m_queue.push_front(jobId); // 优先于新任务重新派发
+            requeued++;
+        }
+    }
+    agent->running.clear();
+    std::cout << "[Coordinator] Agent '" << agent->name << "' lost (" << reason << "). Requeued " << requeued
+        << " job(s). Online: " << m_agents.size() << std::endl;
+    m_cv.notify_all();
+}
+
+void DistributedCoordinator::failJobLocked(Job& job, const std::string& reason) {
+    std::cerr << "[Coordinator] Job " << job.id << " failed: " << reason << std::endl;
+    job.result = WorkerResult();
+    job.result.timedOut = true;
+    job.agentId = -1;
+    job.done = true;
+    m_cv.notify_all();
+}
+
+// 按队列顺序把任务派发给空闲槽位最多的 Agent
+// 不派发给仍可能在运行同一任务的 Agent (重连前的遗留任务)，避免节点上同一输出目录被两次运行同时写入；
+// 这样的任务暂留队列中，后面的任务照常派发
+void DistributedCoordinator::dispatchLocked(Outgoing& out) {
+    for (auto q = m_queue.begin(); q != m_queue.end();) {
+        int jobId = *q;
+        auto it = m_jobs.find(jobId);
+        if (it == m_jobs.end() || it->second.done) {
+            q = m_queue.erase(q);
+            continue;
+        }
+
+        std::shared_ptr<AgentConnection> best;
+        int bestFree = 0;
+        bool anyFree = false;
+        for (auto& agent : m_agents) {
+            int freeSlots = agent->slots - (int)agent->running.size() - (int)agent->orphaned.size();
+            if (!agent->alive || freeSlots <= 0) continue;
+            anyFree = true;
+            if (freeSlots > bestFree && !agent->orphaned.count(jobId)) {
+                best = agent;
+                bestFree = freeSlots;
+            }
+        }
+        if (!anyFree) return;
+        if (!best) {
+            ++q;
+            continue;
+        }
+
+        q = m_queue.erase(q);
+        Job& job = it->second;
+        job.agentId = best->id;
+        job.attempts++;
+        job.dispatchedAt = Clock::now();
+        best->running.insert(jobId);
+
+        std::ostringstream msg;
+        msg << std::setprecision(17) << "EVAL " << jobId << " " << job.stentTypeStr << " " << job.timeoutMs << " " << job.params.size();
+        for (double p : job.params) msg << " " << p;
+        msg << " " << job.patientName;
+        out.emplace_back(best, msg.str());
+    }
+}
+
+// 在协调器锁之外发送，避免慢连接阻塞调度；发送失败由读线程检测到断开后处理
+void DistributedCoordinator::sendAll(const Outgoing& out) {
+    for (const auto& item : out) {
+        std::lock_guard<std::mutex> lock(item.first->sendMutex);
+        if (item.first->sock == NetUtils::INVALID) continue;
+        if (!NetUtils::sendLine(item.first->sock, item.second)) NetUtils::shutdownSocket(item.first->sock);
+    }
+}
+
+// 心跳与任务截止时间检查
+void DistributedCoordinator::monitorLoop() {
+    while (m_running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        Outgoing out;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto now = Clock::now();
+            auto agents = m_agents;
+            for (auto& agent : agents) {
+                auto silentMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - agent->lastSeen).count();
+                if (agent->alive && silentMs > m_options.heartbeatTimeoutMs) markLostLocked(agent, "heartbeat timeout");
+            }
+            // 到期仍未回报的遗留任务不再占用槽位 (Worker 已被节点按超时终止)
+            auto expire = [&](std::map<int, Clock::time_point>& orphans) {
+                for (auto it = orphans.begin(); it != orphans.end();) {
+                    if (now > it->second) it = orphans.erase(it);
+                    else ++it;
+                }
+            };
+            for (auto& agent : m_agents) expire(agent->orphaned);
+            for (auto it = m_orphanedJobs.begin(); it != m_orphanedJobs.end();) {
+                expire(it->second);
+                if (it->second.empty()) it = m_orphanedJobs.erase(it);
+                else ++it;
+            }
+            for (auto& kv : m_jobs) {
+                Job& job = kv.second;
+                if (job.done || job.agentId < 0) continue;
+                auto runMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - job.dispatchedAt).count();
+                if (runMs > (long long)job.timeoutMs + m_options.deadlineGraceMs) {
+                    for (auto& agent : m_agents) {
+                        if (agent->id == job.agentId) agent->running.erase(job.id);
+                    }
+                    failJobLocked(job, "deadline exceeded");
+                }
+            }
+            dispatchLocked(out);
+        }
+        sendAll(out);
+    }
+}
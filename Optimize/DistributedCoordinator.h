@@ -0,0 +1,110 @@
+// Utils/DistributedCoordinator.h
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "ProcessUtils.h"
+
+// 分布式评估：计算节点上的 SimAgent 通过 TCP 向优化器注册，
+// 协调器把评估请求 (病人名, 支架型号, 归一化参数) 派发给有空闲槽位的 Agent，
+// Agent 在本地用自己的数据副本运行 SimWorker 并回传结果与心跳。
+// 连接断开或心跳超时的 Agent 上未完成的任务会被重新排队；同名 Agent 重连后，
+// 这些任务在节点上可能仍在运行，在它们回报结果或超过截止时间之前继续占用该 Agent 的槽位。
+//
+// 文本行协议 (每条消息一行，字段以空格分隔)：
+//   Agent -> 协调器  HELLO <agentName> <slots>
+//                    HEARTBEAT <runningJobs>
+//                    RESULT <jobId> <cost> <wallMs> <status> <nPhases> [<phase> <ms>]...
+//                           status: 0 正常结束，1 超时，2 求解停滞被终止
+//   协调器 -> Agent  EVAL <jobId> <stentType> <timeoutMs> <nParams> <p>... <patientName>
+//                    KEEP <jobId> <cost>    该评估成为全局最优，Agent 将其发布为本地 best_output
+//                    DROP <jobId>           删除该评估的输出目录
+//                    BYE
+struct RemoteEvaluation {
+    WorkerResult result;
+    int jobId = -1;
+    std::string agentName;
+};
+
+struct AgentConnection;
+
+class DistributedCoordinator {
+public:
+    struct Options {
+        int heartbeatTimeoutMs = 15000;  // 超过该时间没有任何消息视为 Agent 丢失
+        int maxAttempts = 3;             // 同一任务最多派发次数 (Agent 丢失时重新排队)
+        int deadlineGraceMs = 60000;     // 超过 timeoutMs + grace 仍未返回的任务按超时处理
+    };
+
+    DistributedCoordinator();
+    explicit DistributedCoordinator(const Options& options);
+    ~DistributedCoordinator();
+
+    // 在 port 上监听 (0 表示由系统分配)，返回实际端口，失败返回 -1
+    int start(int port);
+    void stop();
+
+    // 阻塞直到至少有 minAgents 个 Agent 在线，超时返回 false (timeoutMs < 0 表示一直等)
+    bool waitForAgents(int minAgents, int timeoutMs);
+
+    int agentCount() const;
+    int totalSlots() const;
+
+    // 远程评估一次 (阻塞直到有结果)；Agent 丢失时自动重新派发
+    RemoteEvaluation evaluate(const std::string& patientName, const std::string& stentTypeStr,
+        const std::vector<double>& params, int timeoutMs);
+
+    // 告知执行该任务的 Agent 保留 (发布为 best_output) 或删除其输出目录
+    void release(int jobId, bool keepAsBest, double cost);
+
+private:
+    struct Job {
+        int id = 0;
+        std::string patientName;
+        std::string stentTypeStr;
+        std::vector<double> params;
+        int timeoutMs = 0;
+        int attempts = 0;
+        int agentId = -1;
+        bool done = false;
+        std::chrono::steady_clock::time_point dispatchedAt;
+        WorkerResult result;
+        std::string agentName;
+    };
+    using Outgoing = std::vector<std::pair<std::shared_ptr<AgentConnection>, std::string>>;
+
+    void acceptLoop();
+    void readerLoop(std::shared_ptr<AgentConnection> agent);
+    void monitorLoop();
+    void handleResult(const std::shared_ptr<AgentConnection>& agent, const std::string& line, Outgoing& out);
+    // 持有 m_mutex 调用，内部会获取 agent->sendMutex (见下方的加锁顺序)
+    void markLostLocked(const std::shared_ptr<AgentConnection>& agent, const std::string& reason);
+    void failJobLocked(Job& job, const std::string& reason);
+    void dispatchLocked(Outgoing& out);
+    void sendAll(const Outgoing& out);
+
+    Options m_options;
+    std::atomic<bool> m_running{ false };
+    intptr_t m_listenSocket = -1;
+    std::thread m_acceptThread;
+    std::thread m_monitorThread;
+
+    // 加锁顺序：m_mutex -> AgentConnection::sendMutex。持有 sendMutex 时不得再获取 m_mutex
+    // (sendAll 在 m_mutex 之外发送；markLostLocked 在 m_mutex 之内关闭套接字)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::shared_ptr<AgentConnection>> m_agents;
+    std::vector<std::pair<std::shared_ptr<AgentConnection>, std::thread>> m_readerThreads;  // 已结束的由 acceptLoop 回收
+    std::map<std::string, std::map<int, std::chrono::steady_clock::time_point>> m_orphanedJobs;  // 丢失的 Agent 名 -> 可能仍在运行的任务及截止时间
+    std::map<int, Job> m_jobs;
+    std::deque<int> m_queue;
+    int m_nextJobId = 0;
+    int m_nextAgentId = 0;
+};
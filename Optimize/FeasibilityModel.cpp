@@ -0,0 +1,128 @@
+#include "FeasibilityModel.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+FeasibilityModel::FeasibilityModel(const std::string& historyPath, const std::string& signature, size_t dim)
+    : FeasibilityModel(historyPath, signature, dim, Options()) {}
+
+FeasibilityModel::FeasibilityModel(const std::string& historyPath, const std::string& signature, size_t dim, const Options& options)
+    : m_historyPath(historyPath), m_signature(signature), m_dim(dim), m_options(options)
+{
+    load();
+}
+
+void FeasibilityModel::load() {
+    std::ifstream in(m_historyPath);
+    if (!in.is_open()) return;
+    std::string line;
+    std::getline(in, line);
+    if (line != m_signature) {
+        in.close();
+        std::error_code ec;
+        fs::rename(m_historyPath, m_historyPath + ".stale", ec);
+        std::cout << "[Feasibility] " << m_historyPath << " was recorded under different parameter transforms, starting over" << std::endl;
+        return;
+    }
+    std::getline(in, line); // 表头
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<double> values;
+        while (std::getline(ss, cell, ',')) {
+            try { values.push_back(std::stod(cell)); }
+            catch (...) { values.clear(); break; }
+        }
+        // Failed,Cost,<归一化参数>；维度不一致 (参数规格变化) 的记录忽略
+        if (values.size() != m_dim + 2) continue;
+        bool failed = values[0] != 0;
+        m_points.emplace_back(values.begin() + 2, values.end());
+        m_failed.push_back(failed ? 1 : 0);
+        if (failed) m_failures++;
+        else m_worstFeasible = std::max(m_worstFeasible, values[1]);
+    }
+    if (!m_points.empty()) {
+        std::cout << "[Feasibility] Loaded " << m_points.size() << " samples (" << m_failures << " failed) from "
+            << m_historyPath << std::endl;
+    }
+}
+
+void FeasibilityModel::observe(const std::vector<double>& params, bool failed, double cost) {
+    if (params.size() != m_dim) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_points.push_back(params);
+    m_failed.push_back(failed ? 1 : 0);
+    if (failed) m_failures++;
+    else m_worstFeasible = std::max(m_worstFeasible, cost);
+
+    std::error_code ec;
+    bool writeHeader = !fs::exists(m_historyPath, ec);
+    std::ofstream out(m_historyPath, std::ios::app);
+    if (!out.is_open()) return;
+    if (writeHeader) {
+        out << m_signature << "\n";
+        out << "Failed,Cost";
+        for (size_t i = 0; i < m_dim; ++i) out << ",x" << i;
+        out << "\n";
+    }
+    out << (failed ? 1 : 0) << "," << cost;
+    for (double v : params) out << "," << v;
+    out << "\n";
+}
+
+void FeasibilityModel::estimateLocked(const std::vector<double>& params, double& risk, double& evidence) const {
+    const double inv2h2 = 1.0 / (2.0 * m_options.bandwidth * m_options.bandwidth);
+    double weightSum = 0.0, failSum = 0.0;
+    for (size_t k = 0; k < m_points.size(); ++k) {
+        double d2 = 0.0;
+        for (size_t i = 0; i < m_dim && i < params.size(); ++i) {
+            double d = params[i] - m_points[k][i];
+            d2 += d * d;
+        }
+        double w = std::exp(-d2 * inv2h2);
+        weightSum += w;
+        if (m_failed[k]) failSum += w;
+    }
+    evidence = weightSum;
+    risk = (m_options.priorFailures + failSum) / (m_options.priorFailures + m_options.priorSuccesses + weightSum);
+}
+
+double FeasibilityModel::risk(const std::vector<double>& params) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    double r, evidence;
+    estimateLocked(params, r, evidence);
+    return r;
+}
+
+bool FeasibilityModel::risky(const std::vector<double>& params) const {
+    if (!m_options.enabled) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 尚无失败 (无需规避) 或尚无可行结果 (无处可去，多为环境问题) 时不拦截
+    if (m_failures == 0 || m_worstFeasible < 0.0) return false;
+    double r, evidence;
+    estimateLocked(params, r, evidence);
+    return evidence >= m_options.minEvidence && r > m_options.riskThreshold;
+}
+
+double FeasibilityModel::constraintCost(double cost) const {
+    if (!m_options.enabled || cost < PENALTY_THRESHOLD) return cost;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_worstFeasible < 0.0) return cost;
+    // 略差于最差的可行结果：排序上位于所有可行点之后，数值上不破坏代理模型的尺度
+    return m_worstFeasible + 1e-6 * std::max(1.0, std::abs(m_worstFeasible));
+}
+
+int FeasibilityModel::observations() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_points.size();
+}
+
+int FeasibilityModel::failures() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failures;
+}
@@ -0,0 +1,60 @@
+// Utils/FeasibilityModel.h
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include "Common.h"
+
+// 仿真失败概率的在线模型 (每个病人一个实例，线程安全)
+//
+// 失败：超时/停滞被终止，或误差达到惩罚值 (求解失败 1e6、缺少输出等 1e9)。
+// 失败概率按归一化参数空间中的高斯核加权估计 (Beta 先验平滑)：
+//   p(x) = (a + Σ w_i f_i) / (a + b + Σ w_i),  w_i = exp(-|x - x_i|² / 2h²)
+// 近邻证据 Σ w_i 不足时不做判断，避免在未探索区域误拒。
+// 样本追加到 outputDir/feasibility.csv，重启后继续使用 (首行签名处理同 RuntimePredictor)。
+//
+// 优化器据此：派发前修复/跳过高风险候选点；失败按约束处理，
+// 以目前最差的可行误差代替惩罚值参与排序/建模 (constraintCost)。
+class FeasibilityModel {
+public:
+    struct Options {
+        bool enabled = true;
+        double riskThreshold = 0.7;   // 预测失败概率高于该值视为高风险
+        double bandwidth = 0.1;       // 核宽度 (归一化参数空间)
+        double minEvidence = 2.0;     // 近邻有效样本数低于该值时不判定为高风险
+        double priorFailures = 0.2;   // Beta 先验 (先验失败率 0.2)
+        double priorSuccesses = 0.8;
+    };
+
+    FeasibilityModel(const std::string& historyPath, const std::string& signature, size_t dim);
+    FeasibilityModel(const std::string& historyPath, const std::string& signature, size_t dim, const Options& options);
+
+    void observe(const std::vector<double>& params, bool failed, double cost);
+
+    double risk(const std::vector<double>& params) const;
+    bool risky(const std::vector<double>& params) const;
+
+    // 交给优化器的误差：可行结果原样返回，失败结果取目前最差的可行误差 (尚无可行结果时原样返回)
+    double constraintCost(double cost) const;
+
+    static bool isFailure(double cost, bool timedOut) { return timedOut || cost >= PENALTY_THRESHOLD; }
+
+    int observations() const;
+    int failures() const;
+    const Options& options() const { return m_options; }
+
+private:
+    void load();
+    void estimateLocked(const std::vector<double>& params, double& risk, double& evidence) const;
+
+    std::string m_historyPath;
+    std::string m_signature;
+    size_t m_dim;
+    Options m_options;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::vector<double>> m_points;
+    std::vector<char> m_failed;
+    int m_failures = 0;
+    double m_worstFeasible = -1.0;   // < 0 表示尚无可行结果
+};
@@ -0,0 +1,246 @@
+#include "GeometryArchive.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+// Utils/GeometryArchive.cpp
+
+namespace fs = std::filesystem;
+
+// .geo 单帧文件头
+struct GeoHeader {
+    char magic[4];
+    std::uint32_t numPoints;
+    std::uint32_t numTriangles;
+};
+
+// archive.topo 文件头 (其后为 float32 参考坐标与 uint32 三角形索引)
+struct TopologyHeader {
+    char magic[4];
+    std::uint32_t numPoints;
+    std::uint32_t numTriangles;
+    double quantization;
+};
+
+GeometryArchive::GeometryArchive() : m_data(std::make_unique<MappedFile>()), m_index(std::make_unique<MappedFile>()) {}
+
+GeometryArchive::~GeometryArchive() { close(); }
+
+bool GeometryArchive::readGeo(const std::string& path, std::vector<float>& coords, std::vector<std::uint32_t>& triangles) {
+    std::ifstream in(path, std::ios::binary);
+    GeoHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "GEO1", 4) != 0) return false;
+    coords.resize((size_t)header.numPoints * 3);
+    triangles.resize((size_t)header.numTriangles * 3);
+    return in.read(reinterpret_cast<char*>(coords.data()), coords.size() * sizeof(float)) &&
+        in.read(reinterpret_cast<char*>(triangles.data()), triangles.size() * sizeof(std::uint32_t));
+}
+
+bool GeometryArchive::open(const std::string& dir, bool writable) {
+    return open(dir, writable, Options());
+}
+
+bool GeometryArchive::open(const std::string& dir, bool writable, const Options& options) {
+    close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dir = dir;
+    if (!m_dir.empty() && m_dir.back() != '/' && m_dir.back() != '\\') m_dir += "/";
+    m_writable = writable;
+    m_quantization = options.quantization;
+
+    std::error_code ec;
+    if (writable) fs::create_directories(m_dir, ec);
+    bool hasTopology = loadTopology();
+    if (!hasTopology && !writable) return false;
+
+    if (writable) {
+        // 上次写入中途中断时：丢弃残缺的索引条目与无索引的数据尾部，新记录紧接最后一条完整记录写入
+        std::string idxPath = m_dir + "archive.idx";
+        std::string datPath = m_dir + "archive.dat";
+        std::uint64_t idxBytes = fs::file_size(idxPath, ec);
+        if (ec) idxBytes = 0;
+        std::uint64_t datBytes = fs::file_size(datPath, ec);
+        if (ec) datBytes = 0;
+        m_count = (int)(idxBytes / sizeof(IndexEntry));
+        m_dataBytes = 0;
+        {
+            std::ifstream idx(idxPath, std::ios::binary);
+            while (m_count > 0) {
+                IndexEntry last;
+                idx.seekg((std::streamoff)(m_count - 1) * (std::streamoff)sizeof(IndexEntry));
+                if (!idx.read(reinterpret_cast<char*>(&last), sizeof(last))) return false;
+                if (last.offset + last.length <= datBytes) {
+                    m_dataBytes = last.offset + last.length;
+                    break;
+                }
+                m_count--;   // 索引已写入而数据不完整
+            }
+        }
+        if (idxBytes != (std::uint64_t)m_count * sizeof(IndexEntry)) {
+            fs::resize_file(idxPath, (std::uint64_t)m_count * sizeof(IndexEntry), ec);
+            if (ec) return false;
+        }
+        if (datBytes > m_dataBytes) {
+            fs::resize_file(datPath, m_dataBytes, ec);
+            if (ec) return false;
+        }
+
+        m_dataOut.open(datPath, std::ios::binary | std::ios::app);
+        m_indexOut.open(idxPath, std::ios::binary | std::ios::app);
+        if (!m_dataOut.is_open() || !m_indexOut.is_open()) return false;
+    }
+    refreshLocked();
+    return true;
+}
+
+void GeometryArchive::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dataOut.is_open()) m_dataOut.close();
+    if (m_indexOut.is_open()) m_indexOut.close();
+    m_data->close();
+    m_index->close();
+    m_reference.clear();
+    m_triangles.clear();
+    m_count = 0;
+    m_dataBytes = 0;
+}
+
+bool GeometryArchive::loadTopology() {
+    std::ifstream in(m_dir + "archive.topo", std::ios::binary);
+    TopologyHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "GTP1", 4) != 0) return false;
+    m_quantization = header.quantization;
+    m_reference.resize((size_t)header.numPoints * 3);
+    m_triangles.resize((size_t)header.numTriangles * 3);
+    if (!in.read(reinterpret_cast<char*>(m_reference.data()), m_reference.size() * sizeof(float)) ||
+        !in.read(reinterpret_cast<char*>(m_triangles.data()), m_triangles.size() * sizeof(std::uint32_t))) {
+        m_reference.clear();
+        m_triangles.clear();
+        return false;
+    }
+    return true;
+}
+
+bool GeometryArchive::refreshLocked() {
+    // 文件长度变化 (有新条目) 时重新映射
+    std::error_code ec;
+    std::uint64_t idxBytes = fs::file_size(m_dir + "archive.idx", ec);
+    if (ec) return false;
+    if (m_index->size() == idxBytes && (idxBytes == 0 || m_index->data())) return true;
+    m_index->close();
+    m_data->close();
+    return m_index->open(m_dir + "archive.idx") && m_data->open(m_dir + "archive.dat");
+}
+
+int GeometryArchive::append(const std::vector<float>& coords, const std::vector<std::uint32_t>& triangles) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_writable || coords.empty()) return -1;
+
+    // 1. 第一帧：写入拓扑与参考状态
+    if (m_reference.empty()) {
+        TopologyHeader header;
+        std::memcpy(header.magic, "GTP1", 4);
+        header.numPoints = (std::uint32_t)(coords.size() / 3);
+        header.numTriangles = (std::uint32_t)(triangles.size() / 3);
+        header.quantization = m_quantization;
+        std::string tmpPath = m_dir + "archive.topo.tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(float));
+            out.write(reinterpret_cast<const char*>(triangles.data()), triangles.size() * sizeof(std::uint32_t));
+            if (!out.good()) return -1;
+        }
+        std::error_code ec;
+        fs::rename(tmpPath, m_dir + "archive.topo", ec);
+        if (ec) return -1;
+        m_reference = coords;
+        m_triangles = triangles;
+    }
+    else if (coords.size() != m_reference.size() || triangles != m_triangles) {
+        std::cerr << "[GeometryArchive] Topology mismatch (" << coords.size() / 3 << " vertices / " << triangles.size() / 3
+            << " triangles, archive has " << m_reference.size() / 3 << " / " << m_triangles.size() / 3 << "), frame not archived" << std::endl;
+        return -1;
+    }
+
+    // 2. 量化位移 -> 同轴差分 -> zigzag -> varint
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(coords.size() * 2);
+    std::int64_t prev[3] = { 0, 0, 0 };
+    const double inv = 1.0 / m_quantization;
+    for (size_t k = 0; k < coords.size(); ++k) {
+        std::int64_t q = std::llround(((double)coords[k] - (double)m_reference[k]) * inv);
+        std::int64_t e = q - prev[k % 3];
+        prev[k % 3] = q;
+        std::uint64_t z = ((std::uint64_t)e << 1) ^ (std::uint64_t)(e >> 63);
+        while (z >= 0x80) {
+            buffer.push_back((std::uint8_t)(z | 0x80));
+            z >>= 7;
+        }
+        buffer.push_back((std::uint8_t)z);
+    }
+
+    // 3. 先写数据再写索引：中途崩溃只会留下无索引的数据尾部
+    IndexEntry entry{ m_dataBytes, (std::uint32_t)buffer.size(), 0 };
+    m_dataOut.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    m_dataOut.flush();
+    m_indexOut.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    m_indexOut.flush();
+    if (!m_dataOut.good() || !m_indexOut.good()) return -1;
+    m_dataBytes += buffer.size();
+    return m_count++;
+}
+
+int GeometryArchive::appendGeo(const std::string& geoPath) {
+    std::vector<float> coords;
+    std::vector<std::uint32_t> triangles;
+    if (!readGeo(geoPath, coords, triangles)) return -1;
+    return append(coords, triangles);
+}
+
+bool GeometryArchive::read(int id, std::vector<float>& coords) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id < 0 || m_reference.empty()) return false;
+    if ((std::uint64_t)id >= m_index->size() / sizeof(IndexEntry)) refreshLocked();
+    if ((std::uint64_t)id >= m_index->size() / sizeof(IndexEntry)) return false;
+
+    IndexEntry entry;
+    std::memcpy(&entry, m_index->data() + (size_t)id * sizeof(IndexEntry), sizeof(entry));
+    if (entry.offset + entry.length > m_data->size()) return false;
+
+    const std::uint8_t* p = m_data->data() + entry.offset;
+    const std::uint8_t* end = p + entry.length;
+    coords.resize(m_reference.size());
+    std::int64_t prev[3] = { 0, 0, 0 };
+    for (size_t k = 0; k < coords.size(); ++k) {
+        std::uint64_t z = 0;
+        int shift = 0;
+        while (true) {
+            if (p >= end || shift > 63) return false;
+            std::uint8_t b = *p++;
+            z |= (std::uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        std::int64_t e = (std::int64_t)(z >> 1) ^ -(std::int64_t)(z & 1);
+        std::int64_t q = prev[k % 3] + e;
+        prev[k % 3] = q;
+        coords[k] = (float)((double)m_reference[k] + (double)q * m_quantization);
+    }
+    return true;
+}
+
+int GeometryArchive::count() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writable) return m_count;
+    refreshLocked();
+    return (int)(m_index->size() / sizeof(IndexEntry));
+}
+
+std::uint64_t GeometryArchive::storedBytes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writable) return m_dataBytes;
+    refreshLocked();
+    return m_data->size();
+}
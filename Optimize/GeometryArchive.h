@@ -0,0 +1,70 @@
+// Utils/GeometryArchive.h
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+
+class MappedFile;
+
+// 每个病人所有评估的最终支架几何归档 (outputDir/geometry/archive.*)
+// 同一病人的支架拓扑相同：拓扑与参考状态 (第一次归档的几何) 只存一次 (archive.topo)，
+// 之后每一帧存为相对参考状态的量化位移 (步长 quantization，误差不超过其一半，另加 float32 舍入)，
+// 再按同一坐标轴与前一个顶点做差分，zigzag + varint 编码追加到 archive.dat；
+// archive.idx 为定长索引 (偏移, 长度)，按条目 id 内存映射随机读取。
+// .geo 为 Worker 输出的单帧紧凑格式 (float32 顶点 + uint32 三角形)。
+class GeometryArchive {
+public:
+    struct Options {
+        double quantization = 1e-4;   // 网格单位 (mm)
+    };
+
+    GeometryArchive();
+    ~GeometryArchive();
+
+    // 打开 (writable 时不存在则创建) 归档目录
+    bool open(const std::string& dir, bool writable);
+    bool open(const std::string& dir, bool writable, const Options& options);
+    void close();
+
+    // 追加一帧，返回条目 id；顶点数或拓扑与归档不一致时返回 -1
+    int append(const std::vector<float>& coords, const std::vector<std::uint32_t>& triangles);
+    int appendGeo(const std::string& geoPath);
+
+    // 读取第 id 帧的顶点坐标 (xyz 交错)
+    bool read(int id, std::vector<float>& coords);
+
+    int count();
+    const std::vector<std::uint32_t>& triangles() const { return m_triangles; }
+    double maxError() const { return 0.5 * m_quantization; }
+    std::uint64_t storedBytes();   // 已归档帧的编码字节数 (不含拓扑)
+
+    // 读取 .geo 单帧文件 (格式见 GeometryUtils::saveCompactGeometry)
+    static bool readGeo(const std::string& path, std::vector<float>& coords, std::vector<std::uint32_t>& triangles);
+
+private:
+    struct IndexEntry {
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+
+    bool loadTopology();
+    bool refreshLocked();
+
+    std::string m_dir;
+    bool m_writable = false;
+    double m_quantization = 1e-4;
+    std::vector<float> m_reference;
+    std::vector<std::uint32_t> m_triangles;
+
+    std::mutex m_mutex;
+    std::unique_ptr<MappedFile> m_data;
+    std::unique_ptr<MappedFile> m_index;
+    std::ofstream m_dataOut;
+    std::ofstream m_indexOut;
+    std::uint64_t m_dataBytes = 0;
+    int m_count = 0;
+};
@@ -0,0 +1,267 @@
+#include "MetricsExporter.h"
+#include "NetUtils.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+// Utils/MetricsExporter.cpp
+
+namespace fs = std::filesystem;
+
+static const char* OUTCOME_LABELS[4] = { "ok", "failed", "timeout", "stalled" };
+
+// Prometheus 标签值转义
+static std::string escapeLabel(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+    }
+    return out;
+}
+
+MetricsExporter::MetricsExporter() {}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+const std::vector<double>& MetricsExporter::latencyBounds() {
+    // 单次仿真从数十秒到超时 (默认 15 分钟) 不等
+    static const std::vector<double> bounds = { 15, 30, 60, 120, 180, 300, 450, 600, 900, 1800, 3600 };
+    return bounds;
+}
+
+bool MetricsExporter::start(const Options& options) {
+    stop();
+    m_options = options;
+    m_stop = false;
+    if (m_options.httpPort > 0) {
+        NetUtils::initialize();
+        NetUtils::socket_t server = NetUtils::listenOn(m_options.httpPort);
+        if (server == NetUtils::INVALID) {
+            std::cerr << "[Metrics] Cannot listen on port " << m_options.httpPort << std::endl;
+            return false;
+        }
+        m_server = (long long)server;
+        std::cout << "[Metrics] Serving http://localhost:" << m_options.httpPort << "/metrics" << std::endl;
+    }
+    if (!m_options.filePath.empty()) std::cout << "[Metrics] Writing " << m_options.filePath << std::endl;
+    m_thread = std::thread(&MetricsExporter::exportLoop, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wakeCv.notify_all();
+    m_thread.join();
+    if (m_server >= 0) NetUtils::closeSocket((NetUtils::socket_t)m_server);
+    m_server = -1;
+}
+
+MetricsExporter::PatientMetrics& MetricsExporter::patientLocked(const std::string& patient) {
+    auto it = m_patients.find(patient);
+    if (it == m_patients.end()) {
+        it = m_patients.emplace(patient, PatientMetrics()).first;
+        it->second.buckets.assign(latencyBounds().size(), 0.0);
+    }
+    return it->second;
+}
+
+void MetricsExporter::setSlots(int slots) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots = slots;
+}
+
+void MetricsExporter::setLayout(const std::string& layout, int threadsPerWorker) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_layout = layout;
+    m_threadsPerWorker = threadsPerWorker;
+}
+
+void MetricsExporter::evaluationQueued(const std::string& patient) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    patientLocked(patient).queued++;
+}
+
+int MetricsExporter::evaluationStarted(const std::string& patient, bool wasQueued) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PatientMetrics& m = patientLocked(patient);
+    if (wasQueued) m.queued = std::max(0, m.queued - 1);
+    int ticket = ++m_nextTicket;
+    m.runningSince[ticket] = std::chrono::steady_clock::now();
+    return ticket;
+}
+
+void MetricsExporter::evaluationFinished(const std::string& patient, int ticket, Outcome outcome, double seconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PatientMetrics& m = patientLocked(patient);
+    auto it = m.runningSince.find(ticket);
+    if (it != m.runningSince.end()) {
+        m.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second).count();
+        m.runningSince.erase(it);
+    }
+    m.outcomes[(int)outcome] += 1;
+    const auto& bounds = latencyBounds();
+    for (size_t b = 0; b < bounds.size(); ++b) {
+        if (seconds <= bounds[b]) m.buckets[b] += 1;
+    }
+    m.latencyCount += 1;
+    m.latencySum += seconds;
+}
+
+void MetricsExporter::setBestCost(const std::string& patient, double cost) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    patientLocked(patient).bestCost = cost;
+}
+
+void MetricsExporter::cacheLookup(const std::string& patient, const std::string& cache, bool hit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& counts = patientLocked(patient).cacheLookups[cache];
+    if (hit) counts.first += 1;
+    else counts.second += 1;
+}
+
+std::string MetricsExporter::render() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+    const auto& bounds = latencyBounds();
+    std::ostringstream ss;
+    ss << std::setprecision(10);
+
+    ss << "# HELP stent_opt_evaluations_total Completed evaluations by outcome.\n";
+    ss << "# TYPE stent_opt_evaluations_total counter\n";
+    for (const auto& entry : m_patients) {
+        std::string patient = escapeLabel(entry.first);
+        for (int o = 0; o < 4; ++o) {
+            ss << "stent_opt_evaluations_total{patient=\"" << patient << "\",outcome=\"" << OUTCOME_LABELS[o] << "\"} "
+                << entry.second.outcomes[o] << "\n";
+        }
+    }
+
+    ss << "# HELP stent_opt_evaluation_seconds Wall time of one evaluation.\n";
+    ss << "# TYPE stent_opt_evaluation_seconds histogram\n";
+    for (const auto& entry : m_patients) {
+        std::string patient = escapeLabel(entry.first);
+        const PatientMetrics& m = entry.second;
+        for (size_t b = 0; b < bounds.size(); ++b) {
+            ss << "stent_opt_evaluation_seconds_bucket{patient=\"" << patient << "\",le=\"" << bounds[b] << "\"} " << m.buckets[b] << "\n";
+        }
+        ss << "stent_opt_evaluation_seconds_bucket{patient=\"" << patient << "\",le=\"+Inf\"} " << m.latencyCount << "\n";
+        ss << "stent_opt_evaluation_seconds_sum{patient=\"" << patient << "\"} " << m.latencySum << "\n";
+        ss << "stent_opt_evaluation_seconds_count{patient=\"" << patient << "\"} " << m.latencyCount << "\n";
+    }
+
+    ss << "# HELP stent_opt_evaluations_queued Evaluations waiting for a worker slot.\n";
+    ss << "# TYPE stent_opt_evaluations_queued gauge\n";
+    for (const auto& entry : m_patients) {
+        ss << "stent_opt_evaluations_queued{patient=\"" << escapeLabel(entry.first) << "\"} " << entry.second.queued << "\n";
+    }
+    ss << "# HELP stent_opt_evaluations_running Evaluations holding a worker slot.\n";
+    ss << "# TYPE stent_opt_evaluations_running gauge\n";
+    for (const auto& entry : m_patients) {
+        ss << "stent_opt_evaluations_running{patient=\"" << escapeLabel(entry.first) << "\"} " << entry.second.runningSince.size() << "\n";
+    }
+
+    ss << "# HELP stent_opt_worker_slots Worker slots available to the optimizer.\n";
+    ss << "# TYPE stent_opt_worker_slots gauge\n";
+    ss << "stent_opt_worker_slots " << m_slots << "\n";
+    if (!m_layout.empty()) {
+        ss << "# HELP stent_opt_worker_threads Thread budget of each worker, labelled with the CPU layout policy.\n";
+        ss << "# TYPE stent_opt_worker_threads gauge\n";
+        ss << "stent_opt_worker_threads{layout=\"" << escapeLabel(m_layout) << "\"} " << m_threadsPerWorker << "\n";
+    }
+    ss << "# HELP stent_opt_worker_busy_seconds_total Slot-seconds spent running evaluations (including running ones).\n";
+    ss << "# TYPE stent_opt_worker_busy_seconds_total counter\n";
+    for (const auto& entry : m_patients) {
+        double busy = entry.second.busySeconds;
+        for (const auto& run : entry.second.runningSince) busy += std::chrono::duration<double>(now - run.second).count();
+        ss << "stent_opt_worker_busy_seconds_total{patient=\"" << escapeLabel(entry.first) << "\"} " << busy << "\n";
+    }
+
+    ss << "# HELP stent_opt_best_cost Best cost found so far.\n";
+    ss << "# TYPE stent_opt_best_cost gauge\n";
+    for (const auto& entry : m_patients) {
+        if (entry.second.bestCost < 0) continue;
+        ss << "stent_opt_best_cost{patient=\"" << escapeLabel(entry.first) << "\"} " << entry.second.bestCost << "\n";
+    }
+
+    ss << "# HELP stent_opt_cache_lookups_total On-disk cache lookups (screening results, target LOD).\n";
+    ss << "# TYPE stent_opt_cache_lookups_total counter\n";
+    for (const auto& entry : m_patients) {
+        std::string patient = escapeLabel(entry.first);
+        for (const auto& cache : entry.second.cacheLookups) {
+            std::string labels = "patient=\"" + patient + "\",cache=\"" + escapeLabel(cache.first) + "\"";
+            ss << "stent_opt_cache_lookups_total{" << labels << ",result=\"hit\"} " << cache.second.first << "\n";
+            ss << "stent_opt_cache_lookups_total{" << labels << ",result=\"miss\"} " << cache.second.second << "\n";
+        }
+    }
+    return ss.str();
+}
+
+void MetricsExporter::writeFile() {
+    if (m_options.filePath.empty()) return;
+    // 先写临时文件再替换，采集方不会读到半个文件
+    std::string tmpPath = m_options.filePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return;
+        out << render();
+        if (!out.good()) return;
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, m_options.filePath, ec);
+}
+
+void MetricsExporter::serveClient(long long client) {
+    NetUtils::socket_t s = (NetUtils::socket_t)client;
+    NetUtils::LineReader reader(s);
+    std::string requestLine, line;
+    if (reader.readLine(requestLine, 2000) != 1) {
+        NetUtils::closeSocket(s);
+        return;
+    }
+    while (reader.readLine(line, 2000) == 1 && !line.empty()) {}   // 丢弃请求头
+
+    std::istringstream ss(requestLine);
+    std::string method, path;
+    ss >> method >> path;
+    std::string body, status = "200 OK";
+    if (method != "GET") status = "405 Method Not Allowed";
+    else if (path == "/metrics" || path == "/") body = render();
+    else status = "404 Not Found";
+
+    std::string response = "HTTP/1.0 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body;
+    NetUtils::sendAll(s, response);
+    NetUtils::closeSocket(s);
+}
+
+void MetricsExporter::exportLoop() {
+    auto nextWrite = std::chrono::steady_clock::now();
+    while (!m_stop) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextWrite) {
+            writeFile();
+            nextWrite = now + std::chrono::milliseconds(std::max(100, m_options.intervalMs));
+        }
+        int waitMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(nextWrite - now).count();
+        if (m_server >= 0) {
+            // 抓取请求在本线程内直接应答 (数据量小，不另开线程)；短超时以便及时响应 stop()
+            std::string peer;
+            NetUtils::socket_t client = NetUtils::acceptClient((NetUtils::socket_t)m_server, std::max(0, std::min(waitMs, 500)), peer);
+            if (client != NetUtils::INVALID) serveClient((long long)client);
+        }
+        else {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCv.wait_for(lock, std::chrono::milliseconds(std::max(1, waitMs)), [this] { return m_stop.load(); });
+        }
+    }
+    writeFile();
+}
@@ -0,0 +1,84 @@
+// Utils/MetricsExporter.h
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// 优化器运行指标 (所有病人共享一个实例)，定期以 Prometheus 文本格式导出：
+//   - 写入文件 (原子替换，可配合 node_exporter 的 textfile collector)
+//   - 和/或在 HTTP 端口上提供 /metrics
+// 指标 (前缀 stent_opt_，按 patient 标签区分)：
+//   evaluations_total{outcome=ok|failed|timeout|stalled}  完成的评估数
+//   evaluation_seconds (直方图)                            单次评估的墙钟时间
+//   evaluations_queued / evaluations_running               等待 Worker 槽位 / 正在运行的评估
+//   worker_slots, worker_busy_seconds_total                槽位总数与累计占用时间 (rate / slots = 利用率)
+//   worker_threads{layout=...}                             每个 Worker 的线程预算与 CPU 布局策略
+//   best_cost                                              当前最优误差
+//   cache_lookups_total{result=hit|miss}                   重复参数缓存的命中情况
+class MetricsExporter {
+public:
+    struct Options {
+        std::string filePath;      // 为空则不写文件
+        int httpPort = 0;          // 0 表示不开放 HTTP 端点
+        int intervalMs = 15000;    // 文件刷新周期
+    };
+
+    enum class Outcome { Ok, Failed, TimedOut, Stalled };
+
+    MetricsExporter();
+    ~MetricsExporter();
+
+    bool start(const Options& options);
+    void stop();
+
+    // ---- 由 PatientEvaluator 调用 (线程安全) ----
+    void setSlots(int slots);
+    void setLayout(const std::string& layout, int threadsPerWorker);
+    // 排队 -> 取得槽位 (返回运行票据) -> 结束；远程评估在协调器内排队，直接调用 evaluationStarted
+    void evaluationQueued(const std::string& patient);
+    int evaluationStarted(const std::string& patient, bool wasQueued);
+    void evaluationFinished(const std::string& patient, int ticket, Outcome outcome, double seconds);
+    void setBestCost(const std::string& patient, double cost);
+    // 已有磁盘缓存的查找结果 (cache: "screening" 参数筛选结果、"lod" 目标降采样点集)
+    void cacheLookup(const std::string& patient, const std::string& cache, bool hit);
+
+    // 当前全部指标的 Prometheus 文本
+    std::string render() const;
+
+private:
+    struct PatientMetrics {
+        double outcomes[4] = { 0, 0, 0, 0 };
+        std::vector<double> buckets;       // 与 latencyBounds() 对应的累计计数
+        double latencyCount = 0, latencySum = 0;
+        int queued = 0;
+        double busySeconds = 0;            // 已结束评估的槽位占用时间
+        std::map<int, std::chrono::steady_clock::time_point> runningSince;
+        double bestCost = -1;              // < 0 表示尚无有效结果
+        std::map<std::string, std::pair<double, double>> cacheLookups;   // 缓存名 -> (命中, 未命中)
+    };
+
+    static const std::vector<double>& latencyBounds();
+    PatientMetrics& patientLocked(const std::string& patient);
+    void exportLoop();
+    void writeFile();
+    void serveClient(long long client);
+
+    Options m_options;
+    mutable std::mutex m_mutex;
+    std::map<std::string, PatientMetrics> m_patients;
+    int m_slots = 0;
+    std::string m_layout;
+    int m_threadsPerWorker = 0;
+    int m_nextTicket = 0;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    std::atomic<bool> m_stop{ false };
+    long long m_server = -1;
+    std::thread m_thread;
+};
@@ -0,0 +1,193 @@
+#pragma once
+// 注意：Windows 下 winsock2.h 必须先于 windows.h 包含，请把本头文件放在其他 Utils 头文件之前
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+// 轻量 TCP 工具：阻塞套接字 + 以换行分隔的文本协议
+class NetUtils {
+public:
+#ifdef _WIN32
+    using socket_t = SOCKET;
+    static constexpr socket_t INVALID = INVALID_SOCKET;
+#else
+    using socket_t = int;
+    static constexpr socket_t INVALID = -1;
+#endif
+
+    static void initialize() {
+#ifdef _WIN32
+        static bool done = false;
+        if (!done) {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+            done = true;
+        }
+#else
+        // 对端断开时 send 返回错误而不是触发 SIGPIPE 终止进程
+        signal(SIGPIPE, SIG_IGN);
+#endif
+    }
+
+    static socket_t listenOn(int port) {
+        socket_t s = socket(AF_INET, SOCK_STREAM, 0);
+        if (s == INVALID) return INVALID;
+        int yes = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(yes));
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((unsigned short)port);
+        if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 64) != 0) {
+            closeSocket(s);
+            return INVALID;
+        }
+        return s;
+    }
+
+    // 返回实际监听端口 (listenOn(0) 时由系统分配)
+    static int localPort(socket_t s) {
+        sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        if (getsockname(s, (sockaddr*)&addr, &len) != 0) return -1;
+        return ntohs(addr.sin_port);
+    }
+
+    // 等待连接，超时返回 INVALID
+    static socket_t acceptClient(socket_t server, int timeoutMs, std::string& peer) {
+        if (waitReadable(server, timeoutMs) <= 0) return INVALID;
+        sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        socket_t c = accept(server, (sockaddr*)&addr, &len);
+        if (c == INVALID) return INVALID;
+        char buf[64] = { 0 };
+        inet_ntop(AF_INET, &addr.sin_addr, buf, sizeof(buf));
+        peer = std::string(buf) + ":" + std::to_string(ntohs(addr.sin_port));
+        setNoDelay(c);
+        return c;
+    }
+
+    static socket_t connectTo(const std::string& host, int port) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) return INVALID;
+        socket_t s = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (s != INVALID && connect(s, res->ai_addr, (int)res->ai_addrlen) != 0) {
+            closeSocket(s);
+            s = INVALID;
+        }
+        freeaddrinfo(res);
+        if (s != INVALID) setNoDelay(s);
+        return s;
+    }
+
+    // 发送一行 (自动追加 '\n')；同一套接字的并发发送需由调用方加锁
+    static bool sendLine(socket_t s, const std::string& line) {
+        return sendAll(s, line + "\n");
+    }
+
+    static bool sendAll(socket_t s, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+#ifdef _WIN32
+            int n = send(s, data.data() + sent, (int)(data.size() - sent), 0);
+#else
+            ssize_t n = send(s, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#endif
+            if (n <= 0) return false;
+            sent += (size_t)n;
+        }
+        return true;
+    }
+
+    // 唤醒阻塞在该套接字上的读线程
+    static void shutdownSocket(socket_t s) {
+#ifdef _WIN32
+        shutdown(s, SD_BOTH);
+#else
+        shutdown(s, SHUT_RDWR);
+#endif
+    }
+
+    static void closeSocket(socket_t s) {
+        if (s == INVALID) return;
+#ifdef _WIN32
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    // >0 可读，0 超时，<0 出错
+    static int waitReadable(socket_t s, int timeoutMs) {
+#ifdef _WIN32
+        WSAPOLLFD pfd;
+        pfd.fd = s;
+        pfd.events = POLLRDNORM;
+        pfd.revents = 0;
+        return WSAPoll(&pfd, 1, timeoutMs);
+#else
+        pollfd pfd;
+        pfd.fd = s;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return poll(&pfd, 1, timeoutMs);
+#endif
+    }
+
+    // 按行读取 (带缓冲)
+    class LineReader {
+    public:
+        explicit LineReader(socket_t s) : m_socket(s) {}
+
+        // 1 读到一行，0 超时，-1 连接关闭/出错
+        int readLine(std::string& line, int timeoutMs) {
+            while (true) {
+                size_t pos = m_buffer.find('\n');
+                if (pos != std::string::npos) {
+                    line = m_buffer.substr(0, pos);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    m_buffer.erase(0, pos + 1);
+                    return 1;
+                }
+                int ready = waitReadable(m_socket, timeoutMs);
+                if (ready == 0) return 0;
+                if (ready < 0) return -1;
+                char chunk[4096];
+                int n = (int)recv(m_socket, chunk, sizeof(chunk), 0);
+                if (n <= 0) return -1;
+                m_buffer.append(chunk, (size_t)n);
+            }
+        }
+
+    private:
+        socket_t m_socket;
+        std::string m_buffer;
+    };
+
+private:
+    static void setNoDelay(socket_t s) {
+        int yes = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&yes, sizeof(yes));
+    }
+};
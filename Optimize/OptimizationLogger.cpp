@@ -1,33 +1,230 @@
 #include "OptimizationLogger.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 // Utils/OptimizationLogger.cpp
 
-OptimizationLogger::OptimizationLogger(const std::string& filepath) : m_filepath(filepath) {}
+OptimizationLogger::OptimizationLogger(const std::string& filepath)
+    : OptimizationLogger(filepath, Options()) {}
 
-OptimizationLogger::~OptimizationLogger() {}
+OptimizationLogger::OptimizationLogger(const std::string& filepath, const Options& options)
+    : m_filepath(filepath), m_options(options), m_head(&m_stub), m_tail(&m_stub)
+{
+    // 持久文件句柄 (追加模式)，由后台线程独占使用
+    m_file = std::fopen(m_filepath.c_str(), "ab");
+    if (m_file) {
+        std::setvbuf(m_file, nullptr, _IOFBF, 1 << 16);
+        std::fseek(m_file, 0, SEEK_END);
+        m_fileEmpty = (std::ftell(m_file) == 0);
+    }
+    else {
+        std::cerr << "[Logger] Failed to open log file: " << m_filepath << std::endl;
+    }
+    m_worker = std::thread(&OptimizationLogger::workerLoop, this);
+}
+
+OptimizationLogger::~OptimizationLogger() {
+    m_stop.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCv.notify_one();
+    }
+    if (m_worker.joinable()) m_worker.join();
+
+    if (m_file) {
+        std::fflush(m_file);
+        if (m_options.fsyncPolicy != FsyncPolicy::Never) syncToDisk();
+        std::fclose(m_file);
+    }
+}
+
+// =========================================================
+// 无锁 MPSC 队列
+// =========================================================
+void OptimizationLogger::push(Record* record) {
+    record->next.store(nullptr, std::memory_order_relaxed);
+    Record* prev = m_head.exchange(record, std::memory_order_acq_rel);
+    prev->next.store(record, std::memory_order_release);
+}
+
+OptimizationLogger::Record* OptimizationLogger::pop() {
+    Record* tail = m_tail;
+    Record* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_stub) {
+        if (!next) return nullptr;
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    // tail 是最后一个节点：若生产者正在入队中途，下次再取
+    if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
 
+void OptimizationLogger::enqueue(Record* record, bool wake) {
+    push(record);
+    size_t pending = m_pending.fetch_add(1, std::memory_order_relaxed) + 1;
+    // 常规路径不做系统调用；只有积压或显式要求时才唤醒后台线程
+    if ((wake || pending >= m_options.wakeBatchSize) && m_sleeping.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCv.notify_one();
+    }
+}
+
+// =========================================================
+// 生产者接口
+// =========================================================
 void OptimizationLogger::writeHeader(const std::vector<std::string>& paramNames) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    std::ifstream check(m_filepath);
-    // 如果文件不存在或为空，写入表头
-    if (check.peek() == std::ifstream::traits_type::eof() || !check.good()) {
-        std::ofstream file(m_filepath, std::ios::app);
-        file << "Iteration,";
-        for (const auto& name : paramNames) file << name << ",";
-        file << "Cost\n";
-    }
-}
-
-void OptimizationLogger::logIteration(int iter, const std::vector<double>& params, double cost) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    std::ofstream file(m_filepath, std::ios::app);
-    file << iter << ",";
-    for (double p : params) file << std::fixed << std::setprecision(6) << p << ",";
-    file << cost << "\n";
-
-    // 控制台输出
-    std::cout << "[Logger] Iter: " << iter << " | Cost: " << cost << " | Params: [";
-    for (size_t i = 0; i < params.size(); ++i) std::cout << params[i] << (i == params.size() - 1 ? "" : ", ");
-    std::cout << "]" << std::endl;
-}
\ No newline at end of file
+    Record* record = new Record();
+    record->kind = RecordKind::Header;
+    record->names = paramNames;
+    enqueue(record, false);
+}
+
+void OptimizationLogger::logIteration(int iter, const std::vector<double>& params, double cost, const std::string& phases) {
+    Record* record = new Record();
+    record->kind = RecordKind::Iteration;
+    record->iter = iter;
+    record->values = params;
+    record->cost = cost;
+    record->phases = phases;
+    enqueue(record, false);
+}
+
+void OptimizationLogger::flush() {
+    std::promise<void> done;
+    std::future<void> future = done.get_future();
+    Record* record = new Record();
+    record->kind = RecordKind::Flush;
+    record->done = &done;
+    enqueue(record, true);
+    future.wait();
+}
+
+// =========================================================
+// 后台线程
+// =========================================================
+void OptimizationLogger::workerLoop() {
+    using Clock = std::chrono::steady_clock;
+    auto lastSync = Clock::now();
+    auto lastConsole = Clock::now() - std::chrono::milliseconds(m_options.consoleIntervalMs);
+    std::string buffer;
+    buffer.reserve(1 << 16);
+
+    // 控制台限速：间隔内只保留最近一条，间隔到达时输出并附带被折叠的条数
+    Record lastIteration;
+    bool hasPendingConsole = false;
+    int suppressed = 0;
+
+    while (true) {
+        bool stopping = m_stop.load(std::memory_order_acquire);
+        std::vector<std::promise<void>*> flushed;
+        bool wroteAny = false;
+
+        while (Record* record = pop()) {
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            if (record->kind == RecordKind::Flush) {
+                flushed.push_back(record->done);
+            }
+            else {
+                writeRecord(*record, buffer);
+                wroteAny = true;
+                if (record->kind == RecordKind::Iteration) {
+                    if (hasPendingConsole) suppressed++;
+                    lastIteration.iter = record->iter;
+                    lastIteration.cost = record->cost;
+                    lastIteration.values.swap(record->values);
+                    hasPendingConsole = true;
+                }
+            }
+            delete record;
+        }
+
+        if (m_file && !buffer.empty()) {
+            std::fwrite(buffer.data(), 1, buffer.size(), m_file);
+            std::fflush(m_file);
+            buffer.clear();
+        }
+
+        auto now = Clock::now();
+        if (m_file && wroteAny) {
+            if (m_options.fsyncPolicy == FsyncPolicy::EveryBatch ||
+                (m_options.fsyncPolicy == FsyncPolicy::Interval &&
+                    now - lastSync >= std::chrono::milliseconds(m_options.fsyncIntervalMs))) {
+                syncToDisk();
+                lastSync = now;
+            }
+        }
+
+        if (hasPendingConsole &&
+            (stopping || !flushed.empty() ||
+                now - lastConsole >= std::chrono::milliseconds(m_options.consoleIntervalMs))) {
+            printConsole(lastIteration, suppressed);
+            hasPendingConsole = false;
+            suppressed = 0;
+            lastConsole = now;
+        }
+
+        for (auto* done : flushed) done->set_value();
+
+        if (stopping && m_pending.load(std::memory_order_acquire) == 0) break;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleeping.store(true, std::memory_order_release);
+        if (!m_stop.load() && m_pending.load(std::memory_order_acquire) < m_options.wakeBatchSize) {
+            m_wakeCv.wait_for(lock, std::chrono::milliseconds(m_options.flushIntervalMs));
+        }
+        m_sleeping.store(false, std::memory_order_release);
+    }
+}
+
+void OptimizationLogger::writeRecord(const Record& record, std::string& buffer) {
+    std::ostringstream line;
+    if (record.kind == RecordKind::Header) {
+        // 如果文件为空，写入表头
+        if (!m_fileEmpty) return;
+        line << "Iteration,";
+        for (const auto& name : record.names) line << name << ",";
+        line << "Cost,Phases\n";
+    }
+    else {
+        line << record.iter << ",";
+        for (double p : record.values) line << std::fixed << std::setprecision(6) << p << ",";
+        line << record.cost << "," << record.phases << "\n";
+    }
+    buffer += line.str();
+    m_fileEmpty = false;
+}
+
+void OptimizationLogger::printConsole(const Record& record, int suppressed) {
+    std::ostringstream line;
+    line << "[Logger] Iter: " << record.iter << " | Cost: " << record.cost << " | Params: [";
+    for (size_t i = 0; i < record.values.size(); ++i) line << record.values[i] << (i == record.values.size() - 1 ? "" : ", ");
+    line << "]";
+    if (suppressed > 0) line << " (+" << suppressed << " more)";
+    line << "\n";
+    std::cout << line.str() << std::flush;
+}
+
+void OptimizationLogger::syncToDisk() {
+#ifdef _WIN32
+    _commit(_fileno(m_file));
+#else
+    fsync(fileno(m_file));
+#endif
+}
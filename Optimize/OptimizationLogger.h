@@ -2,21 +2,78 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <future>
 #include <mutex>
+#include <thread>
 
+// 异步日志：调用方只做一次无锁入队，文件/控制台 I/O 全部在后台线程完成
 class OptimizationLogger {
 public:
+    // fsync 策略：Never 只 fflush；EveryBatch 每批落盘；Interval 按时间间隔落盘
+    enum class FsyncPolicy { Never, EveryBatch, Interval };
+
+    struct Options {
+        FsyncPolicy fsyncPolicy = FsyncPolicy::Interval;
+        int fsyncIntervalMs = 5000;   // Interval 策略下的落盘间隔
+        int flushIntervalMs = 200;    // 后台线程最长休眠时间 (批量写入周期)
+        size_t wakeBatchSize = 64;    // 积压超过此数量时提前唤醒后台线程
+        int consoleIntervalMs = 1000; // 控制台输出限速 (0 = 不限速)
+    };
+
     OptimizationLogger(const std::string& filepath);
+    OptimizationLogger(const std::string& filepath, const Options& options);
     ~OptimizationLogger();
 
-    // 写入表头
+    // 写入表头 (仅当文件为空时生效)
     void writeHeader(const std::vector<std::string>& paramNames);
 
-    // 写入一次迭代结果
-    void logIteration(int iter, const std::vector<double>& params, double cost);
+    // 写入一次迭代结果 (phases 为阶段耗时摘要，写入最后一列)
+    void logIteration(int iter, const std::vector<double>& params, double cost, const std::string& phases = "");
+
+    // 阻塞直到此前入队的记录全部写入文件
+    void flush();
 
 private:
+    enum class RecordKind { Header, Iteration, Flush };
+
+    struct Record {
+        std::atomic<Record*> next{ nullptr };
+        RecordKind kind = RecordKind::Iteration;
+        int iter = 0;
+        double cost = 0.0;
+        std::vector<double> values;
+        std::vector<std::string> names;
+        std::string phases;
+        std::promise<void>* done = nullptr;
+    };
+
+    // ---- 无锁 MPSC 队列 (Vyukov 侵入式链表) ----
+    void push(Record* record);
+    Record* pop();
+
+    void enqueue(Record* record, bool wake);
+    void workerLoop();
+    void writeRecord(const Record& record, std::string& buffer);
+    void printConsole(const Record& record, int suppressed);
+    void syncToDisk();
+
     std::string m_filepath;
-    std::mutex m_mutex;
-};
\ No newline at end of file
+    Options m_options;
+    std::FILE* m_file = nullptr;
+    bool m_fileEmpty = true;
+
+    std::atomic<Record*> m_head;
+    Record* m_tail;
+    Record m_stub;
+    std::atomic<size_t> m_pending{ 0 };
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    std::atomic<bool> m_sleeping{ false };
+    std::atomic<bool> m_stop{ false };
+    std::thread m_worker;
+};
@@ -0,0 +1,508 @@
+// =========================================================================
+// 必须放在第一行，用于解决 Boost 与 C++17 的兼容性报错 (Error C4996)
+// =========================================================================
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+
+#include "OptimizerModes.h"
+#include "SensitivityScreening.h"
+#include "WarmStartPrior.h"
+#include <libcmaes/cmaes.h>
+#include <bayesopt/bayesopt.hpp>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+// Utils/OptimizerModes.cpp
+
+using namespace libcmaes;
+
+static OptimizationSummary summarize(const PatientEvaluator& evaluator, const std::string& stopReason) {
+    OptimizationSummary summary;
+    summary.bestCost = evaluator.bestCost();
+    summary.evaluations = evaluator.evaluations();
+    summary.wallSeconds = evaluator.elapsedSeconds();
+    summary.bestTrace = evaluator.bestTrace();
+    summary.phasePercentiles = evaluator.phaseStats().percentiles();
+    summary.stopReason = stopReason;
+    std::cout << ">>> [" << evaluator.patient().name << "] Stopped: " << stopReason << " | best " << summary.bestCost
+        << " after " << summary.evaluations << " evaluations, " << summary.wallSeconds / 3600.0 << " h" << std::endl;
+    return summary;
+}
+
+// 优化起点 (物理值)，同时作为被冻结参数的名义值
+static std::vector<double> nominalParams(const std::vector<ParameterSpec>& specs) {
+    std::vector<double> initialParamsPhysical = {
+        2.0e6,   // Aorta_E
+        0.5e5,   // Valve_E
+        2.0e6,   // AorticAnnulus_E
+        0.5e5,   // AortomitralCurtain_E
+        8.0e6    // LeftVentricular_E
+    };
+
+    std::vector<double> x0(specs.size(), 0.5);
+    for (size_t i = 0; i < specs.size() && i < initialParamsPhysical.size(); ++i) {
+        x0[i] = specs[i].toNormalized(initialParamsPhysical[i]);
+    }
+    return x0;
+}
+
+// 跨病人热启动 (可选)：用数据集中其他已完成病人的最优参数构造先验
+static bool loadWarmStartPrior(const PatientContext& patient, const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings, WarmStartPrior& prior)
+{
+    if (!settings.warmStart) return false;
+    std::vector<CalibrationRecord> records = WarmStart::collect(WarmStart::datasetRootOf(patient.outputDir), patient.name);
+    std::map<std::string, double> descriptors = WarmStart::readDescriptors(WarmStart::patientRootOf(patient.outputDir));
+    if (!WarmStart::build(records, patient.stentTypeStr, descriptors, specs, prior)) {
+        std::cout << ">>> [WarmStart] " << records.size() << " completed patient(s), not enough for a prior. Cold start." << std::endl;
+        return false;
+    }
+    WarmStart::print(patient.name, prior, specs);
+    return true;
+}
+
+// 保存本病人的标定结果，供后续病人热启动
+static void saveCalibration(const PatientEvaluator& evaluator) {
+    const auto& patient = evaluator.patient();
+    WarmStart::saveResult(patient.outputDir, patient.stentTypeStr, evaluator.specs(), evaluator.bestParams(),
+        evaluator.bestCost(), evaluator.evaluations());
+}
+
+// 参数筛选 (可选)：返回优化器实际搜索的子空间
+static ParameterSubspace prepareSubspace(PatientEvaluator& evaluator, const std::vector<double>& nominal,
+    const OptimizerSettings& settings)
+{
+    if (!settings.screenParameters || nominal.size() < 2) return ParameterSubspace::full(nominal);
+
+    const auto& patient = evaluator.patient();
+    std::string cachePath = patient.outputDir + "screening.csv";
+    ScreeningResult screening;
+    bool cached = MorrisScreening::load(cachePath, evaluator.specs(), screening);
+    if (settings.metrics) settings.metrics->cacheLookup(patient.name, "screening", cached);
+    if (cached) {
+        std::cout << ">>> [Screening] Reusing " << cachePath << std::endl;
+    }
+    else {
+        screening = MorrisScreening::run(evaluator, settings.screeningTrajectories);
+        MorrisScreening::save(cachePath, evaluator.specs(), screening);
+    }
+    ParameterSubspace subspace = MorrisScreening::select(screening, nominal, settings.inertThreshold, 2);
+    MorrisScreening::print(patient.name, screening, subspace);
+    return subspace;
+}
+
+// =========================================================
+// 贝叶斯优化适配器 (继承自 ContinuousModel)
+// =========================================================
+class BayesOptExecutor : public bayesopt::ContinuousModel {
+public:
+    BayesOptExecutor(size_t dim, const bayesopt::Parameters& params, PatientEvaluator& evaluator, const ParameterSubspace& subspace)
+        : bayesopt::ContinuousModel(dim, params), m_evaluator(evaluator), m_subspace(subspace) {}
+
+    // 热启动：初始设计的前若干个点取自跨病人先验 (归一化子空间)
+    void setPriorSamples(const std::vector<std::vector<double>>& samples) { m_priorSamples = samples; }
+
+    // 核心函数：贝叶斯优化器调用此函数来评估样本
+    double evaluateSample(const vectord& x) override {
+        // BayesOpt 应该配置为在 [0,1] 范围内搜索 (钳制在 PatientEvaluator 内完成)
+        std::vector<double> reduced(x.begin(), x.end());
+        std::vector<double> params = m_subspace.expand(reduced);
+        // 预测会失败的点不仿真：直接按失败处理 (以最差可行误差返回，代理模型的尺度不被惩罚值拉坏)
+        if (m_evaluator.feasibility().risky(params)) {
+            std::cout << "[BayesOpt] Skipped sample predicted to fail (risk "
+                << m_evaluator.feasibility().risk(params) << ")" << std::endl;
+            return m_evaluator.feasibility().constraintCost(1e9);
+        }
+        double error = m_evaluator.evaluate(params);
+        std::cout << "[BayesOpt] Iter " << m_evaluator.evaluations() << " | Error: " << error << std::endl;
+        return m_evaluator.feasibility().constraintCost(error);
+    }
+
+protected:
+    // 初始设计：bayesopt 按配置 (init_method / random_seed) 生成，有热启动先验时前若干个点替换为先验样本
+    // (边界框为 [0,1]，内部坐标即归一化参数)
+    void generateInitialPoints(matrixd& xPoints) override {
+        bayesopt::ContinuousModel::generateInitialPoints(xPoints);
+        const size_t n = xPoints.size1(), d = xPoints.size2();
+        for (size_t r = 0; r < n && r < m_priorSamples.size(); ++r) {
+            for (size_t c = 0; c < d; ++c) xPoints(r, c) = m_priorSamples[r][c];
+        }
+    }
+
+private:
+    PatientEvaluator& m_evaluator;
+    ParameterSubspace m_subspace;
+    std::vector<std::vector<double>> m_priorSamples;
+};
+
+// =========================================================
+// 功能模块 1: 手动单次仿真
+// =========================================================
+OptimizationSummary runManualSimulation(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings,
+    const std::vector<double>& manualPhysicalParams)
+{
+    std::cout << "\n--------------------------------------------------" << std::endl;
+    std::cout << "[Mode: Manual] Running Single Simulation for " << patient.name << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+
+    if (manualPhysicalParams.size() != specs.size()) {
+        std::cerr << "Error: Manual parameters count mismatch!" << std::endl;
+        return OptimizationSummary();
+    }
+
+    // 打印参数确认
+    std::cout << "Parameters:" << std::endl;
+    std::vector<double> normParams;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        std::cout << "  " << specs[i].name << ": " << manualPhysicalParams[i] << std::endl;
+        // 归一化
+        normParams.push_back(specs[i].toNormalized(manualPhysicalParams[i]));
+    }
+
+    // 调用 Worker (结果如果够好会自动保存到 best_output)
+    PatientEvaluator evaluator(patient, specs, settings, "manual_log.csv");
+    double error = evaluator.evaluate(normParams);
+
+    std::cout << ">>> [Manual Result] Error: " << error << std::endl;
+    evaluator.phaseStats().printSummary(patient.name);
+    return summarize(evaluator, "single run");
+}
+
+// 单次 CMA-ES 运行 (一个种群，从 plan 给定的起点/步长/种群大小出发)，返回消耗的评估次数
+// 病人级停止规则由 monitor 判定 (所有种群共享)，sigma/误差容差只结束本次运行
+// stagnationPerGeneration = false 时停滞规则留给调用方在两次运行之间判定 (停滞以全局最优为参照，
+// 重启后的新运行通常要很多代才能追上，逐代判定会在第一次重启中就结束整个病人)
+static int runCMAESInstance(PatientEvaluator& evaluator, const ParameterSubspace& subspace,
+    const RestartPlan& plan, int maxGenerations, int evalBudget, const StoppingRules& rules, StopMonitor& monitor,
+    bool stagnationPerGeneration, const std::string& tag)
+{
+    const std::string& patientName = evaluator.patient().name;
+    int dim = subspace.dim();
+
+    // 目标函数：整代候选解先由 evaluateBatch 并发评估，
+    // libcmaes 再按候选顺序逐个回调 (mt_feval 关闭)，这里按序取回结果
+    std::vector<double> batchCosts;
+    size_t batchCursor = 0;
+    FitFunc fitnessFunc = [&](const double*, const int) {
+        return batchCursor < batchCosts.size() ? batchCosts[batchCursor++] : 1e9;
+    };
+
+    // 各维步长不同 (热启动先验) 时在缩放坐标 y = x / scale 中搜索：
+    // 等价于以 sigma * scale_i 为各维初始步长，且边界仍是轴对齐的盒子 [0, 1/scale_i]
+    std::vector<double> scales = plan.scales.empty() ? std::vector<double>(dim, 1.0) : plan.scales;
+    std::vector<double> lb(dim, 0.0), ub(dim), y0(dim);
+    for (int i = 0; i < dim; ++i) {
+        ub[i] = 1.0 / scales[i];
+        y0[i] = plan.x0[i] / scales[i];
+    }
+    GenoPheno<pwqBoundStrategy> gp(lb.data(), ub.data(), dim);
+    CMAParameters<GenoPheno<pwqBoundStrategy>> cmaparams(y0, plan.sigma, plan.lambda, 0, gp);
+    cmaparams.set_max_iter(maxGenerations);
+    if (rules.costTolerance > 0.0) cmaparams.set_ftolerance(rules.costTolerance);
+    if (rules.sigmaTolerance > 0.0) cmaparams.set_xtolerance(rules.sigmaTolerance);
+
+    ESOptimizer<CMAStrategy<CovarianceUpdate, GenoPheno<pwqBoundStrategy>>,
+        CMAParameters<GenoPheno<pwqBoundStrategy>>>
+        optim(fitnessFunc, cmaparams);
+
+    std::cout << ">>> [" << patientName << "|" << tag << "] Start: lambda " << plan.lambda << ", sigma " << plan.sigma
+        << (plan.scales.empty() ? "" : " (per-dimension, warm start)")
+        << (plan.largeRegime ? "" : " (small regime)") << std::endl;
+
+    int currentGen = 0;
+    int used = 0;
+    while (!optim.stop() && evaluator.evaluations() < evalBudget && !monitor.stopped()) {
+        dMat candidates = optim.ask();
+
+        // 候选解转换到表现型空间 (pwqBound 映射回边界内)，还原缩放后再补全冻结参数
+        const auto& genoPheno = optim.get_parameters().get_gp();
+        auto toParams = [&](const dVec& genotype) {
+            dVec pheno = genoPheno.pheno(genotype);
+            std::vector<double> x(dim);
+            for (int i = 0; i < dim; ++i) x[i] = pheno(i) * scales[i];
+            return subspace.expand(x);
+        };
+        // 高风险候选点不派发，按失败处理 (constraintCost 给出最差可行误差) 直接参与排序。
+        // 候选解本身保持不变：若把它们替换为向均值收缩后的点，选择出的步长会系统性偏小，CSA 使 sigma 塌缩
+        std::vector<std::vector<double>> batch;
+        std::vector<int> dispatched;
+        const FeasibilityModel& feasibility = evaluator.feasibility();
+        for (int c = 0; c < candidates.cols(); ++c) {
+            std::vector<double> params = toParams(candidates.col(c));
+            if (feasibility.risky(params)) continue;
+            batch.push_back(params);
+            dispatched.push_back(c);
+        }
+        int skipped = (int)candidates.cols() - (int)batch.size();
+        if (skipped > 0) {
+            std::cout << ">>> [" << patientName << "|" << tag << "] Skipped " << skipped
+                << " candidate(s) predicted to fail" << std::endl;
+        }
+        std::vector<double> costs = evaluator.evaluateBatch(batch);
+        // 失败按约束处理：以最差可行误差参与排序，避免 1e9 量级的惩罚值扭曲步长自适应
+        batchCosts.assign(candidates.cols(), feasibility.constraintCost(1e9));
+        for (size_t i = 0; i < dispatched.size(); ++i) batchCosts[dispatched[i]] = feasibility.constraintCost(costs[i]);
+        batchCursor = 0;
+        used += (int)batch.size();
+
+        optim.eval(candidates);
+        optim.tell();
+        optim.inc_iter();
+
+        currentGen++;
+        std::cout << ">>> [" << patientName << "|" << tag << "] Generation " << currentGen << "/" << maxGenerations << " Done. Best: "
+            << optim.get_solutions().best_candidate().get_fvalue() << " | Global: " << evaluator.bestCost() << std::endl;
+
+        // 每 10 代输出一次阶段耗时分布
+        if (currentGen % 10 == 0) evaluator.phaseStats().printSummary(patientName);
+
+        if (monitor.check(evaluator.evaluations(), evaluator.bestCost(), evaluator.elapsedSeconds(), stagnationPerGeneration)) break;
+        if (currentGen >= maxGenerations) break;
+    }
+    std::cout << ">>> [" << patientName << "|" << tag << "] Finished after " << currentGen << " generations (status "
+        << optim.get_solutions().run_status() << ")" << std::endl;
+    return used;
+}
+
+// =========================================================
+// 功能模块 2: CMA-ES 优化
+// =========================================================
+OptimizationSummary runCMAESOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings)
+{
+    std::cout << "\n--------------------------------------------------" << std::endl;
+    std::cout << "[Mode: Optimization] Starting CMA-ES for " << patient.name << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+
+    PatientEvaluator evaluator(patient, specs, settings, "cmaes_log.csv");
+
+    // 起点与 (可选的) 参数筛选：CMA-ES 只在活跃维度上搜索，种群大小随维度减小
+    // 有热启动先验时以先验均值为起点 (同时作为冻结参数的取值)，否则使用 nominalParams 中的物理参数
+    WarmStartPrior prior;
+    bool warm = loadWarmStartPrior(patient, specs, settings, prior);
+    std::vector<double> nominal = warm ? prior.mean : nominalParams(specs);
+    ParameterSubspace subspace = prepareSubspace(evaluator, nominal, settings);
+    int dim = subspace.dim();
+
+    std::vector<double> x0 = subspace.reduce(nominal);
+    double sigma = 0.2;
+
+    // 评估预算与原先单次运行相同 (maxGenerations 代 * 默认种群)，由所有种群与重启共享
+    int lambda0 = RestartScheduler::defaultLambda(dim);
+    int evalBudget = evaluator.evaluations() + settings.maxGenerations * lambda0;
+    int populations = std::max(1, settings.cmaesPopulations);
+    int maxRuns = settings.restartStrategy == RestartStrategy::None ? populations : 1 + settings.maxRestarts;
+    RestartScheduler scheduler(settings.restartStrategy, dim, x0, sigma, maxRuns);
+    if (warm) {
+        // 首次运行的各维步长取先验标准差 (协方差的相关部分只用于 BayesOpt 的先验抽样)
+        std::vector<double> scales = subspace.reduce(prior.stddev());
+        for (auto& v : scales) v /= sigma;
+        scheduler.setInitialScales(scales);
+    }
+
+    if (settings.restartStrategy != RestartStrategy::None || populations > 1) {
+        std::cout << ">>> Restart strategy: " << RestartScheduler::name(settings.restartStrategy) << " | populations: " << populations
+            << " | budget: " << settings.maxGenerations * lambda0 << " evaluations" << std::endl;
+    }
+
+    // 每个种群线程依次领取 (重启) 配置，直到预算、重启次数用完或触发停止规则；
+    // 并发的种群共享同一个 PatientEvaluator，即共享 Worker 槽位、日志与全局最优
+    // 有重启策略时停滞规则只在运行之间判定：某次运行结束时若最近 stagnationEvaluations 次评估都没有改进全局最优，
+    // 不再发起新的重启
+    StopMonitor monitor(settings.stopping);
+    bool restarting = settings.restartStrategy != RestartStrategy::None;
+    std::atomic<int> runs{ 0 };
+    auto populationLoop = [&](int popId) {
+        RestartPlan plan;
+        while (evaluator.evaluations() < evalBudget && !monitor.stopped() && scheduler.next(plan)) {
+            std::string tag = "pop" + std::to_string(popId) + "/run" + std::to_string(plan.index);
+            int used = runCMAESInstance(evaluator, subspace, plan, settings.maxGenerations, evalBudget,
+                settings.stopping, monitor, !restarting, tag);
+            scheduler.report(plan, used);
+            runs++;
+            if (restarting) monitor.check(evaluator.evaluations(), evaluator.bestCost(), evaluator.elapsedSeconds());
+        }
+    };
+
+    if (populations == 1) {
+        populationLoop(0);
+    }
+    else {
+        std::vector<std::thread> threads;
+        for (int p = 0; p < populations; ++p) threads.emplace_back(populationLoop, p);
+        for (auto& th : threads) th.join();
+    }
+    if (evaluator.evaluations() >= evalBudget) {
+        monitor.finish("generation budget (" + std::to_string(settings.maxGenerations) + " x lambda " + std::to_string(lambda0) + ") exhausted");
+    }
+    else {
+        monitor.finish("all " + std::to_string(runs.load()) + " CMA-ES run(s) finished (restarts exhausted)");
+    }
+    evaluator.phaseStats().printSummary(patient.name);
+    saveCalibration(evaluator);
+    return summarize(evaluator, monitor.reason());
+}
+
+// =========================================================
+// 功能模块 3: 贝叶斯优化 (Bayesian Optimization)
+// =========================================================
+OptimizationSummary runBayesOptOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings)
+{
+    std::cout << "\n--------------------------------------------------" << std::endl;
+    std::cout << "[Mode: BayesOpt] Starting Bayesian Optimization for " << patient.name << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+
+    // 热启动先验与参数筛选 (均可选)：BayesOpt 只在活跃维度上建模
+    PatientEvaluator evaluator(patient, specs, settings, "bayesopt_log.csv");
+    WarmStartPrior prior;
+    bool warm = loadWarmStartPrior(patient, specs, settings, prior);
+    ParameterSubspace subspace = prepareSubspace(evaluator, warm ? prior.mean : nominalParams(specs), settings);
+    int dim = subspace.dim();
+
+    // 1. 配置贝叶斯优化参数
+    bayesopt::Parameters boptParams = initialize_parameters_to_default();
+
+    // 关键设置
+    boptParams.n_iterations = settings.maxGenerations; // 总迭代次数
+    boptParams.surr_name = "sGaussianProcess"; // 代理模型：高斯过程
+
+    // 2. 实例化执行器
+    BayesOptExecutor opt(dim, boptParams, evaluator, subspace);
+    if (warm) {
+        // 一半初始设计点取先验 (先验均值 + 抽样)，其余保持空间填充设计以保留全局探索
+        std::vector<std::vector<double>> samples = prior.sample((int)boptParams.n_init_samples / 2, 2024);
+        if (!samples.empty()) samples[0] = prior.mean;
+        for (auto& x : samples) x = subspace.reduce(x);
+        opt.setPriorSamples(samples);
+    }
+
+    // 3. 设置边界 [0, 1]
+    // 因为 SimWorker 接收的是归一化参数，所以我们让 BayesOpt 也在 [0, 1] 空间内搜索
+    vectord lowerBound(dim), upperBound(dim);
+    for (int i = 0; i < dim; ++i) {
+        lowerBound[i] = 0.0;
+        upperBound[i] = 1.0;
+    }
+    opt.setBoundingBox(lowerBound, upperBound);
+
+    // 4. 运行优化：逐步迭代，每步之前检查停止规则
+    std::cout << ">>> BayesOpt Started. Max Iterations: " << settings.maxGenerations << std::endl;
+
+    StopMonitor monitor(settings.stopping);
+    vectord bestParamsNormalized(dim);
+    try {
+        opt.initializeOptimization();
+        for (size_t iter = 0; iter < boptParams.n_iterations; ++iter) {
+            if (monitor.check(evaluator.evaluations(), evaluator.bestCost(), evaluator.elapsedSeconds())) break;
+            opt.stepOptimization();
+        }
+        monitor.finish("iteration budget (" + std::to_string(boptParams.n_iterations) + ") exhausted");
+        bestParamsNormalized = opt.getFinalResult();
+    }
+    catch (std::exception& e) {
+        std::cerr << "[BayesOpt Error] " << e.what() << std::endl;
+        monitor.finish(std::string("error: ") + e.what());
+        evaluator.phaseStats().printSummary(patient.name);
+        saveCalibration(evaluator);
+        return summarize(evaluator, monitor.reason());
+    }
+    evaluator.phaseStats().printSummary(patient.name);
+    saveCalibration(evaluator);
+
+    // 5. 输出最终结果
+    std::cout << "\n>>> Optimization Finished for " << patient.name << std::endl;
+    std::cout << "Best Parameters found (Physical):" << std::endl;
+    std::vector<double> bestFull = subspace.expand(std::vector<double>(bestParamsNormalized.begin(), bestParamsNormalized.end()));
+    for (size_t i = 0; i < specs.size(); ++i) {
+        double p = specs[i].toPhysical(bestFull[i]);
+        std::cout << "  " << specs[i].name << ": " << p << std::endl;
+    }
+    return summarize(evaluator, monitor.reason());
+}
+
+// =========================================================
+// 功能模块 4: 信赖域贝叶斯优化 (TuRBO 风格)
+// =========================================================
+OptimizationSummary runTrustRegionBOOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings)
+{
+    std::cout << "\n--------------------------------------------------" << std::endl;
+    std::cout << "[Mode: TrustRegionBO] Starting trust-region Bayesian Optimization for " << patient.name << std::endl;
+    std::cout << "--------------------------------------------------" << std::endl;
+
+    // 热启动先验与参数筛选 (均可选)，与 BayesOpt 模式相同
+    PatientEvaluator evaluator(patient, specs, settings, "turbo_log.csv");
+    WarmStartPrior prior;
+    bool warm = loadWarmStartPrior(patient, specs, settings, prior);
+    ParameterSubspace subspace = prepareSubspace(evaluator, warm ? prior.mean : nominalParams(specs), settings);
+    int dim = subspace.dim();
+
+    TrustRegionBO bo(dim, settings.trustRegion);
+    if (warm) {
+        // 一半初始设计点取先验 (先验均值 + 抽样)，其余为拉丁超立方
+        int initial = settings.trustRegion.initialSamples > 0 ? settings.trustRegion.initialSamples : std::max(4, 2 * dim);
+        std::vector<std::vector<double>> samples = prior.sample(std::max(1, initial / 2), 2024);
+        if (!samples.empty()) samples[0] = prior.mean;
+        for (auto& x : samples) x = subspace.reduce(x);
+        bo.setInitialPoints(samples);
+    }
+
+    // 每轮按 Worker 槽位数成批建议，建议总数 (含跳过的高风险点) 与 BayesOpt 的迭代次数相同
+    const int batchSize = std::max(1, evaluator.concurrency());
+    const int budget = settings.maxGenerations;
+    std::cout << ">>> TrustRegionBO Started. Max Iterations: " << budget << " | batch: " << batchSize << std::endl;
+
+    StopMonitor monitor(settings.stopping);
+    const FeasibilityModel& feasibility = evaluator.feasibility();
+    int proposed = 0, round = 0;
+    while (proposed < budget) {
+        if (monitor.check(evaluator.evaluations(), evaluator.bestCost(), evaluator.elapsedSeconds())) break;
+        std::vector<std::vector<double>> points = bo.ask(std::min(batchSize, budget - proposed));
+        proposed += (int)points.size();
+
+        // 预测会失败的点不仿真：直接按失败处理 (以最差可行误差计入模型)
+        std::vector<double> costs(points.size());
+        std::vector<std::vector<double>> batch;
+        std::vector<size_t> batchIndex;
+        int skipped = 0;
+        for (size_t k = 0; k < points.size(); ++k) {
+            std::vector<double> params = subspace.expand(points[k]);
+            if (feasibility.risky(params)) {
+                costs[k] = feasibility.constraintCost(1e9);
+                skipped++;
+                continue;
+            }
+            batch.push_back(params);
+            batchIndex.push_back(k);
+        }
+        std::vector<double> results = evaluator.evaluateBatch(batch);
+        for (size_t b = 0; b < batchIndex.size(); ++b) costs[batchIndex[b]] = feasibility.constraintCost(results[b]);
+        bo.tell(points, costs);
+
+        round++;
+        std::cout << "[TrustRegionBO] Round " << round << " | evals " << evaluator.evaluations() << " | Best: " << evaluator.bestCost()
+            << " | length " << bo.length() << " | local GP " << bo.localPoints() << " pts | restarts " << bo.restarts()
+            << " | suggest " << bo.lastSuggestMs() << " ms";
+        if (skipped > 0) std::cout << " | skipped " << skipped << " predicted to fail";
+        std::cout << std::endl;
+
+        if (round % 10 == 0) evaluator.phaseStats().printSummary(patient.name);
+    }
+    monitor.finish("iteration budget (" + std::to_string(budget) + ") exhausted");
+    evaluator.phaseStats().printSummary(patient.name);
+    saveCalibration(evaluator);
+
+    std::cout << "\n>>> Optimization Finished for " << patient.name << std::endl;
+    std::cout << "Best Parameters found (Physical):" << std::endl;
+    std::vector<double> bestFull = evaluator.bestParams();
+    for (size_t i = 0; i < specs.size() && i < bestFull.size(); ++i) {
+        std::cout << "  " << specs[i].name << ": " << specs[i].toPhysical(bestFull[i]) << std::endl;
+    }
+    return summarize(evaluator, monitor.reason());
+}
@@ -0,0 +1,39 @@
+// Utils/OptimizerModes.h
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <map>
+#include "Common.h"
+#include "PatientEvaluator.h"
+
+// 单个病人一次优化的汇总 (供主程序与基准测试使用)
+struct OptimizationSummary {
+    double bestCost = 1e9;
+    int evaluations = 0;
+    double wallSeconds = 0.0;
+    std::vector<std::pair<double, double>> bestTrace; // (秒, 最优误差)
+    std::map<std::string, std::pair<double, double>> phasePercentiles; // 阶段 -> (p50, p95) ms
+    std::string stopReason;
+};
+
+// 功能模块 1: 手动单次仿真
+OptimizationSummary runManualSimulation(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings,
+    const std::vector<double>& manualPhysicalParams);
+
+// 功能模块 2: CMA-ES 优化
+OptimizationSummary runCMAESOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings);
+
+// 功能模块 3: 贝叶斯优化 (Bayesian Optimization)
+OptimizationSummary runBayesOptOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings);
+
+// 功能模块 4: 信赖域贝叶斯优化 (TuRBO 风格的局部 GP，适合评估次数多的长时间运行)
+OptimizationSummary runTrustRegionBOOptimization(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings);
@@ -3,8 +3,6 @@
 // =========================================================================
 #define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
 
-#include <libcmaes/cmaes.h>
-#include <bayesopt/bayesopt.hpp>
 #include <iostream>
 #include <vector>
 #include <memory>
@@ -13,13 +11,11 @@
 #include <cstdlib>
 #include <filesystem> 
 #include <fstream> 
-#include "Utils/ProcessUtils.h"
-#include "Utils/OptimizationLogger.h"
+#include "Utils/OptimizerModes.h"
 #include "Common.h"
 #include "Utils/PathUtils.h"
 
 // 使用命名空间
-using namespace libcmaes;
 namespace fs = std::filesystem;
 
 // =========================================================
@@ -28,11 +24,13 @@ namespace fs = std::filesystem;
 enum class RunMode {
     ManualSingleRun,    // 模式1: 手动设置参数跑一次 (用于测试/验证)
     CmaesOptimization,   // 模式2: 自动 CMA-ES 优化 (用于寻找最优解)
-	BayesOptOptimization  // 模式3: 自动贝叶斯优化
+	BayesOptOptimization,  // 模式3: 自动贝叶斯优化
+	TrustRegionBOOptimization  // 模式4: 信赖域贝叶斯优化 (局部 GP，迭代开销不随评估次数增长，适合长时间运行)
 };
 
 // 【在此处切换功能】
 //const RunMode CURRENT_MODE = RunMode::BayesOptOptimization;
+//const RunMode CURRENT_MODE = RunMode::TrustRegionBOOptimization;
 const RunMode CURRENT_MODE = RunMode::CmaesOptimization;
 //const RunMode CURRENT_MODE = RunMode::ManualSingleRun;
 
@@ -52,122 +50,107 @@ std::string readStentType(const std::string& configPath) {
     return type.empty() ? "VenusA_L26" : type;
 }
 
-// 路径修复 (用于 Windows 命令)
-std::string fixPath(std::string p) {
-    for (char& c : p) if (c == '/') c = '\\';
-    return p;
-}
-
-// 保存最佳结果到 best_output 文件夹
-void saveBestOutput(const std::string& outputDir) {
-    std::cout << "  >>> [Saving] Copying current output to 'best_output'..." << std::endl;
-
-    std::string srcDir = outputDir + "output";
-    std::string dstDir = outputDir + "best_output";
-    std::string regStlFile = outputDir + "registered_target.stl";
-
-    std::string cmdDel = "rmdir /S /Q \"" + fixPath(dstDir) + "\" >nul 2>&1";
-    system(cmdDel.c_str());
-
-    std::string cmdCopyDir = "xcopy \"" + fixPath(srcDir) + "\" \"" + fixPath(dstDir) + "\" /E /I /Y /Q >nul 2>&1";
-    system(cmdCopyDir.c_str());
-
-    std::string cmdCopyFile = "copy \"" + fixPath(regStlFile) + "\" \"" + fixPath(dstDir) + "\" /Y >nul 2>&1";
-    system(cmdCopyFile.c_str());
-}
-
 // =========================================================
-// 贝叶斯优化适配器 (继承自 ContinuousModel)
+// 主函数
 // =========================================================
-class BayesOptExecutor : public bayesopt::ContinuousModel {
-public:
-    BayesOptExecutor(
-        size_t dim,
-        const bayesopt::Parameters& params,
-        const std::string& workerExe,
-        const std::string& meshDir,
-        const std::string& outputDir,
-        const std::string& stentTypeStr,
-        const std::vector<ParameterSpec>& specs,
-        int timeoutMs
-    )
-        : bayesopt::ContinuousModel(dim, params),
-        m_workerExe(workerExe), m_meshDir(meshDir), m_outputDir(outputDir),
-        m_stentTypeStr(stentTypeStr), m_specs(specs), m_timeoutMs(timeoutMs),
-        m_globalBestError(1e9), m_iterCount(0)
-    {
-        // 初始化日志
-        std::string logPath = outputDir + "bayesopt_log.csv";
-        m_logger = std::make_unique<OptimizationLogger>(logPath);
-        std::vector<std::string> names;
-        for (const auto& s : m_specs) names.push_back(s.name);
-        m_logger->writeHeader(names);
-    }
-
-    // 核心函数：贝叶斯优化器调用此函数来评估样本
-    double evaluateSample(const vectord& x) override {
-        m_iterCount++;
+int main() {
+    SetConsoleTitleA("Optimizer - Batch Manager");
+    system("chcp 65001>nul");
 
-        // 1. 转换参数格式 (vectord -> vector<double>)
-        // BayesOpt 应该配置为在 [0,1] 范围内搜索
-        std::vector<double> params(x.size());
-        for (size_t i = 0; i < x.size(); ++i) {
-            params[i] = std::max(0.0, std::min(1.0, x[i])); // 强制钳制
-        }
+    // [修改] 动态生成数据根目录
+    // 假设数据放在 EXE 同级目录下的 data/patient/
+    std::string exeDir = PathUtils::getExeDir();
+    const std::string DATASET_ROOT = exeDir + "data/patient/";
 
-        // 2. 调用子进程 SimWorker
-        double error = ProcessUtils::runWorker(m_workerExe, m_meshDir, m_outputDir, m_stentTypeStr, params, m_timeoutMs);
+    // WORKER_EXE 也可以写成绝对路径以防万一
+    const std::string WORKER_EXE = exeDir + "SimWorker.exe";
 
-        // 3. 记录日志 (计算物理值用于显示)
-        std::vector<double> realParams;
-        for (size_t i = 0; i < m_specs.size(); ++i) {
-            realParams.push_back(m_specs[i].minVal + params[i] * (m_specs[i].maxVal - m_specs[i].minVal));
-        }
-        m_logger->logIteration(m_iterCount, realParams, error);
+    const int TIMEOUT_MS = 900000; // 冷启动超时：积累运行时间样本后改为按预测分位数自适应 (settings.adaptiveTimeout)
+    const int MAX_GENERATIONS = 1000;
 
-        std::cout << "[BayesOpt] Iter " << m_iterCount << " | Error: " << error << std::endl;
+    // 同时运行的 SimWorker 数量 (CMA-ES 一代内并发评估，每次评估使用独立输出目录)
+    const int CONCURRENCY = 1;
+
+    // 分布式模式：> 0 时在该端口等待计算节点上的 SimAgent 注册，评估全部派发给 Agent
+    // (各节点需有自己的 data/patient/ 副本，病人目录名与本机一致)
+    const int DISTRIBUTED_PORT = 0;
+    const int MIN_AGENTS = 1;
+
+    // 优化前对每个病人做 Morris 参数筛选，不敏感的参数冻结在起点值 (结果缓存在 output/screening.csv)
+    // 默认关闭：筛选本身要额外评估，且被冻结的参数不再参与优化，需按病人确认后再启用
+    const bool SCREEN_PARAMETERS = false;
+
+    // CMA-ES 重启策略：陷入局部最优后用更大 (IPOP) 或大/小交替 (BIPOP) 的种群从随机起点重启
+    // 默认 None (单次运行)：重启会成倍增加评估次数，需要时再启用
+    // CMAES_POPULATIONS > 1 时多个种群同时运行 (配合 CONCURRENCY 使用)
+    const RestartStrategy RESTART_STRATEGY = RestartStrategy::None;
+    const int CMAES_POPULATIONS = 1;
+
+    // 跨病人热启动：已完成病人 (output/calibration_result.csv 或旧的优化日志) 不少于 3 个时，
+    // 用它们的最优参数构造先验作为新病人的起点；病人目录下可放 descriptors.txt ("名称 数值" 每行一个) 用于相似度加权
+    const bool WARM_START = true;
+
+    // 停止规则 (0 表示不启用)：最优值停滞、单次 CMA-ES 运行的步长/误差容差、每个病人的评估次数与时间预算
+    // 每个病人结束时输出停止原因
+    const int STAGNATION_EVALUATIONS = 200;      // 连续 200 次评估最优值相对改进不超过 0.1% 即停止 (有重启策略时只在两次运行之间判定)
+    const double STAGNATION_TOLERANCE = 1e-3;
+    const double SIGMA_TOLERANCE = 1e-4;         // 归一化参数空间
+    const double COST_TOLERANCE = 1e-6;
+    const int MAX_EVALUATIONS = 0;
+    const double MAX_HOURS = 72.0;
+
+    // 运行指标 (评估数/失败/超时、延迟直方图、槽位利用率、排队数、各病人最优误差、参数筛选与目标 LOD 缓存的命中率)
+    // 以 Prometheus 文本格式每 15 秒写入 EXE 目录下的 metrics.prom；METRICS_PORT > 0 时同时在 /metrics 上提供
+    const bool EXPORT_METRICS = true;
+    const int METRICS_PORT = 0;
+
+    // 本机评估经由每个病人一个常驻的 SimWorker Zygote (预加载网格/支架/目标，每次评估 fork)，仅 POSIX 平台生效
+    const bool USE_ZYGOTE = true;
+
+    // 本机 Worker 槽位的 CPU 布局：Compact (每槽位独占连续物理核) / NumaSpread (槽位不跨 NUMA 节点) / Unpinned (只限线程数)
+    // THREADS_PER_WORKER = 0 时按 物理核数 / CONCURRENCY 均分
+    const WorkerLayout WORKER_LAYOUT = WorkerLayout::Compact;
+    const int THREADS_PER_WORKER = 0;
+
+    OptimizerSettings settings;
+    settings.workerExe = WORKER_EXE;
+    settings.timeoutMs = TIMEOUT_MS;
+    settings.maxGenerations = MAX_GENERATIONS;
+    settings.concurrency = CONCURRENCY;
+    settings.zygote = USE_ZYGOTE;
+    settings.cpuLayout.layout = WORKER_LAYOUT;
+    settings.cpuLayout.threadsPerWorker = THREADS_PER_WORKER;
+    settings.screenParameters = SCREEN_PARAMETERS;
+    settings.restartStrategy = RESTART_STRATEGY;
+    settings.cmaesPopulations = CMAES_POPULATIONS;
+    settings.warmStart = WARM_START;
+    settings.stopping.stagnationEvaluations = STAGNATION_EVALUATIONS;
+    settings.stopping.stagnationTolerance = STAGNATION_TOLERANCE;
+    settings.stopping.sigmaTolerance = SIGMA_TOLERANCE;
+    settings.stopping.costTolerance = COST_TOLERANCE;
+    settings.stopping.maxEvaluations = MAX_EVALUATIONS;
+    settings.stopping.maxHours = MAX_HOURS;
+
+    if (EXPORT_METRICS) {
+        MetricsExporter::Options metricsOptions;
+        metricsOptions.filePath = exeDir + "metrics.prom";
+        metricsOptions.httpPort = METRICS_PORT;
+        settings.metrics = std::make_shared<MetricsExporter>();
+        if (!settings.metrics->start(metricsOptions)) settings.metrics.reset();
+    }
 
-        // 4. 保存最佳结果 (与 CMA-ES 逻辑一致)
-        if (error < m_globalBestError && error < 1e5) {
-            m_globalBestError = error;
-            std::cout << "  >>> [New Best] Found error: " << error << ". Saving best_output..." << std::endl;
-            saveBestOutput(m_outputDir);
+    if (DISTRIBUTED_PORT > 0) {
+        settings.coordinator = std::make_shared<DistributedCoordinator>();
+        if (settings.coordinator->start(DISTRIBUTED_PORT) < 0) {
+            getchar();
+            return -1;
         }
-
-        return error;
+        std::cout << "[Coordinator] Waiting for " << MIN_AGENTS << " agent(s)..." << std::endl;
+        settings.coordinator->waitForAgents(MIN_AGENTS, -1);
     }
 
-private:
-    std::string m_workerExe;
-    std::string m_meshDir;
-    std::string m_outputDir;
-    std::string m_stentTypeStr;
-    std::vector<ParameterSpec> m_specs;
-    int m_timeoutMs;
-
-    std::unique_ptr<OptimizationLogger> m_logger;
-    double m_globalBestError;
-    int m_iterCount;
-};
-
-// =========================================================
-// 功能模块 1: 手动单次仿真
-// =========================================================
-void runManualSimulation(
-    const std::string& patientName,
-    const std::string& WORKER_EXE,
-    const std::string& meshDir,
-    const std::string& outputDir,
-    const std::string& stentTypeStr,
-    const std::vector<ParameterSpec>& specs,
-    int TIMEOUT_MS
-) {
-    std::cout << "\n--------------------------------------------------" << std::endl;
-    std::cout << "[Mode: Manual] Running Single Simulation for " << patientName << std::endl;
-    std::cout << "--------------------------------------------------" << std::endl;
-
-    // 1. 设置手动物理参数 (在此处修改你要测试的值)
-    std::vector<double> manualPhysicalParams = {
+    // 手动模式的物理参数 (在此处修改你要测试的值)
+    const std::vector<double> MANUAL_PHYSICAL_PARAMS = {
         //2.0e6,   // Aorta_E
         //0.5e5,   // Valve_E
         //2.0e6,   // AorticAnnulus_E
@@ -175,212 +158,12 @@ void runManualSimulation(
         //8.0e6    // LeftVentricular_E
 
         2.98221e+06,
-        2.42607e+06, 
-        100000, 
-        20000, 
+        2.42607e+06,
+        100000,
+        20000,
         197715
     };
 
-    if (manualPhysicalParams.size() != specs.size()) {
-        std::cerr << "Error: Manual parameters count mismatch!" << std::endl;
-        return;
-    }
-
-    // 2. 打印参数确认
-    std::cout << "Parameters:" << std::endl;
-    std::vector<double> normParams;
-    for (size_t i = 0; i < specs.size(); ++i) {
-        std::cout << "  " << specs[i].name << ": " << manualPhysicalParams[i] << std::endl;
-        // 归一化
-        double norm = (manualPhysicalParams[i] - specs[i].minVal) / (specs[i].maxVal - specs[i].minVal);
-        normParams.push_back(std::max(0.0, std::min(1.0, norm)));
-    }
-
-    // 3. 调用 Worker
-    double error = ProcessUtils::runWorker(WORKER_EXE, meshDir, outputDir, stentTypeStr, normParams, TIMEOUT_MS);
-
-    std::cout << ">>> [Manual Result] Error: " << error << std::endl;
-
-    // (可选) 如果手动跑的结果你觉得很好，也可以强制保存
-    // saveBestOutput(outputDir);
-}
-
-// =========================================================
-// 功能模块 2: CMA-ES 优化
-// =========================================================
-void runCMAESOptimization(
-    const std::string& patientName,
-    const std::string& WORKER_EXE,
-    const std::string& meshDir,
-    const std::string& outputDir,
-    const std::string& stentTypeStr,
-    const std::vector<ParameterSpec>& specs,
-    int TIMEOUT_MS,
-    int MAX_GENERATIONS
-) {
-    std::cout << "\n--------------------------------------------------" << std::endl;
-    std::cout << "[Mode: Optimization] Starting CMA-ES for " << patientName << std::endl;
-    std::cout << "--------------------------------------------------" << std::endl;
-
-    int dim = (int)specs.size();
-
-    // 1. 初始化日志
-    std::string logPath = outputDir + "cmaes_log.csv";
-    auto logger = std::make_unique<OptimizationLogger>(logPath);
-    std::vector<std::string> names;
-    for (auto& s : specs) names.push_back(s.name);
-    logger->writeHeader(names);
-
-    double globalBestError = 1e9;
-    int iterCount = 0;
-
-    // 2. 定义目标函数
-    FitFunc fitnessFunc = [&](const double* x, const int N) {
-        iterCount++;
-        std::vector<double> params(x, x + N);
-        // 边界钳制
-        for (auto& v : params) v = std::max(0.0, std::min(1.0, v));
-
-        // 调用子进程
-        double error = ProcessUtils::runWorker(WORKER_EXE, meshDir, outputDir, stentTypeStr, params, TIMEOUT_MS);
-
-        // 记录日志
-        std::vector<double> realParams;
-        for (int i = 0; i < dim; ++i) {
-            realParams.push_back(specs[i].minVal + params[i] * (specs[i].maxVal - specs[i].minVal));
-        }
-        logger->logIteration(iterCount, realParams, error);
-
-        std::cout << "[" << patientName << "] Iter " << iterCount << " | Error: " << error << std::endl;
-
-        // 保存最佳结果
-        if (error < globalBestError && error < 1e5) {
-            globalBestError = error;
-            std::cout << "  >>> [New Best] Found error: " << error << ". Saving best_output..." << std::endl;
-            saveBestOutput(outputDir);
-        }
-        return error;
-    };
-
-    // 3. 配置 CMA-ES 初始点 (x0) - 使用你指定的物理参数作为起点
-    std::vector<double> initialParamsPhysical = {
-        2.0e6,   // Aorta_E
-        0.5e5,   // Valve_E
-        2.0e6,   // AorticAnnulus_E
-        0.5e5,   // AortomitralCurtain_E
-        8.0e6    // LeftVentricular_E
-    };
-
-    std::vector<double> x0(dim);
-    for (int i = 0; i < dim; ++i) {
-        double norm = (initialParamsPhysical[i] - specs[i].minVal) / (specs[i].maxVal - specs[i].minVal);
-        x0[i] = std::max(0.0, std::min(1.0, norm));
-    }
-
-    double sigma = 0.2;
-    std::vector<double> lb(dim, 0.0), ub(dim, 1.0);
-
-    // 4. 启动优化器
-    GenoPheno<pwqBoundStrategy> gp(lb.data(), ub.data(), dim);
-    CMAParameters<GenoPheno<pwqBoundStrategy>> cmaparams(x0, sigma, -1, 0, gp);
-    cmaparams.set_max_iter(MAX_GENERATIONS);
-
-    ESOptimizer<CMAStrategy<CovarianceUpdate, GenoPheno<pwqBoundStrategy>>,
-        CMAParameters<GenoPheno<pwqBoundStrategy>>>
-        optim(fitnessFunc, cmaparams);
-
-    int currentGen = 0;
-    while (!optim.stop()) {
-        dMat candidates = optim.ask();
-        optim.eval(candidates);
-        optim.tell();
-        optim.inc_iter();
-
-        currentGen++;
-        std::cout << ">>> [" << patientName << "] Generation " << currentGen << "/" << MAX_GENERATIONS << " Done. Best: "
-            << optim.get_solutions().best_candidate().get_fvalue() << std::endl;
-
-        if (currentGen >= MAX_GENERATIONS) break;
-    }
-}
-
-// =========================================================
-// 功能模块 3: 贝叶斯优化 (Bayesian Optimization)
-// =========================================================
-void runBayesOptOptimization(
-    const std::string& patientName,
-    const std::string& WORKER_EXE,
-    const std::string& meshDir,
-    const std::string& outputDir,
-    const std::string& stentTypeStr,
-    const std::vector<ParameterSpec>& specs,
-    int TIMEOUT_MS,
-    int MAX_GENERATIONS
-) {
-    std::cout << "\n--------------------------------------------------" << std::endl;
-    std::cout << "[Mode: BayesOpt] Starting Bayesian Optimization for " << patientName << std::endl;
-    std::cout << "--------------------------------------------------" << std::endl;
-
-    int dim = (int)specs.size();
-
-    // 1. 配置贝叶斯优化参数
-    bayesopt::Parameters boptParams = initialize_parameters_to_default();
-
-    // 关键设置
-    boptParams.n_iterations = MAX_GENERATIONS; // 总迭代次数
-    boptParams.surr_name = "sGaussianProcess"; // 代理模型：高斯过程
-
-    // 2. 实例化执行器
-    BayesOptExecutor opt(dim, boptParams, WORKER_EXE, meshDir, outputDir, stentTypeStr, specs, TIMEOUT_MS);
-
-    // 3. 设置边界 [0, 1]
-    // 因为 SimWorker 接收的是归一化参数，所以我们让 BayesOpt 也在 [0, 1] 空间内搜索
-    vectord lowerBound(dim), upperBound(dim);
-    for (int i = 0; i < dim; ++i) {
-        lowerBound[i] = 0.0;
-        upperBound[i] = 1.0;
-    }
-    opt.setBoundingBox(lowerBound, upperBound);
-
-    // 4. 运行优化
-    std::cout << ">>> BayesOpt Started. Max Iterations: " << MAX_GENERATIONS << std::endl;
-
-    vectord bestParamsNormalized(dim);
-    try {
-        opt.optimize(bestParamsNormalized);
-    }
-    catch (std::exception& e) {
-        std::cerr << "[BayesOpt Error] " << e.what() << std::endl;
-        return;
-    }
-
-    // 5. 输出最终结果
-    std::cout << "\n>>> Optimization Finished for " << patientName << std::endl;
-    std::cout << "Best Parameters found (Physical):" << std::endl;
-    for (int i = 0; i < dim; ++i) {
-        double p = specs[i].minVal + bestParamsNormalized[i] * (specs[i].maxVal - specs[i].minVal);
-        std::cout << "  " << specs[i].name << ": " << p << std::endl;
-    }
-}
-
-// =========================================================
-// 主函数
-// =========================================================
-int main() {
-    SetConsoleTitleA("Optimizer - Batch Manager");
-    system("chcp 65001>nul");
-
-    // [修改] 动态生成数据根目录
-    // 假设数据放在 EXE 同级目录下的 data/patient/
-    std::string exeDir = PathUtils::getExeDir();
-    const std::string DATASET_ROOT = exeDir + "data/patient/";
-
-    // WORKER_EXE 也可以写成绝对路径以防万一
-    const std::string WORKER_EXE = exeDir + "SimWorker.exe";
-
-    const int TIMEOUT_MS = 900000;
-    const int MAX_GENERATIONS = 1000;
-
     // 检查目录是否存在
     if (!fs::exists(DATASET_ROOT)) {
         std::cerr << "[Error] Data root not found: " << DATASET_ROOT << std::endl;
@@ -389,13 +172,8 @@ int main() {
         return -1;
     }
 
-    // 参数规格定义 (通用)
-    std::vector<ParameterSpec> specs;
-    specs.push_back({ "Aorta_E", "Aorta", "E", 0.1e6, 10e6 });
-    specs.push_back({ "Valve_E", "Valve", "E", 0.1e6, 5e6 });
-    specs.push_back({ "AorticAnnulus_E", "AorticAnnulus", "E", 0.1e6, 20e6 });
-    specs.push_back({ "AortomitralCurtain_E", "AortomitralCurtain", "E", 0.1e6, 5e6 });
-    specs.push_back({ "LeftVentricular_E", "LeftVentricular", "E", 0.5e6, 30e6 });
+    // 参数规格定义 (通用，与 SimWorker 共用同一份定义与变换，见 Common.h)
+    std::vector<ParameterSpec> specs = defaultParameterSpecs();
 
     // 遍历病人文件夹
     for (const auto& entry : fs::directory_iterator(DATASET_ROOT)) {
@@ -421,17 +199,22 @@ int main() {
         // 确保输出目录存在
         if (!fs::exists(outputDir)) fs::create_directory(outputDir);
 
+        PatientContext patient{ patientName, meshDir, outputDir, stentTypeStr };
+
         // ==========================================
         // 根据模式调用不同功能
         // ==========================================
         if (CURRENT_MODE == RunMode::ManualSingleRun) {
-            runManualSimulation(patientName, WORKER_EXE, meshDir, outputDir, stentTypeStr, specs, TIMEOUT_MS);
+            runManualSimulation(patient, specs, settings, MANUAL_PHYSICAL_PARAMS);
         }
         else if (CURRENT_MODE == RunMode::CmaesOptimization) {
-            runCMAESOptimization(patientName, WORKER_EXE, meshDir, outputDir, stentTypeStr, specs, TIMEOUT_MS, MAX_GENERATIONS);
+            runCMAESOptimization(patient, specs, settings);
         }
         else if (CURRENT_MODE == RunMode::BayesOptOptimization) {
-            runBayesOptOptimization(patientName, WORKER_EXE, meshDir, outputDir, stentTypeStr, specs, TIMEOUT_MS, MAX_GENERATIONS);
+            runBayesOptOptimization(patient, specs, settings);
+        }
+        else if (CURRENT_MODE == RunMode::TrustRegionBOOptimization) {
+            runTrustRegionBOOptimization(patient, specs, settings);
         }
     }
 
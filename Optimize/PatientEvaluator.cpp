@@ -0,0 +1,280 @@
+#include "PatientEvaluator.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+// Utils/PatientEvaluator.cpp
+
+namespace fs = std::filesystem;
+
+PatientEvaluator::PatientEvaluator(const PatientContext& patient,
+    const std::vector<ParameterSpec>& specs,
+    const OptimizerSettings& settings,
+    const std::string& logFileName)
+    : m_patient(patient), m_specs(specs), m_settings(settings),
+    m_runtime(patient.outputDir + "runtime_history.csv", transformSignature(specs), RuntimePredictor::directoryBytes(patient.meshDir), settings.timeoutMs),
+    m_feasibility(patient.outputDir + "feasibility.csv", transformSignature(specs), specs.size(), settings.feasibility),
+    m_slots(settings.concurrency), m_snapshotter(patient.outputDir), m_start(std::chrono::steady_clock::now())
+{
+    // 初始化日志
+    m_logger = std::make_unique<OptimizationLogger>(m_patient.outputDir + logFileName);
+    std::vector<std::string> names;
+    for (const auto& s : m_specs) names.push_back(s.name);
+    m_logger->writeHeader(names);
+
+    if (m_settings.metrics) m_settings.metrics->setSlots(concurrency());
+
+    // 本机槽位的 CPU 划分 (分布式模式下由各 Agent 所在节点自行决定)
+    if (!m_settings.coordinator) {
+        CpuTopology topology = CpuTopology::detect();
+        m_cpuSets = topology.plan(m_settings.concurrency, m_settings.cpuLayout);
+        std::cout << "[" << m_patient.name << "] CPU: " << topology.describe() << std::endl;
+        std::cout << "[" << m_patient.name << "] Workers: " << CpuTopology::describe(m_cpuSets, m_settings.cpuLayout) << std::endl;
+        if (m_settings.metrics && !m_cpuSets.empty()) {
+            m_settings.metrics->setLayout(CpuTopology::layoutName(m_settings.cpuLayout.layout), m_cpuSets.front().threads);
+        }
+    }
+}
+
+PatientEvaluator::~PatientEvaluator() {
+    std::lock_guard<std::mutex> lock(m_zygoteMutex);
+    ProcessUtils::stopZygote(m_zygote);
+}
+
+WorkerResult PatientEvaluator::runLocalWorker(const std::string& evalDir, const std::vector<double>& params, int timeoutMs, int slot) {
+    const WorkerCpuSet* cpuSet = slot >= 0 && slot < (int)m_cpuSets.size() ? &m_cpuSets[slot] : nullptr;
+    ProcessUtils::ZygoteHandle zygote;
+    if (m_settings.zygote) {
+        // 第一次评估时启动 (预加载期间其他评估线程在此等待)
+        std::lock_guard<std::mutex> lock(m_zygoteMutex);
+        if (!m_zygoteStarted) {
+            m_zygoteStarted = true;
+            std::cout << "[" << m_patient.name << "] Starting zygote worker (preloading patient data)..." << std::endl;
+            int threads = m_cpuSets.empty() ? 0 : m_cpuSets.front().threads;
+            if (!ProcessUtils::startZygote(m_settings.workerExe, m_patient.meshDir, m_patient.stentTypeStr, m_zygote, threads)) {
+                std::cout << "[" << m_patient.name << "] Zygote unavailable, starting one process per evaluation" << std::endl;
+            }
+        }
+        zygote = m_zygote;
+    }
+
+    WorkerResult result;
+    if (zygote.valid()) {
+        if (ProcessUtils::runWorkerZygote(zygote, m_patient.meshDir, evalDir, m_patient.stentTypeStr, params,
+            timeoutMs, m_settings.stall, result, cpuSet)) {
+            return result;
+        }
+        // Zygote 已退出或不再响应：停用并回退
+        std::lock_guard<std::mutex> lock(m_zygoteMutex);
+        if (m_zygote.valid() && m_zygote.pid == zygote.pid) {
+            std::cerr << "[" << m_patient.name << "] Zygote stopped responding, falling back to one process per evaluation" << std::endl;
+            ProcessUtils::stopZygote(m_zygote);
+        }
+    }
+    return ProcessUtils::runWorkerDetailed(m_settings.workerExe, m_patient.meshDir, evalDir,
+        m_patient.stentTypeStr, params, timeoutMs, m_settings.stall, cpuSet);
+}
+
+double PatientEvaluator::evaluate(const std::vector<double>& normalizedParams) {
+    // 1. 边界钳制
+    std::vector<double> params(normalizedParams);
+    for (auto& v : params) v = std::max(0.0, std::min(1.0, v));
+
+    MetricsExporter* metrics = m_settings.metrics.get();
+
+    // 2. 独立的评估输出目录 (分布式模式下由 Agent 在远程节点上创建)
+    int evalId = ++m_dispatchCount;
+    std::string evalDir = m_patient.outputDir + "evals/eval_" + std::to_string(evalId) + "/";
+    WorkerResult result;
+    int remoteJobId = -1;
+    int timeoutMs = m_settings.adaptiveTimeout ? m_runtime.timeoutFor(params) : m_settings.timeoutMs;
+    if (m_settings.coordinator) {
+        // 3a. 远程评估：排队与派发由协调器完成，排队时间计入 slot_wait
+        int ticket = metrics ? metrics->evaluationStarted(m_patient.name, false) : 0;
+        RemoteEvaluation remote = m_settings.coordinator->evaluate(m_patient.name, m_patient.stentTypeStr, params, timeoutMs);
+        result = remote.result;
+        remoteJobId = remote.jobId;
+        if (metrics) metrics->evaluationFinished(m_patient.name, ticket, outcomeOf(remote.result), remote.result.wallMs / 1000.0);
+    }
+    else {
+        std::error_code ec;
+        fs::create_directories(evalDir + "output/Obj", ec);
+
+        // 3b. 调用子进程 SimWorker (占用一个 Worker 槽位，等待时间计入 slot_wait)
+        auto queued = std::chrono::steady_clock::now();
+        if (metrics) metrics->evaluationQueued(m_patient.name);
+        int slot = m_slots.acquire();
+        int ticket = metrics ? metrics->evaluationStarted(m_patient.name, true) : 0;
+        double slotWaitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - queued).count();
+        result = runLocalWorker(evalDir, params, timeoutMs, slot);
+        m_slots.release(slot);
+        if (metrics) metrics->evaluationFinished(m_patient.name, ticket, outcomeOf(result), result.wallMs / 1000.0);
+        result.phases.emplace_back("slot_wait", slotWaitMs);
+    }
+    double error = result.cost;
+    m_phaseStats.add(result);
+
+    // 启动失败、停滞或求解器内部提前失败 (惩罚值，耗时远短于正常完成) 的评估不计入运行时间模型，
+    // 否则预测的中位数被拉低，自适应超时会误杀正常的长时间运行。阈值与 outcomeOf / FeasibilityModel 相同
+    if (result.stalled) {
+        std::cout << "  >>> [Stall] " << result.stallReason << std::endl;
+    }
+    else if (result.timedOut) {
+        std::cout << "  >>> [Timeout] Killed after " << timeoutMs / 1000.0 << " s (limit for this evaluation)" << std::endl;
+        m_runtime.observe(params, result.wallMs, true);
+    }
+    else if (error < PENALTY_THRESHOLD) {
+        m_runtime.observe(params, result.wallMs, false);
+    }
+    m_feasibility.observe(params, FeasibilityModel::isFailure(error, result.timedOut || result.stalled), error);
+
+    // 4. 记录日志 (计算物理值用于显示)
+    std::vector<double> realParams;
+    for (size_t i = 0; i < m_specs.size() && i < params.size(); ++i) {
+        realParams.push_back(m_specs[i].toPhysical(params[i]));
+    }
+
+    int iter;
+    bool improved = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        iter = ++m_iterCount;
+        if (error < m_globalBestError && error < PENALTY_THRESHOLD) {
+            m_globalBestError = error;
+            m_bestParams = params;
+            m_bestTrace.emplace_back(elapsedSeconds(), error);
+            improved = true;
+        }
+    }
+    if (improved && metrics) metrics->setBestCost(m_patient.name, error);
+    if (metrics) {
+        for (const auto& lookup : result.cacheLookups) metrics->cacheLookup(m_patient.name, lookup.first, lookup.second);
+    }
+    m_logger->logIteration(iter, realParams, error, PhaseStatistics::format(result));
+    if (remoteJobId < 0) archiveGeometry(evalDir, iter, realParams, error);
+    if (!result.counters.empty()) logCounters(iter, error, result);
+
+    std::cout << "[" << m_patient.name << "] Iter " << iter << " | Error: " << error << std::endl;
+
+    // 5. 发布最佳结果快照 (后台完成，不阻塞优化器)；远程评估的 best_output 保存在执行它的 Agent 节点上
+    if (remoteJobId >= 0) {
+        if (improved) std::cout << "  >>> [New Best] Found error: " << error << ". Saving best_output on agent..." << std::endl;
+        m_settings.coordinator->release(remoteJobId, improved, error);
+    }
+    else if (improved) {
+        std::cout << "  >>> [New Best] Found error: " << error << ". Saving best_output..." << std::endl;
+        m_snapshotter.publish(evalDir, error, evalId);
+    }
+    else {
+        m_snapshotter.discard(evalDir);
+    }
+    return error;
+}
+
+void PatientEvaluator::archiveGeometry(const std::string& evalDir, int iter, const std::vector<double>& realParams, double cost) {
+    std::error_code ec;
+    std::string source = evalDir + "output/final_geometry.geo";
+    if (!fs::exists(source, ec)) return;
+
+    // 归档按条目 id 追加，多次运行 (迭代号从 1 重新开始) 共用同一个归档
+    std::string dir = m_patient.outputDir + "geometry/";
+    std::lock_guard<std::mutex> lock(m_geometryMutex);
+    if (!m_geometryOpened) {
+        m_geometryOpened = true;
+        if (!m_geometry.open(dir, true)) std::cerr << "[" << m_patient.name << "] Cannot open geometry archive: " << dir << std::endl;
+    }
+    int id = m_geometry.appendGeo(source);
+    fs::remove(source, ec);
+    if (id < 0) return;
+
+    bool writeHeader = !fs::exists(dir + "index.csv", ec);
+    std::ofstream index(dir + "index.csv", std::ios::app);
+    if (writeHeader) {
+        index << "Id,Iteration,Cost";
+        for (const auto& s : m_specs) index << "," << s.name;
+        index << "\n";
+    }
+    index << id << "," << iter << "," << cost;
+    for (double p : realParams) index << "," << p;
+    index << "\n";
+}
+
+void PatientEvaluator::logCounters(int iter, double cost, const WorkerResult& result) {
+    std::lock_guard<std::mutex> lock(m_countersMutex);
+    std::string path = m_patient.outputDir + "counters.csv";
+    std::error_code ec;
+    bool writeHeader = !fs::exists(path, ec);
+    std::ofstream out(path, std::ios::app);
+    if (writeHeader) out << "Iteration,Cost,Counters\n";
+    out << iter << "," << cost << "," << PhaseStatistics::formatCounters(result) << "\n";
+}
+
+MetricsExporter::Outcome PatientEvaluator::outcomeOf(const WorkerResult& result) {
+    if (result.stalled) return MetricsExporter::Outcome::Stalled;
+    if (result.timedOut) return MetricsExporter::Outcome::TimedOut;
+    return result.cost < PENALTY_THRESHOLD ? MetricsExporter::Outcome::Ok : MetricsExporter::Outcome::Failed;
+}
+
+std::vector<double> PatientEvaluator::evaluateBatch(const std::vector<std::vector<double>>& batch) {
+    std::vector<double> costs(batch.size(), 1e9);
+    if (batch.empty()) return costs;
+
+    // 预测耗时最长的先启动，缩短每一代的尾部等待 (没有模型时保持原顺序)
+    std::vector<size_t> order(batch.size());
+    std::vector<double> predicted(batch.size(), 0.0);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        order[i] = i;
+        predicted[i] = m_runtime.predict(batch[i]).medianMs;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return predicted[a] > predicted[b]; });
+
+    // 线程数不超过槽位数，槽位本身由 WorkerSlotPool 保证 (多个批次并发时共享)
+    size_t threadCount = std::min(batch.size(), (size_t)concurrency());
+    if (threadCount == 1) {
+        for (size_t i : order) costs[i] = evaluate(batch[i]);
+        return costs;
+    }
+
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t k = next.fetch_add(1); k < batch.size(); k = next.fetch_add(1)) {
+                costs[order[k]] = evaluate(batch[order[k]]);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    return costs;
+}
+
+int PatientEvaluator::concurrency() const {
+    int slots = m_settings.concurrency;
+    if (m_settings.coordinator) slots = std::max(slots, m_settings.coordinator->totalSlots());
+    return std::max(1, slots);
+}
+
+double PatientEvaluator::bestCost() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_globalBestError;
+}
+
+std::vector<double> PatientEvaluator::bestParams() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bestParams;
+}
+
+int PatientEvaluator::evaluations() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_iterCount;
+}
+
+double PatientEvaluator::elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+std::vector<std::pair<double, double>> PatientEvaluator::bestTrace() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bestTrace;
+}
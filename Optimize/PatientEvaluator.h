@@ -0,0 +1,181 @@
+// Utils/PatientEvaluator.h
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include "Common.h"
+#include "ProcessUtils.h"
+#include "DistributedCoordinator.h"
+#include "PhaseStatistics.h"
+#include "OptimizationLogger.h"
+#include "BestOutputSnapshot.h"
+#include "RuntimePredictor.h"
+#include "RestartScheduler.h"
+#include "StoppingRules.h"
+#include "GeometryArchive.h"
+#include "MetricsExporter.h"
+#include "FeasibilityModel.h"
+#include "CpuTopology.h"
+#include "TrustRegionBO.h"
+
+// 优化器的全局设置 (所有病人共享)
+struct OptimizerSettings {
+    std::string workerExe;
+    int timeoutMs = 900000;     // 固定超时；启用自适应超时后仅用于冷启动
+    bool adaptiveTimeout = true; // 按运行时间预测的分位数设置每次评估的超时
+    StallPolicy stall;           // 求解停滞检测 (与超时、基于误差的提前终止无关)
+
+    // 参数筛选：优化前用 Morris 基本效应评估各参数影响，冻结不敏感参数 (结果缓存在 outputDir/screening.csv)
+    bool screenParameters = false;
+    int screeningTrajectories = 4;   // 评估次数 = 轨迹数 * (参数个数 + 1)
+    double inertThreshold = 0.1;     // μ* 低于 阈值 * max(μ*) 的参数被冻结在名义值
+
+    // 跨病人热启动：用数据集中已完成病人的最优参数 (同支架型号优先，可按 descriptors.txt 加权) 构造先验，
+    // CMA-ES 以先验均值为起点、按各维标准差设置步长，BayesOpt 的部分初始设计点从先验分布中抽取
+    bool warmStart = false;
+
+    // CMA-ES 重启：多个种群可并发运行，共享 Worker 槽位、全局最优与总评估预算 (maxGenerations * 默认种群)
+    RestartStrategy restartStrategy = RestartStrategy::None;
+    int cmaesPopulations = 1;        // 同时运行的独立种群数
+    int maxRestarts = 8;
+    int maxGenerations = 1000;
+    StoppingRules stopping;          // 停滞 / 容差 / 评估次数与时间预算 (默认只受 maxGenerations 限制)
+    int concurrency = 1;        // 同时运行的 Worker 数量 (每次评估使用独立输出目录，可安全并发)
+    std::shared_ptr<DistributedCoordinator> coordinator; // 非空时评估派发给远程 SimAgent，不在本机启动 Worker
+    std::shared_ptr<MetricsExporter> metrics;            // 非空时记录吞吐/延迟等运行指标 (Prometheus 文本格式导出)
+
+    // 可行性模型：按历史失败 (超时/停滞/惩罚值) 预测候选点的失败概率，优化器派发前修复或跳过高风险点，
+    // 失败结果以最差可行误差参与排序 (样本保存在 outputDir/feasibility.csv)
+    FeasibilityModel::Options feasibility;
+
+    // 本机评估通过每个病人一个常驻的 SimWorker --zygote 进程 fork 执行 (预加载的静态数据写时复制共享，启动开销接近零)；
+    // 平台不支持或 Zygote 启动失败时回退为每次评估启动新进程
+    bool zygote = false;
+
+    // 本机 Worker 槽位的 CPU/NUMA 划分与线程预算 (Worker 绑核，OpenMP/VTK/Eigen 线程数限制在预算内)；
+    // 与 concurrency 一起决定 "多而瘦" 还是 "少而胖" 的 Worker
+    CpuLayoutPolicy cpuLayout;
+
+    // 信赖域贝叶斯优化 (模式 4) 的局部模型与采集函数设置；评估预算与 BayesOpt 相同 (maxGenerations 次建议)
+    TrustRegionBO::Options trustRegion;
+};
+
+// 单个病人的路径信息
+struct PatientContext {
+    std::string name;
+    std::string meshDir;
+    std::string outputDir;
+    std::string stentTypeStr;
+};
+
+// 限制同时运行的 Worker 数量；每个槽位有固定编号 (对应 CpuTopology::plan 划分的 CPU)
+class WorkerSlotPool {
+public:
+    explicit WorkerSlotPool(int slots) {
+        for (int s = std::max(1, slots) - 1; s >= 0; --s) m_free.push_back(s);
+    }
+
+    // 阻塞直到有空闲槽位，返回槽位编号 (优先复用最近释放的槽位，缓存更热)
+    int acquire() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_free.empty(); });
+        int slot = m_free.back();
+        m_free.pop_back();
+        return slot;
+    }
+
+    void release(int slot) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(slot);
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<int> m_free;
+};
+
+// 单个病人的评估流水线：调用 Worker -> 记录日志/耗时 -> 维护全局最优并发布 best_output 快照
+// 每次评估在 outputDir/evals/eval_<id>/ 下独立运行，结束后由快照线程发布或删除；
+// 最终几何 (紧凑格式) 保留在 outputDir/geometry/ 下，更换误差定义后可用 Rescore 离线重新评分
+// 每次评估的超时由 RuntimePredictor 根据该病人的历史运行时间给出
+// 所有接口线程安全，CMA-ES 与 BayesOpt 共用
+class PatientEvaluator {
+public:
+    PatientEvaluator(const PatientContext& patient,
+        const std::vector<ParameterSpec>& specs,
+        const OptimizerSettings& settings,
+        const std::string& logFileName);
+    ~PatientEvaluator();
+
+    // 评估单个归一化参数向量 (阻塞，内部钳制到 [0,1])
+    double evaluate(const std::vector<double>& normalizedParams);
+
+    // 并发评估一批参数，返回与输入同序的误差
+    std::vector<double> evaluateBatch(const std::vector<std::vector<double>>& batch);
+
+    double bestCost() const;
+    std::vector<double> bestParams() const;   // 最优误差对应的归一化参数 (尚无有效结果时为空)
+    int evaluations() const;
+    double elapsedSeconds() const;
+
+    // 最优值改进轨迹：(自开始以来的秒数, 最优误差)
+    std::vector<std::pair<double, double>> bestTrace() const;
+
+    const PhaseStatistics& phaseStats() const { return m_phaseStats; }
+    const RuntimePredictor& runtimePredictor() const { return m_runtime; }
+    const FeasibilityModel& feasibility() const { return m_feasibility; }
+    const PatientContext& patient() const { return m_patient; }
+    const std::vector<ParameterSpec>& specs() const { return m_specs; }
+
+    // 当前可同时进行的评估数 (分布式模式下取在线 Agent 的槽位总数)
+    int concurrency() const;
+
+private:
+    // 把 Worker 保存的最终几何追加到 outputDir/geometry/ 下的压缩归档并登记到 index.csv (供 Rescore 离线重新评分)
+    void archiveGeometry(const std::string& evalDir, int iter, const std::vector<double>& realParams, double cost);
+    // Worker 上报的硬件计数器/内存按迭代写入 outputDir/counters.csv
+    void logCounters(int iter, double cost, const WorkerResult& result);
+    static MetricsExporter::Outcome outcomeOf(const WorkerResult& result);
+    // 本机运行一次 Worker：优先经由 Zygote，不可用时启动新进程
+    WorkerResult runLocalWorker(const std::string& evalDir, const std::vector<double>& params, int timeoutMs, int slot);
+
+    PatientContext m_patient;
+    std::vector<ParameterSpec> m_specs;
+    OptimizerSettings m_settings;
+
+    std::unique_ptr<OptimizationLogger> m_logger;
+    PhaseStatistics m_phaseStats;
+    RuntimePredictor m_runtime;
+    FeasibilityModel m_feasibility;
+    WorkerSlotPool m_slots;
+    std::vector<WorkerCpuSet> m_cpuSets;   // 槽位编号 -> CPU 与线程预算 (分布式模式下为空)
+    BestOutputSnapshotter m_snapshotter;
+    std::atomic<int> m_dispatchCount{ 0 };
+
+    mutable std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_start;
+    double m_globalBestError = 1e9;
+    std::vector<double> m_bestParams;
+    int m_iterCount = 0;
+    std::vector<std::pair<double, double>> m_bestTrace;
+
+    std::mutex m_zygoteMutex;
+    ProcessUtils::ZygoteHandle m_zygote;
+    bool m_zygoteStarted = false;   // 已尝试启动 (失败后不再重试)
+
+    std::mutex m_countersMutex;
+    std::mutex m_geometryMutex;
+    GeometryArchive m_geometry;
+    bool m_geometryOpened = false;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include "ProcessUtils.h"
+
+// 单个病人的阶段耗时统计 (p50/p95)，可被多个评估线程并发写入
+class PhaseStatistics {
+public:
+    void add(const WorkerResult& result) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& phase : result.phases) {
+            auto it = m_samples.find(phase.first);
+            if (it == m_samples.end()) {
+                m_order.push_back(phase.first);
+                it = m_samples.emplace(phase.first, std::vector<double>()).first;
+            }
+            it->second.push_back(phase.second);
+        }
+        m_samples["wall_total"].push_back(result.wallMs);
+        m_count++;
+    }
+
+    size_t count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    // 最近一次评估的阶段耗时，格式 "name=ms;name=ms"，用于写入日志
+    static std::string format(const WorkerResult& result) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < result.phases.size(); ++i) {
+            if (i > 0) ss << ";";
+            ss << result.phases[i].first << "=" << result.phases[i].second;
+        }
+        return ss.str();
+    }
+
+    // 硬件计数器/内存，格式同上 "name=value;name=value" (未启用计数器时为空)
+    static std::string formatCounters(const WorkerResult& result) {
+        std::ostringstream ss;
+        ss << std::setprecision(12);
+        for (size_t i = 0; i < result.counters.size(); ++i) {
+            if (i > 0) ss << ";";
+            ss << result.counters[i].first << "=" << result.counters[i].second;
+        }
+        return ss.str();
+    }
+
+    // 各阶段的 (p50, p95)，包含 wall_total
+    std::map<std::string, std::pair<double, double>> percentiles() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::map<std::string, std::pair<double, double>> out;
+        for (const auto& entry : m_samples) {
+            if (entry.second.empty()) continue;
+            std::vector<double> sorted = entry.second;
+            std::sort(sorted.begin(), sorted.end());
+            out[entry.first] = { percentile(sorted, 0.50), percentile(sorted, 0.95) };
+        }
+        return out;
+    }
+
+    void printSummary(const std::string& patientName) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0) return;
+
+        std::ostringstream ss;
+        ss << "[Timing] " << patientName << " | " << m_count << " evaluations (ms)\n";
+        ss << std::fixed << std::setprecision(1);
+        std::vector<std::string> names = m_order;
+        names.push_back("wall_total");
+        for (const auto& name : names) {
+            auto it = m_samples.find(name);
+            if (it == m_samples.end() || it->second.empty()) continue;
+            std::vector<double> sorted = it->second;
+            std::sort(sorted.begin(), sorted.end());
+            ss << "  " << std::left << std::setw(18) << name << std::right
+                << " p50 " << std::setw(10) << percentile(sorted, 0.50)
+                << "  p95 " << std::setw(10) << percentile(sorted, 0.95)
+                << "  n " << sorted.size() << "\n";
+        }
+        std::cout << ss.str() << std::flush;
+    }
+
+private:
+    // 最近秩法 (nearest-rank)
+    static double percentile(const std::vector<double>& sorted, double q) {
+        size_t rank = (size_t)std::ceil(q * sorted.size());
+        if (rank == 0) rank = 1;
+        return sorted[std::min(rank, sorted.size()) - 1];
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::string> m_order;
+    std::map<std::string, std::vector<double>> m_samples;
+    size_t m_count = 0;
+};
@@ -5,6 +5,13 @@
 #include <fstream>
 #include <chrono>
 #include <thread>
+#include <sstream>
+#include <algorithm>
+#include <utility>
+#include <atomic>
+#include <filesystem>
+#include <cstring>
+#include <cstdlib>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -12,7 +19,28 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef __linux__
+#include <sched.h>
 #endif
+extern char** environ;
+#endif
+#include "ProgressChannel.h"
+#include "CpuTopology.h"
+
+// 单次 Worker 运行的结果 (误差 + 阶段耗时)
+struct WorkerResult {
+    double cost = 1e9;
+    double wallMs = 0.0;                                     // Optimizer 侧测得的墙钟时间
+    bool timedOut = false;
+    bool stalled = false;                                    // 因求解停滞被提前终止 (同时视为 timedOut)
+    std::string stallReason;
+    std::vector<std::pair<std::string, double>> phases;     // SimWorker 上报的阶段耗时 (ms)
+    std::vector<std::pair<std::string, double>> counters;   // SimWorker 上报的硬件计数器/内存 (SIMWORKER_PERF_COUNTERS=1 时)
+    std::vector<std::pair<std::string, bool>> cacheLookups; // SimWorker 本次评估中查找磁盘缓存的结果 (缓存名, 是否命中；Zygote 预加载时的查找不在其中)
+};
 
 class ProcessUtils {
 public:
@@ -24,37 +52,38 @@ public:
         const std::vector<double>& params,
         int timeoutMs)
     {
-        std::string inputFile = "temp_in.txt";
-        std::string outputFile = "temp_out.txt";
-        double penalty = 1e9;
+        return runWorkerDetailed(workerExe, meshRoot, outputRoot, stentTypeStr, params, timeoutMs).cost;
+    }
 
-        // 1. 写参数到临时文件
-        {
-            std::ofstream out(inputFile);
-            if (out.is_open()) {
-                out << meshRoot << std::endl;
-                out << outputRoot << std::endl;
-                out << stentTypeStr << std::endl;
-                out << params.size() << std::endl;
-                for (double p : params) out << p << " ";
-                out.close();
-            }
-            else {
-                std::cerr << "[Process] Failed to write input file." << std::endl;
-                return penalty;
-            }
-        }
+    static WorkerResult runWorkerDetailed(
+        const std::string& workerExe,
+        const std::string& meshRoot,
+        const std::string& outputRoot,
+        const std::string& stentTypeStr,
+        const std::vector<double>& params,
+        int timeoutMs,
+        const StallPolicy& stallPolicy = StallPolicy(),
+        const WorkerCpuSet* cpuSet = nullptr)
+    {
+        // 每次调用使用独立的临时文件，允许多个 Worker 并发运行
+        std::string tag = uniqueTag();
+        std::string inputFile = tempPath("temp_in_" + tag + ".txt");
+        std::string outputFile = tempPath("temp_out_" + tag + ".txt");
+        std::string progressFile = tempPath("temp_progress_" + tag + ".bin");
+        WorkerResult result;
 
-        // 删除旧的输出文件
-#ifdef _WIN32
-        DeleteFileA(outputFile.c_str());
-#else
-        unlink(outputFile.c_str());
-#endif
+        // 进度通道：Worker 从 argv[3] 打开并在时间步循环中写入 (旧版 Worker 忽略该参数)
+        ProgressChannel progress;
+        progress.open(progressFile, true);
+        StallDetector stallDetector(stallPolicy);
+        auto wallStart = std::chrono::steady_clock::now();
+
+        // 1. 写参数到临时文件
+        if (!writeWorkerInput(inputFile, outputFile, meshRoot, outputRoot, stentTypeStr, params, cpuSet)) return result;
 
 #ifdef _WIN32
         // ================= Windows 实现 =================
-        std::string cmd = workerExe + " " + inputFile + " " + outputFile;
+        std::string cmd = quoteArgument(workerExe) + " " + quoteArgument(inputFile) + " " + quoteArgument(outputFile) + " " + quoteArgument(progressFile);
         STARTUPINFOA si;
         PROCESS_INFORMATION pi;
         ZeroMemory(&si, sizeof(si));
@@ -65,37 +94,59 @@ public:
         std::vector<char> cmdBuf(cmd.begin(), cmd.end());
         cmdBuf.push_back(0);
 
-        if (!CreateProcessA(NULL, cmdBuf.data(), NULL, NULL, FALSE, CREATE_NEW_CONSOLE, NULL, NULL, &si, &pi)) {
+        // 挂起状态创建，设置亲和性后再恢复 (线程预算由 Worker 从输入文件读取)
+        if (!CreateProcessA(NULL, cmdBuf.data(), NULL, NULL, FALSE, CREATE_NEW_CONSOLE | CREATE_SUSPENDED, NULL, NULL, &si, &pi)) {
             std::cerr << "[Process] Failed to start SimWorker." << std::endl;
-            return penalty;
+            return result;
         }
-
-        DWORD waitResult = WaitForSingleObject(pi.hProcess, timeoutMs);
-        if (waitResult == WAIT_TIMEOUT) {
-            std::cout << " [Timeout] SimWorker stuck! Killing process..." << std::endl;
-            TerminateProcess(pi.hProcess, 1);
+        if (cpuSet && !cpuSet->cpus.empty()) {
+            DWORD_PTR mask = 0;
+            for (int cpu : cpuSet->cpus) {
+                if (cpu < (int)(sizeof(DWORD_PTR) * 8)) mask |= (DWORD_PTR)1 << cpu;
+            }
+            if (mask) SetProcessAffinityMask(pi.hProcess, mask);
         }
-        else {
-            std::ifstream in(outputFile);
-            if (in.is_open()) in >> penalty;
+        ResumeThread(pi.hThread);
+
+        // 带超时与停滞检测的等待
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            if (WaitForSingleObject(pi.hProcess, 100) != WAIT_TIMEOUT) {
+                readWorkerOutput(outputFile, result);
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            if (elapsed > timeoutMs || checkStall(progress, stallDetector, now, result)) {
+                if (!result.stalled) std::cout << " [Timeout] SimWorker stuck! Killing process..." << std::endl;
+                TerminateProcess(pi.hProcess, 1);
+                WaitForSingleObject(pi.hProcess, INFINITE);
+                result.timedOut = true;
+                break;
+            }
         }
         CloseHandle(pi.hProcess);
         CloseHandle(pi.hThread);
 
 #else
         // ================= Linux 实现 (fork + exec) =================
+        // 环境变量在 fork 前准备好 (子进程中只做系统调用)
+        std::vector<std::string> env = workerEnvironment(cpuSet ? cpuSet->threads : 0);
+        std::vector<char*> envp = pointers(env);
         pid_t pid = fork();
 
         if (pid == -1) {
             std::cerr << "[Process] Fork failed." << std::endl;
-            return penalty;
+            return result;
         }
         else if (pid == 0) {
-            // 子进程
-            // execl 需要参数列表，第一个是路径，接下来的参数，最后 NULL
-            execl(workerExe.c_str(), workerExe.c_str(), inputFile.c_str(), outputFile.c_str(), (char*)NULL);
-            // 如果执行到这里说明 execl 失败
-            perror("[Process] execl failed");
+            // 子进程：先绑定到槽位的 CPU (exec 后的所有线程继承)
+            pinCurrentProcess(cpuSet);
+            // execve 需要参数列表，第一个是路径，接下来的参数，最后 NULL
+            const char* argv[] = { workerExe.c_str(), inputFile.c_str(), outputFile.c_str(), progressFile.c_str(), NULL };
+            execve(workerExe.c_str(), const_cast<char* const*>(argv), envp.data());
+            // 如果执行到这里说明 execve 失败
+            perror("[Process] execve failed");
             exit(1);
         }
         else {
@@ -106,12 +157,12 @@ public:
 
             while (true) {
                 // WNOHANG: 非阻塞轮询
-                pid_t result = waitpid(pid, &status, WNOHANG);
-                if (result == pid) { // 子进程结束
+                pid_t waited = waitpid(pid, &status, WNOHANG);
+                if (waited == pid) { // 子进程结束
                     finished = true;
                     break;
                 }
-                else if (result == -1) {
+                else if (waited == -1) {
                     perror("waitpid");
                     break;
                 }
@@ -119,10 +170,11 @@ public:
                 // 检查超时
                 auto now = std::chrono::steady_clock::now();
                 auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
-                if (elapsed > timeoutMs) {
-                    std::cout << " [Timeout] SimWorker stuck! Killing process..." << std::endl;
+                if (elapsed > timeoutMs || checkStall(progress, stallDetector, now, result)) {
+                    if (!result.stalled) std::cout << " [Timeout] SimWorker stuck! Killing process..." << std::endl;
                     kill(pid, SIGKILL);
                     waitpid(pid, &status, 0); // 回收尸体
+                    result.timedOut = true;
                     break;
                 }
 
@@ -130,13 +182,377 @@ public:
             }
 
             if (finished) {
-                std::ifstream in(outputFile);
-                if (in.is_open()) {
-                    in >> penalty;
+                readWorkerOutput(outputFile, result);
+            }
+        }
+#endif
+        progress.close();
+        finishWorkerResult(result, wallStart, inputFile, outputFile, progressFile);
+        return result;
+    }
+
+    // ================= Zygote (预 fork 的常驻 Worker) =================
+    // 每个病人一个 "SimWorker --zygote <meshRoot> <stentType> <socket>" 进程，预加载网格/支架/区域距离结构/目标，
+    // 每次评估由它 fork 子进程执行 (静态数据写时复制共享，子进程崩溃不影响 Zygote)。协议见 SimWorker 的 WorkerZygote
+    // 仅 POSIX；不可用时 startZygote 返回 false，调用方回退为 runWorkerDetailed
+    struct ZygoteHandle {
+        long pid = -1;
+        std::string socketPath;
+        bool valid() const { return pid > 0; }
+    };
+
+    // 启动 Zygote 并等待预加载完成 (套接字可连接)；失败时 zygote 保持无效
+    static bool startZygote(
+        const std::string& workerExe,
+        const std::string& meshRoot,
+        const std::string& stentTypeStr,
+        ZygoteHandle& zygote,
+        int threadsPerWorker = 0,
+        int startupTimeoutMs = 600000)
+    {
+        zygote = ZygoteHandle();
+#ifdef _WIN32
+        (void)workerExe; (void)meshRoot; (void)stentTypeStr; (void)threadsPerWorker; (void)startupTimeoutMs;
+        return false;
+#else
+        std::string socketPath = tempPath("simworker_zygote_" + uniqueTag() + ".sock");
+        if (socketPath.size() >= sizeof(sockaddr_un::sun_path)) return false;
+        unlink(socketPath.c_str());
+
+        // Zygote 本身不绑核 (子进程按请求各自绑定)；线程数环境变量在这里设置，
+        // 使 OpenMP 等在加载时读取环境的运行库对 fork 出的子进程也采用槽位的线程预算
+        std::vector<std::string> env = workerEnvironment(threadsPerWorker);
+        std::vector<char*> envp = pointers(env);
+        // 不用 PR_SET_PDEATHSIG：它绑定的是执行 fork 的线程 (这里是短命的评估线程)，线程退出 Zygote 就会被杀掉。
+        // 改为把 Optimizer 的 pid 传给 Zygote，由它定期检查父进程是否还在 (正常结束时由 stopZygote 终止)
+        std::string parentPid = std::to_string((long)getpid());
+        pid_t pid = fork();
+        if (pid == -1) return false;
+        if (pid == 0) {
+            const char* argv[] = { workerExe.c_str(), "--zygote", meshRoot.c_str(), stentTypeStr.c_str(), socketPath.c_str(), parentPid.c_str(), NULL };
+            execve(workerExe.c_str(), const_cast<char* const*>(argv), envp.data());
+            perror("[Process] execve failed");
+            _exit(1);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            int fd = connectZygote(socketPath);
+            if (fd >= 0) {
+                close(fd);   // 空连接：Zygote 读请求失败后直接关闭
+                break;
+            }
+            int status;
+            if (waitpid(pid, &status, WNOHANG) == pid) {
+                std::cerr << "[Process] Zygote exited during startup, falling back to one process per evaluation" << std::endl;
+                return false;
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed > startupTimeoutMs) {
+                kill(pid, SIGKILL);
+                waitpid(pid, &status, 0);
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        zygote.pid = (long)pid;
+        zygote.socketPath = socketPath;
+        return true;
+#endif
+    }
+
+    static void stopZygote(ZygoteHandle& zygote) {
+        if (!zygote.valid()) return;
+#ifndef _WIN32
+        int status;
+        kill((pid_t)zygote.pid, SIGTERM);
+        // 正在 accept 的 Zygote 收到 SIGTERM 后立即退出；给它一点时间清理套接字
+        for (int i = 0; i < 50 && waitpid((pid_t)zygote.pid, &status, WNOHANG) == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (waitpid((pid_t)zygote.pid, &status, WNOHANG) == 0) {
+            kill((pid_t)zygote.pid, SIGKILL);
+            waitpid((pid_t)zygote.pid, &status, 0);
+        }
+        unlink(zygote.socketPath.c_str());
+#endif
+        zygote = ZygoteHandle();
+    }
+
+    // 通过 Zygote 运行一次评估 (超时/停滞处理与 runWorkerDetailed 相同)。
+    // Zygote 无法连接时返回 false 且不修改 result，调用方应回退为 runWorkerDetailed
+    static bool runWorkerZygote(
+        const ZygoteHandle& zygote,
+        const std::string& meshRoot,
+        const std::string& outputRoot,
+        const std::string& stentTypeStr,
+        const std::vector<double>& params,
+        int timeoutMs,
+        const StallPolicy& stallPolicy,
+        WorkerResult& result,
+        const WorkerCpuSet* cpuSet = nullptr)
+    {
+#ifdef _WIN32
+        (void)zygote; (void)meshRoot; (void)outputRoot; (void)stentTypeStr; (void)params; (void)timeoutMs; (void)stallPolicy; (void)result; (void)cpuSet;
+        return false;
+#else
+        if (!zygote.valid()) return false;
+        std::string tag = uniqueTag();
+        std::string inputFile = tempPath("temp_in_" + tag + ".txt");
+        std::string outputFile = tempPath("temp_out_" + tag + ".txt");
+        std::string progressFile = tempPath("temp_progress_" + tag + ".bin");
+        WorkerResult local;
+
+        ProgressChannel progress;
+        progress.open(progressFile, true);
+        StallDetector stallDetector(stallPolicy);
+        auto wallStart = std::chrono::steady_clock::now();
+
+        std::error_code ec;
+        if (!writeWorkerInput(inputFile, outputFile, meshRoot, outputRoot, stentTypeStr, params, cpuSet)) {
+            std::filesystem::remove(progressFile, ec);
+            return false;
+        }
+
+        // 1. 发送请求并取得子进程 pid
+        int fd = connectZygote(zygote.socketPath);
+        long childPid = -1;
+        if (fd >= 0) {
+            std::string request = inputFile + "\n" + outputFile + "\n" + progressFile + "\n";
+            if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) == (ssize_t)request.size()) {
+                childPid = readChildPid(fd);
+            }
+        }
+        if (childPid <= 0) {
+            if (fd >= 0) close(fd);
+            progress.close();
+            std::filesystem::remove(inputFile, ec);
+            std::filesystem::remove(progressFile, ec);
+            return false;
+        }
+
+        // 2. 子进程退出时连接关闭 (EOF)；超时/停滞时直接终止子进程 (由 Zygote 回收)
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            pollfd pfd{ fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 100) > 0) {
+                char sink[256];
+                ssize_t n = recv(fd, sink, sizeof(sink), 0);
+                if (n <= 0) {
+                    readWorkerOutput(outputFile, local);
+                    break;
                 }
+                continue;
+            }
+            auto now = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            if (elapsed > timeoutMs || checkStall(progress, stallDetector, now, local)) {
+                if (!local.stalled) std::cout << " [Timeout] SimWorker stuck! Killing process..." << std::endl;
+                kill((pid_t)childPid, SIGKILL);
+                local.timedOut = true;
+                break;
+            }
+        }
+        close(fd);
+        progress.close();
+        finishWorkerResult(local, wallStart, inputFile, outputFile, progressFile);
+        result = local;
+        return true;
+#endif
+    }
+
+private:
+    // 参数写入 Worker 的输入文件，并删除旧的输出文件
+    // 槽位的线程预算与 CPU 追加为 "threads <n> [cpus <list>]" 一行 (Worker 据此绑核并限制并行区线程数)
+    static bool writeWorkerInput(const std::string& inputFile, const std::string& outputFile,
+        const std::string& meshRoot, const std::string& outputRoot, const std::string& stentTypeStr,
+        const std::vector<double>& params, const WorkerCpuSet* cpuSet)
+    {
+        std::ofstream out(inputFile);
+        if (!out.is_open()) {
+            std::cerr << "[Process] Failed to write input file." << std::endl;
+            return false;
+        }
+        out << meshRoot << std::endl;
+        out << outputRoot << std::endl;
+        out << stentTypeStr << std::endl;
+        out << params.size() << std::endl;
+        for (double p : params) out << p << " ";
+        if (cpuSet && cpuSet->threads > 0) {
+            out << std::endl << "threads " << cpuSet->threads;
+            if (!cpuSet->cpus.empty()) out << " cpus " << cpuSet->cpuList();
+        }
+        out.close();
+
+#ifdef _WIN32
+        DeleteFileA(outputFile.c_str());
+#else
+        unlink(outputFile.c_str());
+#endif
+        return true;
+    }
+
+    // 删除临时文件，记录墙钟时间与 Worker 无法自行计量的开销
+    static void finishWorkerResult(WorkerResult& result, std::chrono::steady_clock::time_point wallStart,
+        const std::string& inputFile, const std::string& outputFile, const std::string& progressFile)
+    {
+        std::error_code ec;
+        std::filesystem::remove(inputFile, ec);
+        std::filesystem::remove(outputFile, ec);
+        std::filesystem::remove(progressFile, ec);
+
+        result.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+        // 进程启动/退出 (Zygote 模式下为 fork 与请求往返) 等开销
+        for (const auto& phase : result.phases) {
+            if (phase.first == "worker_total") {
+                result.phases.emplace_back("process_overhead", std::max(0.0, result.wallMs - phase.second));
+                break;
+            }
+        }
+    }
+
+#ifdef _WIN32
+    // 按 CommandLineToArgvW / MSVC CRT 的规则给一个参数加引号 (路径中可能有空格)：
+    // 引号前的反斜杠加倍后再转义引号，结尾的反斜杠加倍以免吞掉闭合引号
+    static std::string quoteArgument(const std::string& arg) {
+        if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos) return arg;
+        std::string out = "\"";
+        size_t backslashes = 0;
+        for (char c : arg) {
+            if (c == '\\') {
+                backslashes++;
+                continue;
+            }
+            if (c == '"') out.append(backslashes * 2 + 1, '\\');
+            else out.append(backslashes, '\\');
+            backslashes = 0;
+            out.push_back(c);
+        }
+        out.append(backslashes * 2, '\\');
+        out.push_back('"');
+        return out;
+    }
+#endif
+
+#ifndef _WIN32
+    // 当前环境 + 线程预算 (threads <= 0 时不修改)
+    static std::vector<std::string> workerEnvironment(int threads) {
+        static const char* budgetVars[] = { "OMP_NUM_THREADS", "VTK_SMP_MAX_THREADS", "SIMWORKER_THREADS" };
+        std::vector<std::string> env;
+        for (char** e = environ; e && *e; ++e) {
+            std::string entry(*e);
+            bool overridden = false;
+            for (const char* var : budgetVars) {
+                std::string prefix = std::string(var) + "=";
+                if (threads > 0 && entry.compare(0, prefix.size(), prefix) == 0) overridden = true;
             }
+            if (!overridden) env.push_back(entry);
+        }
+        if (threads > 0) {
+            for (const char* var : budgetVars) env.push_back(std::string(var) + "=" + std::to_string(threads));
+        }
+        return env;
+    }
+
+    static std::vector<char*> pointers(std::vector<std::string>& strings) {
+        std::vector<char*> out;
+        for (auto& s : strings) out.push_back(&s[0]);
+        out.push_back(nullptr);
+        return out;
+    }
+
+    // fork 后、exec 前调用 (只做系统调用)
+    static void pinCurrentProcess(const WorkerCpuSet* cpuSet) {
+#ifdef __linux__
+        if (!cpuSet || cpuSet->cpus.empty()) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpuSet->cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+        }
+        sched_setaffinity(0, sizeof(mask), &mask);
+#else
+        (void)cpuSet;
+#endif
+    }
+
+    static int connectZygote(const std::string& socketPath) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // 读取子进程发回的 "pid <n>\n" (fork 很快，10 秒内没有回应视为 Zygote 异常)
+    static long readChildPid(int fd) {
+        std::string line;
+        char c;
+        while (line.size() < 64) {
+            pollfd pfd{ fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 10000) <= 0) return -1;
+            if (recv(fd, &c, 1, 0) != 1) return -1;
+            if (c == '\n') break;
+            line.push_back(c);
         }
+        if (line.compare(0, 4, "pid ") != 0) return -1;
+        return std::atol(line.c_str() + 4);
+    }
+#endif
+
+    static std::string uniqueTag() {
+        static std::atomic<unsigned long long> counter{ 0 };
+#ifdef _WIN32
+        unsigned long pid = GetCurrentProcessId();
+#else
+        unsigned long pid = (unsigned long)getpid();
 #endif
-        return penalty;
+        return std::to_string(pid) + "_" + std::to_string(counter.fetch_add(1));
+    }
+
+    static std::string tempPath(const std::string& name) {
+        std::error_code ec;
+        std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+        if (ec) return name;
+        return (dir / name).string();
+    }
+
+    // 读取进度并判定停滞；停滞时填写 result 并返回 true
+    static bool checkStall(const ProgressChannel& progress, StallDetector& detector,
+        std::chrono::steady_clock::time_point now, WorkerResult& result)
+    {
+        ProgressChannel::Snapshot snap;
+        if (!progress.read(snap)) return false;
+        std::string reason = detector.check(snap, now);
+        if (reason.empty()) return false;
+        std::cout << " [Stall] SimWorker " << reason << " (step " << snap.step << "). Killing process..." << std::endl;
+        result.stalled = true;
+        result.stallReason = reason;
+        return true;
+    }
+
+    // 解析输出文件：第一行误差，其后 "phase <name> <ms>"、"counter <name> <value>" 与 "cache <name> <0|1>" (旧版 Worker 只有误差)
+    static void readWorkerOutput(const std::string& outputFile, WorkerResult& result) {
+        std::ifstream in(outputFile);
+        if (!in.is_open()) return;
+        in >> result.cost;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ls(line);
+            std::string tag, name;
+            double value;
+            if (!(ls >> tag >> name >> value)) continue;
+            if (tag == "phase") result.phases.emplace_back(name, value);
+            else if (tag == "counter") result.counters.emplace_back(name, value);
+            else if (tag == "cache") result.cacheLookups.emplace_back(name, value != 0);
+        }
     }
 };
\ No newline at end of file
@@ -0,0 +1,201 @@
+// Utils/ProgressChannel.h
+#pragma once
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Worker -> Optimizer 的求解进度通道：一个映射到两端进程的小文件 (mmap / 文件映射)。
+// Worker 在时间步循环中直接写入原子字段 (每步几次存储，无系统调用)，
+// Optimizer 轮询读取，用于判断求解是否停滞。字段各自原子，读到的快照允许轻微不一致。
+struct ProgressRecord {
+    enum State : std::uint32_t { Startup = 0, Solving = 1, PostProcessing = 2 };
+
+    std::uint32_t magic;
+    std::atomic<std::uint32_t> state;
+    std::atomic<std::int64_t> step;         // 已完成的时间步数
+    std::atomic<std::uint64_t> updates;     // 每次写入递增
+    std::atomic<double> simTime;            // 当前仿真时间
+    std::atomic<double> stopTime;           // 终止仿真时间
+    std::atomic<double> stepRate;           // 最近窗口内的步数/秒
+
+    static constexpr std::uint32_t MAGIC = 0x31475250; // "PRG1"
+};
+
+static_assert(std::atomic<double>::is_always_lock_free && std::atomic<std::int64_t>::is_always_lock_free,
+    "ProgressRecord requires lock-free atomics to be shared between processes");
+
+class ProgressChannel {
+public:
+    ProgressChannel() = default;
+    ~ProgressChannel() { close(); }
+    ProgressChannel(const ProgressChannel&) = delete;
+    ProgressChannel& operator=(const ProgressChannel&) = delete;
+
+    // 创建 (或打开已有的) 进度文件并映射；create 时清零
+    bool open(const std::string& path, bool create) {
+        close();
+#ifdef _WIN32
+        m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, create ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, NULL);
+        if (m_file == INVALID_HANDLE_VALUE) return false;
+        m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READWRITE, 0, (DWORD)sizeof(ProgressRecord), NULL);
+        if (!m_mapping) { close(); return false; }
+        void* view = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(ProgressRecord));
+#else
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | (create ? O_TRUNC : 0), 0644);
+        if (m_fd < 0) return false;
+        if (ftruncate(m_fd, sizeof(ProgressRecord)) != 0) { close(); return false; }
+        void* view = mmap(nullptr, sizeof(ProgressRecord), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (view == MAP_FAILED) view = nullptr;
+#endif
+        if (!view) { close(); return false; }
+        m_record = static_cast<ProgressRecord*>(view);
+        if (create) {
+            std::memset(view, 0, sizeof(ProgressRecord));
+            m_record->magic = ProgressRecord::MAGIC;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (m_record) UnmapViewOfFile(m_record);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = NULL;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_record) munmap(m_record, sizeof(ProgressRecord));
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_record = nullptr;
+    }
+
+    bool isOpen() const { return m_record != nullptr; }
+
+    // ---------------- Worker 侧 ----------------
+
+    void setState(ProgressRecord::State state) {
+        if (!m_record) return;
+        m_record->state.store(state, std::memory_order_relaxed);
+        m_record->updates.fetch_add(1, std::memory_order_release);
+    }
+
+    // 每个时间步调用；步速按 >= 0.5 s 的窗口计算
+    void update(double simTime, double stopTime, std::int64_t step) {
+        if (!m_record) return;
+        auto now = std::chrono::steady_clock::now();
+        if (m_windowStep < 0) {
+            m_windowStart = now;
+            m_windowStep = step;
+        }
+        double dt = std::chrono::duration<double>(now - m_windowStart).count();
+        if (dt >= 0.5) {
+            m_record->stepRate.store((step - m_windowStep) / dt, std::memory_order_relaxed);
+            m_windowStart = now;
+            m_windowStep = step;
+        }
+        m_record->state.store(ProgressRecord::Solving, std::memory_order_relaxed);
+        m_record->simTime.store(simTime, std::memory_order_relaxed);
+        m_record->stopTime.store(stopTime, std::memory_order_relaxed);
+        m_record->step.store(step, std::memory_order_relaxed);
+        m_record->updates.fetch_add(1, std::memory_order_release);
+    }
+
+    // ---------------- Optimizer 侧 ----------------
+
+    struct Snapshot {
+        ProgressRecord::State state = ProgressRecord::Startup;
+        std::int64_t step = 0;
+        std::uint64_t updates = 0;
+        double simTime = 0.0;
+        double stopTime = 0.0;
+        double stepRate = 0.0;
+    };
+
+    bool read(Snapshot& snap) const {
+        if (!m_record || m_record->magic != ProgressRecord::MAGIC) return false;
+        snap.updates = m_record->updates.load(std::memory_order_acquire);
+        snap.state = (ProgressRecord::State)m_record->state.load(std::memory_order_relaxed);
+        snap.step = m_record->step.load(std::memory_order_relaxed);
+        snap.simTime = m_record->simTime.load(std::memory_order_relaxed);
+        snap.stopTime = m_record->stopTime.load(std::memory_order_relaxed);
+        snap.stepRate = m_record->stepRate.load(std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    ProgressRecord* m_record = nullptr;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = NULL;
+#else
+    int m_fd = -1;
+#endif
+    std::chrono::steady_clock::time_point m_windowStart;
+    std::int64_t m_windowStep = -1;
+};
+
+// 停滞判定 (只在 Solving 状态下生效；启动与后处理阶段由总超时兜底)
+struct StallPolicy {
+    bool enabled = true;
+    int noProgressMs = 30000;         // 仿真时间超过该时长没有推进
+    double rateCollapseFraction = 0.1; // 步速低于峰值的该比例...
+    int rateCollapseMs = 20000;        // ...并持续该时长
+};
+
+// 由 Supervisor 轮询调用，返回非空字符串表示已判定停滞
+class StallDetector {
+public:
+    explicit StallDetector(const StallPolicy& policy) : m_policy(policy) {}
+
+    std::string check(const ProgressChannel::Snapshot& snap, std::chrono::steady_clock::time_point now) {
+        if (!m_policy.enabled || snap.state != ProgressRecord::Solving) {
+            m_lastAdvance = now;
+            m_slowSince = {};
+            return "";
+        }
+        if (m_lastStep < 0 || snap.step != m_lastStep || snap.simTime != m_lastSimTime) {
+            m_lastStep = snap.step;
+            m_lastSimTime = snap.simTime;
+            m_lastAdvance = now;
+        }
+        auto sinceAdvance = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastAdvance).count();
+        if (sinceAdvance > m_policy.noProgressMs) {
+            return "no progress for " + std::to_string(sinceAdvance / 1000) + " s at t=" + std::to_string(snap.simTime);
+        }
+
+        m_peakRate = std::max(m_peakRate, snap.stepRate);
+        if (m_peakRate > 0.0 && snap.stepRate < m_peakRate * m_policy.rateCollapseFraction) {
+            if (m_slowSince == std::chrono::steady_clock::time_point()) m_slowSince = now;
+            auto slowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_slowSince).count();
+            if (slowMs > m_policy.rateCollapseMs) {
+                return "step rate collapsed to " + std::to_string(snap.stepRate) + "/s (peak " + std::to_string(m_peakRate) + "/s)";
+            }
+        }
+        else {
+            m_slowSince = {};
+        }
+        return "";
+    }
+
+private:
+    StallPolicy m_policy;
+    std::int64_t m_lastStep = -1;
+    double m_lastSimTime = 0.0;
+    double m_peakRate = 0.0;
+    std::chrono::steady_clock::time_point m_lastAdvance;
+    std::chrono::steady_clock::time_point m_slowSince;
+};
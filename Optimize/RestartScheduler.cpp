@@ -0,0 +1,64 @@
+#include "RestartScheduler.h"
+#include <cmath>
+#include <algorithm>
+// Utils/RestartScheduler.cpp
+
+RestartScheduler::RestartScheduler(RestartStrategy strategy, int dim, const std::vector<double>& x0, double sigma0, int maxRuns, unsigned int seed)
+    : m_strategy(strategy), m_dim(dim), m_x0(x0), m_sigma0(sigma0), m_lambda0(defaultLambda(dim)),
+    m_maxRuns(std::max(1, maxRuns)), m_rng(seed), m_largestLambda(defaultLambda(dim)) {}
+
+int RestartScheduler::defaultLambda(int dim) {
+    return 4 + (int)std::floor(3.0 * std::log((double)std::max(1, dim)));
+}
+
+bool RestartScheduler::next(RestartPlan& plan) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_issued >= m_maxRuns) return false;
+
+    plan = RestartPlan();
+    plan.index = m_issued++;
+    if (plan.index == 0) {
+        plan.x0 = m_x0;
+        plan.scales = m_x0Scales;
+    }
+    else {
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        plan.x0.resize(m_dim);
+        for (auto& v : plan.x0) v = uni(m_rng);
+    }
+
+    // BIPOP：小种群模式已用预算少于大种群模式时，下一次用小种群
+    bool small = m_strategy == RestartStrategy::BIPOP && plan.index > 0 && m_smallBudget < m_largeBudget;
+    if (small) {
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        double u1 = uni(m_rng), u2 = uni(m_rng);
+        double ratio = 0.5 * m_largestLambda / m_lambda0;
+        plan.lambda = std::max(m_lambda0, (int)std::floor(m_lambda0 * std::pow(ratio, u1 * u1)));
+        plan.sigma = m_sigma0 * std::pow(10.0, -2.0 * u2);
+        plan.largeRegime = false;
+    }
+    else {
+        // None：种群不变；IPOP/BIPOP 大种群：每次重启加倍
+        int doublings = m_strategy == RestartStrategy::None ? 0 : m_largeRuns;
+        plan.lambda = m_lambda0 << std::min(doublings, 10);
+        plan.sigma = m_sigma0;
+        plan.largeRegime = true;
+        m_largeRuns++;
+        m_largestLambda = std::max(m_largestLambda, plan.lambda);
+    }
+    return true;
+}
+
+void RestartScheduler::report(const RestartPlan& plan, int evaluations) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (plan.largeRegime) m_largeBudget += evaluations;
+    else m_smallBudget += evaluations;
+}
+
+std::string RestartScheduler::name(RestartStrategy strategy) {
+    switch (strategy) {
+    case RestartStrategy::IPOP: return "IPOP";
+    case RestartStrategy::BIPOP: return "BIPOP";
+    default: return "None";
+    }
+}
@@ -0,0 +1,61 @@
+// Utils/RestartScheduler.h
+#pragma once
+#include <vector>
+#include <mutex>
+#include <random>
+#include <string>
+
+// CMA-ES 重启策略
+enum class RestartStrategy {
+    None,   // 单次运行 (多个并发种群时各跑一次)
+    IPOP,   // 每次重启种群加倍
+    BIPOP   // 交替使用大种群 (逐次加倍) 与小种群 (随机小步长) 两种模式，按已用预算平衡
+};
+
+// 单次 CMA-ES 运行的配置
+struct RestartPlan {
+    int index = 0;               // 第几次运行 (0 为首次)
+    int lambda = 0;              // 种群大小
+    double sigma = 0.0;          // 初始步长
+    std::vector<double> scales;  // 各维步长相对 sigma 的倍数 (空表示各向同性)
+    std::vector<double> x0;      // 起点 (归一化子空间)
+    bool largeRegime = true;     // BIPOP 模式标记 (IPOP/None 恒为 true)
+};
+
+// 为多个并发运行的 CMA-ES 种群分配下一次 (重启) 配置，线程安全。
+// 首次运行从给定起点 (及可选的各维步长倍数，如热启动先验) 出发，之后的重启从 [0,1]^d 内均匀随机的起点各向同性地出发。
+class RestartScheduler {
+public:
+    RestartScheduler(RestartStrategy strategy, int dim, const std::vector<double>& x0, double sigma0, int maxRuns, unsigned int seed = 2024);
+
+    // 首次运行使用的各维步长倍数
+    void setInitialScales(const std::vector<double>& scales) { m_x0Scales = scales; }
+
+    // 默认种群大小 4 + floor(3 ln d)
+    static int defaultLambda(int dim);
+
+    // 取下一次运行的配置；运行次数用完返回 false
+    bool next(RestartPlan& plan);
+
+    // 报告一次运行结束 (evaluations: 该运行消耗的评估次数)，用于 BIPOP 预算平衡
+    void report(const RestartPlan& plan, int evaluations);
+
+    static std::string name(RestartStrategy strategy);
+
+private:
+    RestartStrategy m_strategy;
+    int m_dim;
+    std::vector<double> m_x0;
+    std::vector<double> m_x0Scales;
+    double m_sigma0;
+    int m_lambda0;
+    int m_maxRuns;
+
+    std::mutex m_mutex;
+    std::mt19937 m_rng;
+    int m_issued = 0;
+    int m_largeRuns = 0;          // 已发出的大种群运行次数 (决定下一次的加倍次数)
+    int m_largestLambda = 0;
+    long long m_largeBudget = 0;  // BIPOP：两种模式已消耗的评估次数
+    long long m_smallBudget = 0;
+};
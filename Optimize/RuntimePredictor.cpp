@@ -0,0 +1,183 @@
+#include "RuntimePredictor.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+// Utils/RuntimePredictor.cpp
+
+namespace fs = std::filesystem;
+
+// 删失样本 (超时被杀) 的放大系数：真实耗时至少为 wallMs，按 1.5 倍计入
+static const double CENSORED_INFLATION = 1.5;
+
+// 本进程内所有病人的 log(ms / 网格MB)，用于新病人的冷启动外推
+static std::mutex g_poolMutex;
+static std::vector<double> g_logMsPerMB;
+
+double RuntimePredictor::Prediction::quantileMs(double z) const {
+    return medianMs * std::exp(z * sigmaLog);
+}
+
+RuntimePredictor::RuntimePredictor(const std::string& historyPath, const std::string& signature, std::uint64_t meshBytes, int fixedTimeoutMs)
+    : RuntimePredictor(historyPath, signature, meshBytes, fixedTimeoutMs, Options()) {}
+
+RuntimePredictor::RuntimePredictor(const std::string& historyPath, const std::string& signature, std::uint64_t meshBytes, int fixedTimeoutMs, const Options& options)
+    : m_historyPath(historyPath), m_signature(signature), m_meshMB(std::max(1e-3, meshBytes / (1024.0 * 1024.0))),
+    m_fixedTimeoutMs(fixedTimeoutMs), m_options(options)
+{
+    load();
+}
+
+void RuntimePredictor::load() {
+    std::ifstream in(m_historyPath);
+    if (!in.is_open()) return;
+    std::string line;
+    std::getline(in, line);
+    if (line != m_signature) {
+        // 变换或边界不同 (或旧版无签名的文件)：坐标含义已变，移走后重新积累
+        in.close();
+        std::error_code ec;
+        fs::rename(m_historyPath, m_historyPath + ".stale", ec);
+        std::cout << "[Runtime] " << m_historyPath << " was recorded under different parameter transforms, starting over" << std::endl;
+        return;
+    }
+    std::getline(in, line); // 表头
+    std::vector<double> pooled;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<double> values;
+        while (std::getline(ss, cell, ',')) {
+            try { values.push_back(std::stod(cell)); }
+            catch (...) { values.clear(); break; }
+        }
+        if (values.size() < 2 || values[0] <= 0) continue;
+        double ms = values[1] != 0 ? values[0] * CENSORED_INFLATION : values[0];
+        Sample s{ std::vector<double>(values.begin() + 2, values.end()), std::log(ms) };
+        m_sumLog += s.logMs;
+        m_sumLog2 += s.logMs * s.logMs;
+        pooled.push_back(s.logMs - std::log(m_meshMB));
+        m_samples.push_back(std::move(s));
+    }
+    if (!m_samples.empty()) {
+        std::cout << "[Runtime] Loaded " << m_samples.size() << " runtime samples from " << m_historyPath << std::endl;
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        g_logMsPerMB.insert(g_logMsPerMB.end(), pooled.begin(), pooled.end());
+    }
+}
+
+RuntimePredictor::Prediction RuntimePredictor::predict(const std::vector<double>& params) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return predictLocked(params);
+}
+
+RuntimePredictor::Prediction RuntimePredictor::predictLocked(const std::vector<double>& params) const {
+    Prediction pred;
+    size_t n = m_samples.size();
+
+    if ((int)n < m_options.minSamples) {
+        // 冷启动：按网格大小从其他病人外推，离散度至少取 0.5 (约 ±65%)
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        if ((int)g_logMsPerMB.size() < m_options.minSamples) return pred;
+        double sum = 0.0, sum2 = 0.0;
+        for (double v : g_logMsPerMB) { sum += v; sum2 += v * v; }
+        double mean = sum / g_logMsPerMB.size();
+        double var = std::max(0.0, sum2 / g_logMsPerMB.size() - mean * mean);
+        pred.medianMs = std::exp(mean + std::log(m_meshMB));
+        pred.sigmaLog = std::max(0.5, std::sqrt(var));
+        pred.fromModel = true;
+        return pred;
+    }
+
+    double globalMean = m_sumLog / n;
+    double globalVar = std::max(0.0, m_sumLog2 / n - globalMean * globalMean);
+
+    // k 近邻 (欧氏距离，归一化参数空间)
+    size_t k = std::min((size_t)m_options.neighbors, n);
+    std::vector<std::pair<double, size_t>> dist(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto& p = m_samples[i].params;
+        double d2 = 0.0;
+        for (size_t j = 0; j < p.size() && j < params.size(); ++j) d2 += (p[j] - params[j]) * (p[j] - params[j]);
+        dist[i] = { std::sqrt(d2), i };
+    }
+    std::partial_sort(dist.begin(), dist.begin() + k, dist.end());
+
+    double wSum = 0.0, wMean = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+        double w = 1.0 / (dist[i].first + 0.05);
+        wSum += w;
+        wMean += w * m_samples[dist[i].second].logMs;
+    }
+    wMean /= wSum;
+    double wVar = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+        double w = 1.0 / (dist[i].first + 0.05);
+        double d = m_samples[dist[i].second].logMs - wMean;
+        wVar += w * d * d;
+    }
+    wVar /= wSum;
+
+    // 向全局分布收缩 (相当于 2 个全局伪样本)，避免近邻过少时过度自信
+    const double prior = 2.0;
+    double mean = (k * wMean + prior * globalMean) / (k + prior);
+    double var = (k * wVar + prior * globalVar) / (k + prior);
+    pred.medianMs = std::exp(mean);
+    pred.sigmaLog = std::max(0.1, std::sqrt(var));
+    pred.fromModel = true;
+    return pred;
+}
+
+int RuntimePredictor::timeoutFor(const std::vector<double>& params) const {
+    Prediction pred = predict(params);
+    if (!pred.fromModel) return m_fixedTimeoutMs;
+    double lo = std::min(m_options.minTimeoutMs, (double)m_fixedTimeoutMs);
+    double hi = std::max(m_options.maxTimeoutMs, (double)m_fixedTimeoutMs);
+    double t = pred.quantileMs(m_options.timeoutZ) * m_options.safetyFactor;
+    return (int)std::max(lo, std::min(hi, t));
+}
+
+void RuntimePredictor::observe(const std::vector<double>& params, double wallMs, bool timedOut) {
+    if (wallMs <= 0) return;
+    double ms = timedOut ? wallMs * CENSORED_INFLATION : wallMs;
+    Sample s{ params, std::log(ms) };
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sumLog += s.logMs;
+        m_sumLog2 += s.logMs * s.logMs;
+        m_samples.push_back(s);
+
+        bool writeHeader = !fs::exists(m_historyPath);
+        std::ofstream out(m_historyPath, std::ios::app);
+        if (out.is_open()) {
+            if (writeHeader) {
+                out << m_signature << "\n";
+                out << "WallMs,TimedOut";
+                for (size_t i = 0; i < params.size(); ++i) out << ",P" << i;
+                out << "\n";
+            }
+            out << wallMs << "," << (timedOut ? 1 : 0);
+            for (double p : params) out << "," << p;
+            out << "\n";
+        }
+    }
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    g_logMsPerMB.push_back(s.logMs - std::log(m_meshMB));
+}
+
+size_t RuntimePredictor::sampleCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.size();
+}
+
+std::uint64_t RuntimePredictor::directoryBytes(const std::string& dir) {
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(dir, ec); it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (it->is_regular_file(ec)) total += it->file_size(ec);
+    }
+    return total;
+}
@@ -0,0 +1,69 @@
+// Utils/RuntimePredictor.h
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+// 单次评估运行时间的预测模型 (每个病人一个实例，线程安全)
+//
+// 运行时间按对数正态建模：log(ms) 的均值由归一化参数空间中的 k 近邻加权估计，
+// 并向该病人的全局均值收缩；离散度取近邻与全局方差的加权值。
+// 历史样本追加到 outputDir/runtime_history.csv，重启后继续使用；首行为参数变换签名 (transformSignature)，
+// 签名不一致的旧文件改名为 .stale 后重新开始。
+// 该病人样本不足时，用本进程内其他病人的 "每 MB 网格耗时" 按网格大小外推 (冷启动)。
+class RuntimePredictor {
+public:
+    struct Options {
+        int minSamples = 8;            // 少于该样本数时不使用本病人模型
+        int neighbors = 8;             // kNN 的 k
+        double timeoutZ = 3.09;        // 超时取预测分布的 99.9% 分位
+        double safetyFactor = 1.5;     // 分位数之上的额外余量
+        double minTimeoutMs = 30000;   // 自适应超时下限 (不会高于固定超时)
+        double maxTimeoutMs = 3600000; // 自适应超时上限 (不会低于固定超时)
+    };
+
+    struct Prediction {
+        double medianMs = 0.0;
+        double sigmaLog = 0.0;  // log(ms) 的标准差
+        bool fromModel = false; // false 表示没有可用模型 (冷启动且无外推依据)
+        double quantileMs(double z) const;
+    };
+
+    // signature: 参数变换签名；fixedTimeoutMs: 没有可用模型时使用的超时 (原 TIMEOUT_MS)
+    RuntimePredictor(const std::string& historyPath, const std::string& signature, std::uint64_t meshBytes, int fixedTimeoutMs);
+    RuntimePredictor(const std::string& historyPath, const std::string& signature, std::uint64_t meshBytes, int fixedTimeoutMs, const Options& options);
+
+    Prediction predict(const std::vector<double>& params) const;
+
+    // 本次评估使用的超时
+    int timeoutFor(const std::vector<double>& params) const;
+
+    // 记录一次完成的评估；timedOut 的样本是右删失的 (真实耗时 > wallMs)，按放大后的耗时计入
+    void observe(const std::vector<double>& params, double wallMs, bool timedOut);
+
+    size_t sampleCount() const;
+
+    // 网格目录下所有文件的总字节数
+    static std::uint64_t directoryBytes(const std::string& dir);
+
+private:
+    struct Sample {
+        std::vector<double> params;
+        double logMs;
+    };
+
+    void load();
+    Prediction predictLocked(const std::vector<double>& params) const;
+
+    std::string m_historyPath;
+    std::string m_signature;
+    double m_meshMB;
+    int m_fixedTimeoutMs;
+    Options m_options;
+
+    mutable std::mutex m_mutex;
+    std::vector<Sample> m_samples;
+    double m_sumLog = 0.0;
+    double m_sumLog2 = 0.0;
+};
@@ -0,0 +1,176 @@
+#include "SensitivityScreening.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+// Utils/SensitivityScreening.cpp
+
+ParameterSubspace ParameterSubspace::full(const std::vector<double>& nominal) {
+    ParameterSubspace s;
+    s.nominal = nominal;
+    for (size_t i = 0; i < nominal.size(); ++i) s.activeIndices.push_back((int)i);
+    return s;
+}
+
+std::vector<double> ParameterSubspace::expand(const double* reduced) const {
+    std::vector<double> fullParams(nominal);
+    for (size_t i = 0; i < activeIndices.size(); ++i) fullParams[activeIndices[i]] = reduced[i];
+    return fullParams;
+}
+
+std::vector<double> ParameterSubspace::reduce(const std::vector<double>& fullParams) const {
+    std::vector<double> reduced;
+    for (int idx : activeIndices) reduced.push_back(fullParams[idx]);
+    return reduced;
+}
+
+ScreeningResult MorrisScreening::run(PatientEvaluator& evaluator, int trajectories, unsigned int seed) {
+    const auto& specs = evaluator.specs();
+    const int k = (int)specs.size();
+    const int levels = 4;
+    const double delta = levels / (2.0 * (levels - 1)); // 2/3
+
+    // 1. 生成轨迹：基点取 {0, 1/3} (保证 +Δ 后仍在 [0,1] 内)，按随机顺序逐维 +Δ
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> baseLevel(0, levels / 2 - 1);
+    std::vector<std::vector<double>> batch;
+    std::vector<std::vector<int>> orders;
+    for (int t = 0; t < trajectories; ++t) {
+        std::vector<double> x(k);
+        for (auto& v : x) v = baseLevel(rng) / (double)(levels - 1);
+        std::vector<int> order(k);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+
+        batch.push_back(x);
+        for (int dimIdx : order) {
+            x[dimIdx] += delta;
+            batch.push_back(x);
+        }
+        orders.push_back(order);
+    }
+
+    std::cout << ">>> [Screening] Morris: " << trajectories << " trajectories, " << batch.size() << " evaluations" << std::endl;
+    std::vector<double> costs = evaluator.evaluateBatch(batch);
+
+    // 2. 基本效应 EE_i = (f(x + Δe_i) - f(x)) / Δ
+    std::vector<std::vector<double>> ee(k);
+    for (int t = 0; t < trajectories; ++t) {
+        size_t base = (size_t)t * (k + 1);
+        for (int s = 0; s < k; ++s) {
+            double f0 = costs[base + s], f1 = costs[base + s + 1];
+            if (f0 >= PENALTY_THRESHOLD || f1 >= PENALTY_THRESHOLD) continue;
+            ee[orders[t][s]].push_back((f1 - f0) / delta);
+        }
+    }
+
+    ScreeningResult result;
+    for (int i = 0; i < k; ++i) {
+        double absSum = 0.0, sum = 0.0;
+        for (double e : ee[i]) { absSum += std::abs(e); sum += e; }
+        size_t n = ee[i].size();
+        double mean = n ? sum / n : 0.0;
+        double var = 0.0;
+        for (double e : ee[i]) var += (e - mean) * (e - mean);
+        result.names.push_back(specs[i].name);
+        result.muStar.push_back(n ? absSum / n : 0.0);
+        result.sigma.push_back(n > 1 ? std::sqrt(var / (n - 1)) : 0.0);
+        result.effects.push_back((int)n);
+    }
+    return result;
+}
+
+ParameterSubspace MorrisScreening::select(const ScreeningResult& result, const std::vector<double>& nominal,
+    double threshold, int minActive)
+{
+    ParameterSubspace subspace;
+    subspace.nominal = nominal;
+    const int k = (int)result.muStar.size();
+    double maxMu = 0.0;
+    for (double m : result.muStar) maxMu = std::max(maxMu, m);
+
+    // 没有任何有效效应的参数无法判断，保守地保留
+    std::vector<bool> active(k, false);
+    for (int i = 0; i < k; ++i) {
+        active[i] = result.effects[i] == 0 || result.muStar[i] >= threshold * maxMu;
+    }
+
+    // 活跃参数不足时按 μ* 从大到小补足
+    std::vector<int> ranked(k);
+    std::iota(ranked.begin(), ranked.end(), 0);
+    std::sort(ranked.begin(), ranked.end(), [&](int a, int b) { return result.muStar[a] > result.muStar[b]; });
+    int count = (int)std::count(active.begin(), active.end(), true);
+    for (int idx : ranked) {
+        if (count >= std::min(minActive, k)) break;
+        if (!active[idx]) { active[idx] = true; count++; }
+    }
+
+    for (int i = 0; i < k; ++i) if (active[i]) subspace.activeIndices.push_back(i);
+    return subspace;
+}
+
+bool MorrisScreening::load(const std::string& path, const std::vector<ParameterSpec>& specs, ScreeningResult& result) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    ScreeningResult loaded;
+    std::string line;
+    if (!std::getline(in, line) || line != transformSignature(specs)) return false;
+    std::getline(in, line); // 表头
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        // 名称,μ*,σ,效应数；任何一行不完整或无法解析 (如写到一半的文件) 都视为没有缓存
+        std::stringstream ss(line);
+        std::string name;
+        double mu = 0.0, sigma = 0.0;
+        int effects = 0;
+        char c1 = 0, c2 = 0;
+        if (!std::getline(ss, name, ',') || !(ss >> mu >> c1 >> sigma >> c2 >> effects) || c1 != ',' || c2 != ',') return false;
+        loaded.names.push_back(name);
+        loaded.muStar.push_back(mu);
+        loaded.sigma.push_back(sigma);
+        loaded.effects.push_back(effects);
+    }
+    if (loaded.names.size() != specs.size()) return false;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (loaded.names[i] != specs[i].name) return false;
+    }
+    result = loaded;
+    return true;
+}
+
+void MorrisScreening::save(const std::string& path, const std::vector<ParameterSpec>& specs, const ScreeningResult& result) {
+    // 先写临时文件再改名，中途退出不会留下半个缓存
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath);
+        out.precision(17);
+        out << transformSignature(specs) << "\n";
+        out << "Name,MuStar,Sigma,Effects\n";
+        for (size_t i = 0; i < result.names.size(); ++i) {
+            out << result.names[i] << "," << result.muStar[i] << "," << result.sigma[i] << "," << result.effects[i] << "\n";
+        }
+        if (!out.good()) return;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) std::cerr << "[Screening] Failed to write " << path << ": " << ec.message() << std::endl;
+}
+
+void MorrisScreening::print(const std::string& patientName, const ScreeningResult& result, const ParameterSubspace& subspace) {
+    std::vector<bool> active(result.names.size(), false);
+    for (int idx : subspace.activeIndices) active[idx] = true;
+
+    std::cout << "[Screening] " << patientName << " | " << subspace.dim() << "/" << result.names.size() << " parameters active" << std::endl;
+    for (size_t i = 0; i < result.names.size(); ++i) {
+        std::cout << "  " << std::left << std::setw(22) << result.names[i] << std::right
+            << " mu* " << std::setw(12) << result.muStar[i]
+            << "  sigma " << std::setw(12) << result.sigma[i]
+            << "  n " << result.effects[i]
+            << (active[i] ? "" : "  [frozen @ " + std::to_string(subspace.nominal[i]) + "]") << std::endl;
+    }
+}
@@ -0,0 +1,46 @@
+// Utils/SensitivityScreening.h
+#pragma once
+#include <string>
+#include <vector>
+#include "Common.h"
+#include "PatientEvaluator.h"
+
+// 冻结部分参数后的优化子空间：优化器只在活跃维度上搜索，评估前按名义值补全为完整参数向量
+struct ParameterSubspace {
+    std::vector<int> activeIndices;   // 活跃参数在完整向量中的下标
+    std::vector<double> nominal;      // 完整维度的归一化名义值 (冻结参数取此值)
+
+    static ParameterSubspace full(const std::vector<double>& nominal);
+
+    int dim() const { return (int)activeIndices.size(); }
+    bool isFull() const { return activeIndices.size() == nominal.size(); }
+
+    std::vector<double> expand(const double* reduced) const;
+    std::vector<double> expand(const std::vector<double>& reduced) const { return expand(reduced.data()); }
+    std::vector<double> reduce(const std::vector<double>& fullParams) const;
+};
+
+// Morris 基本效应筛选 (每个病人一次)
+// r 条轨迹，每条 k+1 个点 (p=4 水平网格，步长 Δ=2/3)，全部点作为一个批次并发评估。
+// μ* = mean|EE| 衡量影响大小，σ = std(EE) 衡量非线性/交互。惩罚值 (求解失败) 所在的效应被丢弃。
+struct ScreeningResult {
+    std::vector<std::string> names;
+    std::vector<double> muStar;
+    std::vector<double> sigma;
+    std::vector<int> effects;        // 每个参数有效的基本效应个数
+};
+
+class MorrisScreening {
+public:
+    static ScreeningResult run(PatientEvaluator& evaluator, int trajectories, unsigned int seed = 2024);
+
+    // μ* 低于 threshold * max(μ*) 的参数视为不敏感并冻结；至少保留 minActive 个活跃参数
+    static ParameterSubspace select(const ScreeningResult& result, const std::vector<double>& nominal,
+        double threshold, int minActive);
+
+    // 结果缓存 (outputDir/screening.csv)，参数名或变换签名 (transformSignature) 不一致时视为无效
+    static bool load(const std::string& path, const std::vector<ParameterSpec>& specs, ScreeningResult& result);
+    static void save(const std::string& path, const std::vector<ParameterSpec>& specs, const ScreeningResult& result);
+
+    static void print(const std::string& patientName, const ScreeningResult& result, const ParameterSubspace& subspace);
+};
@@ -0,0 +1,61 @@
+#include "StoppingRules.h"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+// Utils/StoppingRules.cpp
+
+bool StopMonitor::check(int evaluations, double bestCost, double elapsedSeconds, bool checkStagnation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped) return true;
+
+    // 停滞：相对参照值的改进超过容差才刷新参照点 (尚无有效结果时不计)
+    if (bestCost < PENALTY_THRESHOLD) {
+        if (m_referenceCost >= PENALTY_THRESHOLD ||
+            bestCost < m_referenceCost - m_rules.stagnationTolerance * std::abs(m_referenceCost)) {
+            m_referenceCost = bestCost;
+            m_referenceEvaluations = evaluations;
+        }
+    }
+
+    std::ostringstream reason;
+    if (m_rules.targetCost > 0.0 && bestCost <= m_rules.targetCost) {
+        reason << "target cost " << m_rules.targetCost << " reached";
+    }
+    else if (m_rules.maxEvaluations > 0 && evaluations >= m_rules.maxEvaluations) {
+        reason << "evaluation budget (" << m_rules.maxEvaluations << ") exhausted";
+    }
+    else if (m_rules.maxHours > 0.0 && elapsedSeconds >= m_rules.maxHours * 3600.0) {
+        reason << "time budget (" << m_rules.maxHours << " h) exhausted";
+    }
+    else if (checkStagnation && m_rules.stagnationEvaluations > 0 && m_referenceCost < PENALTY_THRESHOLD &&
+        evaluations - m_referenceEvaluations >= m_rules.stagnationEvaluations) {
+        reason << "stagnation: no improvement > " << m_rules.stagnationTolerance * 100.0 << "% in "
+            << evaluations - m_referenceEvaluations << " evaluations";
+    }
+    else {
+        return false;
+    }
+    stopLocked(reason.str());
+    return true;
+}
+
+void StopMonitor::finish(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_stopped) stopLocked(reason);
+}
+
+void StopMonitor::stopLocked(const std::string& reason) {
+    m_stopped = true;
+    m_reason = reason;
+    std::cout << ">>> [Stop] " << reason << std::endl;
+}
+
+bool StopMonitor::stopped() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stopped;
+}
+
+std::string StopMonitor::reason() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_reason;
+}
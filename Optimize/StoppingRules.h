@@ -0,0 +1,46 @@
+// Utils/StoppingRules.h
+#pragma once
+#include <string>
+#include <mutex>
+#include "Common.h"
+
+// 每个病人的停止规则 (0 表示不启用该项)
+struct StoppingRules {
+    // 病人级：对 CMA-ES 的所有种群/重启与 BayesOpt 的整次运行生效
+    int maxEvaluations = 0;              // 评估次数上限 (含参数筛选的评估)
+    double maxHours = 0.0;               // 墙钟时间上限
+    double targetCost = 0.0;             // 最优误差不高于该值即停止
+    int stagnationEvaluations = 0;       // 连续这么多次评估最优值的相对改进都不超过 stagnationTolerance 时停止
+                                         // (有 CMA-ES 重启策略时只在两次运行之间判定，重启后的新运行不会被中途截断)
+    double stagnationTolerance = 1e-3;
+
+    // 单次 CMA-ES 运行：满足后结束当前运行 (有重启策略时进入下一次重启)
+    double sigmaTolerance = 0.0;         // 步长 (归一化参数空间) 低于该值
+    double costTolerance = 0.0;          // 最近若干代的最优值波动低于该值
+};
+
+// 线程安全的停止判定，并记录第一个触发的原因 (多个 CMA-ES 种群共享)
+class StopMonitor {
+public:
+    explicit StopMonitor(const StoppingRules& rules) : m_rules(rules) {}
+
+    // 每代 / 每次迭代结束后调用；已停止或满足任一病人级规则时返回 true
+    // checkStagnation = false 时仍更新停滞参照点，但不据此停止 (重启策略下的代内检查)
+    bool check(int evaluations, double bestCost, double elapsedSeconds, bool checkStagnation = true);
+
+    // 优化器自身结束 (迭代/重启次数用完、异常等)；已有停止原因时不覆盖
+    void finish(const std::string& reason);
+
+    bool stopped() const;
+    std::string reason() const;
+
+private:
+    void stopLocked(const std::string& reason);
+
+    StoppingRules m_rules;
+    mutable std::mutex m_mutex;
+    bool m_stopped = false;
+    std::string m_reason;
+    double m_referenceCost = 1e9;        // 停滞判定的参照最优值及其出现时的评估次数
+    int m_referenceEvaluations = 0;
+};
@@ -0,0 +1,443 @@
+#include "TrustRegionBO.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+TrustRegionBO::TrustRegionBO(int dim, const Options& options, unsigned int seed)
+    : m_dim(std::max(1, dim)), m_options(options), m_rng(seed), m_length(options.lengthInit)
+{
+    m_center = Eigen::VectorXd::Constant(m_dim, 0.5);
+    startRegion(false);
+}
+
+void TrustRegionBO::setInitialPoints(const std::vector<std::vector<double>>& points) {
+    m_seedPoints.clear();
+    for (const auto& p : points) {
+        if ((int)p.size() != m_dim) continue;
+        Eigen::VectorXd x(m_dim);
+        for (int i = 0; i < m_dim; ++i) x[i] = std::clamp(p[i], 0.0, 1.0);
+        m_seedPoints.push_back(x);
+    }
+    // 尚未开始评估时重新生成首个信赖域的初始设计
+    if (m_y.empty() && m_outstandingInit == 0) startRegion(false);
+}
+
+// 新的信赖域：在全空间做拉丁超立方初始设计 (首个信赖域的前若干点使用给定的种子点)
+void TrustRegionBO::startRegion(bool restart) {
+    int n = m_options.initialSamples > 0 ? m_options.initialSamples : std::max(4, 2 * m_dim);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::vector<Eigen::VectorXd> design(n, Eigen::VectorXd(m_dim));
+    std::vector<int> strata(n);
+    for (int c = 0; c < m_dim; ++c) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), m_rng);
+        for (int r = 0; r < n; ++r) design[r][c] = (strata[r] + uni(m_rng)) / n;
+    }
+    if (!restart) {
+        for (int r = 0; r < n && r < (int)m_seedPoints.size(); ++r) design[r] = m_seedPoints[r];
+    }
+    // ask() 从尾部取点，反转后种子点最先发出
+    m_pending.assign(design.rbegin(), design.rend());
+
+    m_centerIndex = -1;
+    m_regionBest = 1e300;
+    m_length = m_options.lengthInit;
+    m_successes = 0;
+    m_failures = 0;
+    m_modelValid = false;
+    if (restart) m_restarts++;
+}
+
+std::vector<double> TrustRegionBO::bestPoint() const {
+    if (m_bestIndex < 0) return {};
+    const Eigen::VectorXd& x = m_x[m_bestIndex];
+    return std::vector<double>(x.data(), x.data() + x.size());
+}
+
+// =========================================================
+// 局部 GP
+// =========================================================
+double TrustRegionBO::kernel(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double lengthscale) const {
+    // Matérn-5/2，信号方差为 1 (目标值已标准化)
+    double r = std::sqrt(5.0) * (a - b).norm() / lengthscale;
+    return (1.0 + r + r * r / 3.0) * std::exp(-r);
+}
+
+double TrustRegionBO::kernel(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const {
+    return kernel(a, b, m_lengthscale);
+}
+
+void TrustRegionBO::box(Eigen::VectorXd& lower, Eigen::VectorXd& upper) const {
+    lower = (m_center.array() - 0.5 * m_length).max(0.0).matrix();
+    upper = (m_center.array() + 0.5 * m_length).min(1.0).matrix();
+}
+
+// 信赖域内离中心最近的至多 maxLocalPoints 个观测；域内太少时用域外最近的点补足，保证模型可用
+std::vector<int> TrustRegionBO::selectLocal() const {
+    Eigen::VectorXd lower, upper;
+    box(lower, upper);
+    const int total = (int)m_x.size();
+    const int minLocal = std::min(total, 2 * m_dim + 2);
+    const int maxLocal = std::max(minLocal, m_options.maxLocalPoints);
+
+    std::vector<std::pair<double, int>> inside, outside;
+    for (int i = 0; i < total; ++i) {
+        const Eigen::VectorXd& x = m_x[i];
+        double dist = (x - m_center).squaredNorm();
+        bool in = (x.array() >= lower.array() - 1e-12).all() && (x.array() <= upper.array() + 1e-12).all();
+        (in ? inside : outside).push_back({ dist, i });
+    }
+    std::vector<int> local;
+    auto takeNearest = [&](std::vector<std::pair<double, int>>& pool, int count) {
+        count = std::min(count, (int)pool.size());
+        std::partial_sort(pool.begin(), pool.begin() + count, pool.end());
+        for (int k = 0; k < count; ++k) local.push_back(pool[k].second);
+    };
+    takeNearest(inside, maxLocal);
+    if ((int)local.size() < minLocal) takeNearest(outside, minLocal - (int)local.size());
+    // 按观测顺序排列，之后的新观测在末尾追加
+    std::sort(local.begin(), local.end());
+    return local;
+}
+
+double TrustRegionBO::logLikelihood(const std::vector<int>& local, const Eigen::VectorXd& y, double lengthscale, double noise) const {
+    const int n = (int)local.size();
+    Eigen::MatrixXd K(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) K(i, j) = K(j, i) = kernel(m_x[local[i]], m_x[local[j]], lengthscale);
+        K(i, i) += noise;
+    }
+    Eigen::LLT<Eigen::MatrixXd> llt(K);
+    if (llt.info() != Eigen::Success) return -std::numeric_limits<double>::infinity();
+    Eigen::VectorXd alpha = llt.solve(y);
+    double logDet = 0.0;
+    for (int i = 0; i < n; ++i) logDet += std::log(llt.matrixL()(i, i));
+    return -0.5 * y.dot(alpha) - logDet;
+}
+
+void TrustRegionBO::rebuildModel(bool refit) {
+    m_local = selectLocal();
+    const int n = (int)m_local.size();
+    if (n == 0) {
+        m_modelValid = false;
+        return;
+    }
+
+    if (refit && n >= 3) {
+        // 超参数网格：长度尺度相对信赖域边长取值，噪声相对标准化后的信号方差
+        Eigen::VectorXd y(n);
+        for (int i = 0; i < n; ++i) y[i] = m_y[m_local[i]];
+        double mean = y.mean();
+        double scale = std::sqrt((y.array() - mean).square().sum() / n);
+        y = (y.array() - mean) / (scale > 1e-12 ? scale : 1.0);
+
+        static const double lengthFactors[] = { 0.05, 0.1, 0.2, 0.35, 0.5, 0.75, 1.0, 1.5, 2.5, 4.0 };
+        static const double noises[] = { 1e-6, 1e-4, 1e-2, 5e-2 };
+        std::vector<std::pair<double, double>> grid;
+        for (double f : lengthFactors) {
+            for (double noise : noises) grid.push_back({ std::clamp(f * m_length, 1e-3, 5.0), noise });
+        }
+        std::vector<double> scores(grid.size());
+        parallelFor((int)grid.size(), 1, [&](int begin, int end, std::mt19937&) {
+            for (int g = begin; g < end; ++g) scores[g] = logLikelihood(m_local, y, grid[g].first, grid[g].second);
+        });
+        int best = (int)(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        if (std::isfinite(scores[best])) {
+            m_lengthscale = grid[best].first;
+            m_noise = grid[best].second;
+        }
+        m_sinceRefit = 0;
+    }
+
+    // 分解失败 (点几乎重合) 时逐步加大噪声
+    for (int attempt = 0; attempt < 6; ++attempt) {
+        Eigen::MatrixXd K(n, n);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j <= i; ++j) K(i, j) = K(j, i) = kernel(m_x[m_local[i]], m_x[m_local[j]]);
+            K(i, i) += m_noise;
+        }
+        Eigen::LLT<Eigen::MatrixXd> llt(K);
+        if (llt.info() == Eigen::Success) {
+            m_chol = llt.matrixL();
+            m_modelValid = true;
+            updateWeights();
+            return;
+        }
+        m_noise *= 10.0;
+    }
+    m_modelValid = false;
+}
+
+// 新观测在信赖域内、局部点数未满时直接扩展 Cholesky 因子：
+// [L 0; l^T d]，其中 L l = k，d = sqrt(k(x,x) + noise - l^T l)
+bool TrustRegionBO::appendToModel(int index) {
+    const int n = (int)m_local.size();
+    if (!m_modelValid || n >= std::max(m_options.maxLocalPoints, 2 * m_dim + 2)) return false;
+    Eigen::VectorXd lower, upper;
+    box(lower, upper);
+    const Eigen::VectorXd& x = m_x[index];
+    if ((x.array() < lower.array() - 1e-12).any() || (x.array() > upper.array() + 1e-12).any()) return false;
+
+    Eigen::VectorXd k(n);
+    for (int i = 0; i < n; ++i) k[i] = kernel(m_x[m_local[i]], x);
+    Eigen::VectorXd l = m_chol.triangularView<Eigen::Lower>().solve(k);
+    double d2 = 1.0 + m_noise - l.squaredNorm();
+    if (d2 <= 1e-12) return false;
+
+    m_chol.conservativeResize(n + 1, n + 1);
+    m_chol.col(n).setZero();
+    m_chol.row(n).head(n) = l.transpose();
+    m_chol(n, n) = std::sqrt(d2);
+    m_local.push_back(index);
+    updateWeights();
+    return true;
+}
+
+// 目标值按局部观测标准化后求 alpha (O(n^2))
+void TrustRegionBO::updateWeights() {
+    const int n = (int)m_local.size();
+    Eigen::VectorXd y(n);
+    for (int i = 0; i < n; ++i) y[i] = m_y[m_local[i]];
+    m_yMean = y.mean();
+    double scale = std::sqrt((y.array() - m_yMean).square().sum() / n);
+    m_yScale = scale > 1e-12 ? scale : 1.0;
+    y = (y.array() - m_yMean) / m_yScale;
+    m_yBest = y.minCoeff();
+    m_alpha = m_chol.triangularView<Eigen::Lower>().solve(y);
+    m_chol.triangularView<Eigen::Lower>().transpose().solveInPlace(m_alpha);
+}
+
+TrustRegionBO::Prediction TrustRegionBO::predict(const Eigen::VectorXd& x) const {
+    const int n = (int)m_local.size();
+    Eigen::VectorXd k(n);
+    for (int i = 0; i < n; ++i) k[i] = kernel(m_x[m_local[i]], x);
+    Eigen::VectorXd v = m_chol.triangularView<Eigen::Lower>().solve(k);
+    double var = std::max(1e-12, 1.0 - v.squaredNorm());
+    return { k.dot(m_alpha), std::sqrt(var) };
+}
+
+double TrustRegionBO::expectedImprovement(const Eigen::VectorXd& x) const {
+    Prediction p = predict(x);
+    double z = (m_yBest - p.mean) / p.stddev;
+    const double invSqrt2Pi = 0.3989422804014327;
+    double pdf = invSqrt2Pi * std::exp(-0.5 * z * z);
+    // 远离最优时 EI 下溢为 0，用渐近式 σ φ(z) / z^2 保持候选点之间的排序
+    if (z < -6.0) return p.stddev * pdf / (z * z);
+    double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+    return p.stddev * (z * cdf + pdf);
+}
+
+// =========================================================
+// 建议与更新
+// =========================================================
+int TrustRegionBO::threadCount() const {
+    if (m_options.threads > 0) return m_options.threads;
+    return std::max(1, std::min(8, (int)std::thread::hardware_concurrency()));
+}
+
+void TrustRegionBO::parallelFor(int count, int grain, const std::function<void(int, int, std::mt19937&)>& body) {
+    grain = std::max(1, grain);
+    int threads = std::min(threadCount(), (count + grain - 1) / grain);
+    std::vector<std::mt19937> rngs;
+    for (int t = 0; t < std::max(1, threads); ++t) rngs.emplace_back(m_rng());
+    if (threads <= 1) {
+        body(0, count, rngs[0]);
+        return;
+    }
+    std::vector<std::thread> pool;
+    int chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        int begin = t * chunk, end = std::min(count, begin + chunk);
+        if (begin >= end) break;
+        pool.emplace_back(body, begin, end, std::ref(rngs[t]));
+    }
+    for (auto& th : pool) th.join();
+}
+
+std::vector<std::vector<double>> TrustRegionBO::ask(int q) {
+    auto start = std::chrono::steady_clock::now();
+    q = std::max(1, q);
+    std::vector<Eigen::VectorXd> chosen;
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    if (!m_pending.empty()) {
+        // 初始设计阶段
+        while ((int)chosen.size() < q && !m_pending.empty()) {
+            chosen.push_back(m_pending.back());
+            m_pending.pop_back();
+        }
+        m_outstandingInit += (int)chosen.size();
+    }
+    else if (m_y.empty()) {
+        // 初始设计已全部发出但尚无结果：均匀随机补点
+        for (int k = 0; k < q; ++k) {
+            Eigen::VectorXd x(m_dim);
+            for (int i = 0; i < m_dim; ++i) x[i] = uni(m_rng);
+            chosen.push_back(x);
+        }
+    }
+    else {
+        if (m_centerIndex < 0) {
+            m_centerIndex = m_bestIndex;
+            m_center = m_x[m_bestIndex];
+            m_modelValid = false;
+        }
+        bool refit = m_sinceRefit >= m_options.refitInterval;
+        if (!m_modelValid || refit) rebuildModel(refit);
+
+        Eigen::VectorXd lower, upper;
+        box(lower, upper);
+        Eigen::VectorXd width = upper - lower;
+
+        // 1. 域内随机候选：每个候选只扰动部分维度 (高维时保持在中心附近)
+        const int nc = std::max(q, m_options.candidates);
+        const double perturbProb = std::min(1.0, 20.0 / m_dim);
+        std::vector<Eigen::VectorXd> pool(nc);
+        std::vector<double> scores(nc);
+        parallelFor(nc, 32, [&](int begin, int end, std::mt19937& rng) {
+            std::uniform_real_distribution<double> u(0.0, 1.0);
+            std::uniform_int_distribution<int> pick(0, m_dim - 1);
+            for (int c = begin; c < end; ++c) {
+                Eigen::VectorXd x = m_center;
+                bool any = false;
+                for (int i = 0; i < m_dim; ++i) {
+                    if (u(rng) < perturbProb) {
+                        x[i] = lower[i] + u(rng) * width[i];
+                        any = true;
+                    }
+                }
+                if (!any) {
+                    int i = pick(rng);
+                    x[i] = lower[i] + u(rng) * width[i];
+                }
+                pool[c] = x;
+                scores[c] = m_modelValid ? expectedImprovement(x) : u(rng);
+            }
+        });
+
+        // 2. 从最好的若干候选出发做局部随机搜索 (各起点并行)
+        std::vector<int> order(nc);
+        std::iota(order.begin(), order.end(), 0);
+        const int starts = std::min(nc, std::max(q, m_options.starts));
+        std::partial_sort(order.begin(), order.begin() + starts, order.end(),
+            [&](int a, int b) { return scores[a] > scores[b]; });
+        if (m_modelValid) {
+            std::vector<Eigen::VectorXd> refined(starts);
+            std::vector<double> refinedScores(starts);
+            parallelFor(starts, 1, [&](int begin, int end, std::mt19937& rng) {
+                std::normal_distribution<double> gauss(0.0, 1.0);
+                for (int s = begin; s < end; ++s) {
+                    Eigen::VectorXd x = pool[order[s]];
+                    double score = scores[order[s]];
+                    Eigen::VectorXd step = 0.25 * width;
+                    for (int it = 0; it < m_options.localSteps; ++it) {
+                        Eigen::VectorXd trial(m_dim);
+                        for (int i = 0; i < m_dim; ++i) trial[i] = std::clamp(x[i] + step[i] * gauss(rng), lower[i], upper[i]);
+                        double trialScore = expectedImprovement(trial);
+                        if (trialScore > score) {
+                            x = trial;
+                            score = trialScore;
+                        }
+                        else {
+                            step *= 0.7;
+                        }
+                    }
+                    refined[s] = x;
+                    refinedScores[s] = score;
+                }
+            });
+            for (int s = 0; s < starts; ++s) {
+                pool.push_back(refined[s]);
+                scores.push_back(refinedScores[s]);
+            }
+            order.resize(pool.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](int a, int b) { return scores[a] > scores[b]; });
+        }
+
+        // 3. 按采集函数值依次取点，批内点之间保持最小间距
+        const double minSeparation = 0.05 * m_length;
+        for (int idx : order) {
+            if ((int)chosen.size() >= q) break;
+            bool separated = true;
+            for (const auto& c : chosen) {
+                if ((c - pool[idx]).lpNorm<Eigen::Infinity>() < minSeparation) {
+                    separated = false;
+                    break;
+                }
+            }
+            if (separated) chosen.push_back(pool[idx]);
+        }
+        for (int idx : order) {
+            if ((int)chosen.size() >= q) break;
+            chosen.push_back(pool[idx]);
+        }
+    }
+
+    std::vector<std::vector<double>> out;
+    for (const auto& x : chosen) out.emplace_back(x.data(), x.data() + x.size());
+    m_lastSuggestMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+void TrustRegionBO::tell(const std::vector<std::vector<double>>& points, const std::vector<double>& costs) {
+    const int count = (int)std::min(points.size(), costs.size());
+    if (count == 0) return;
+
+    const bool initBatch = m_outstandingInit > 0;
+    m_outstandingInit = std::max(0, m_outstandingInit - count);
+
+    int batchBest = -1;
+    for (int k = 0; k < count; ++k) {
+        Eigen::VectorXd x(m_dim);
+        for (int i = 0; i < m_dim; ++i) x[i] = std::clamp(points[k][i], 0.0, 1.0);
+        double cost = std::isfinite(costs[k]) ? costs[k] : 1e300;
+        m_x.push_back(x);
+        m_y.push_back(cost);
+        int index = (int)m_y.size() - 1;
+        if (cost < m_bestCost) {
+            m_bestCost = cost;
+            m_bestIndex = index;
+        }
+        if (batchBest < 0 || cost < m_y[batchBest]) batchBest = index;
+        m_sinceRefit++;
+        if (m_modelValid && !appendToModel(index)) m_modelValid = false;
+    }
+
+    double batchCost = m_y[batchBest];
+    bool improved = batchCost < m_regionBest - 1e-3 * std::abs(m_regionBest);
+    if (batchCost < m_regionBest) {
+        // 中心移到新的域内最优点 (局部点集随之改变，下次建议时重建模型)
+        m_regionBest = batchCost;
+        m_centerIndex = batchBest;
+        m_center = m_x[batchBest];
+        m_modelValid = false;
+    }
+    if (initBatch || !m_pending.empty() || m_outstandingInit > 0) return;
+
+    // TuRBO 的信赖域调整
+    if (improved) {
+        m_successes++;
+        m_failures = 0;
+    }
+    else {
+        m_failures++;
+        m_successes = 0;
+    }
+    int failureTolerance = m_options.failureTolerance > 0 ? m_options.failureTolerance
+        : (int)std::ceil(std::max(4.0, (double)m_dim) / count);
+    if (m_successes >= m_options.successTolerance) {
+        m_length = std::min(2.0 * m_length, m_options.lengthMax);
+        m_successes = 0;
+        m_modelValid = false;
+    }
+    else if (m_failures >= failureTolerance) {
+        m_length *= 0.5;
+        m_failures = 0;
+        m_modelValid = false;
+    }
+    if (m_length < m_options.lengthMin) startRegion(true);
+}
@@ -0,0 +1,105 @@
+// Utils/TrustRegionBO.h
+#pragma once
+#include <vector>
+#include <random>
+#include <functional>
+#include <Eigen/Dense>
+
+// 信赖域贝叶斯优化 (TuRBO 风格)，用于评估次数较多的长时间运行
+//
+// 精确 GP 的拟合与超参数学习随观测数立方增长，运行到后期每次迭代在优化器内部的耗时会接近一次仿真。
+// 这里只在当前信赖域 (以域内最优点为中心、边长 length 的超立方体) 内最多 maxLocalPoints 个观测上建立局部 GP：
+//   - 新观测落在域内且中心与超参数不变时，Cholesky 分解按行追加 (O(n^2))，否则整体重建 (O(n^3)，n 有上限)
+//   - 超参数 (各向同性 Matérn-5/2 的长度尺度与噪声) 每 refitInterval 个观测在网格上按边际似然重新选择
+//   - 采集函数 (EI) 在域内随机候选点上并行计算，再从最好的若干点出发做多起点局部搜索
+//   - 连续成功扩大信赖域、连续失败缩小，缩小到 lengthMin 以下时在全空间重新做初始设计 (重启)
+// 因此每次建议的开销只取决于 maxLocalPoints 与候选数，与累计观测数 (几千个也一样) 基本无关。
+// 搜索空间为 [0,1]^d (归一化子空间)，目标为最小化。
+class TrustRegionBO {
+public:
+    struct Options {
+        int initialSamples = 0;      // 每个信赖域的初始设计点数 (0 表示 max(4, 2 * 维度))
+        int maxLocalPoints = 128;    // 局部 GP 使用的观测数上限 (决定每次建议的开销上限)
+        int candidates = 1024;       // 采集函数的随机候选点数
+        int starts = 8;              // 多起点局部搜索的起点数
+        int localSteps = 24;         // 每个起点的局部搜索步数
+        int threads = 0;             // 采集函数优化的线程数 (0 表示 min(硬件线程数, 8))
+        int refitInterval = 10;      // 每新增这么多观测重新选择一次超参数
+        double lengthInit = 0.8;     // 信赖域边长 (归一化空间)
+        double lengthMin = 0.0078125;
+        double lengthMax = 1.6;
+        int successTolerance = 3;    // 连续成功次数达到后边长加倍
+        int failureTolerance = 0;    // 连续失败次数达到后边长减半 (0 表示 ceil(max(4, 维度) / 批大小))
+    };
+
+    TrustRegionBO(int dim, const Options& options, unsigned int seed = 2024);
+
+    // 初始设计中优先使用的点 (如热启动先验样本)，其余由拉丁超立方补足
+    void setInitialPoints(const std::vector<std::vector<double>>& points);
+
+    // 提出至多 q 个待评估点 (初始设计阶段返回剩余的设计点)
+    std::vector<std::vector<double>> ask(int q);
+
+    // 报告一批结果；成功/失败按批统计 (批内最优值改进了信赖域最优即为一次成功)
+    void tell(const std::vector<std::vector<double>>& points, const std::vector<double>& costs);
+
+    int observations() const { return (int)m_y.size(); }
+    double bestCost() const { return m_bestCost; }
+    std::vector<double> bestPoint() const;
+    double length() const { return m_length; }
+    int restarts() const { return m_restarts; }
+    int localPoints() const { return (int)m_local.size(); }
+    double lastSuggestMs() const { return m_lastSuggestMs; }
+
+private:
+    // 局部 GP：标准化后的目标值、Cholesky 因子与 alpha = K^-1 y
+    struct Prediction { double mean; double stddev; };
+
+    void startRegion(bool restart);
+    std::vector<int> selectLocal() const;
+    void rebuildModel(bool refit);
+    bool appendToModel(int index);
+    void updateWeights();
+    double kernel(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+    double kernel(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double lengthscale) const;
+    double logLikelihood(const std::vector<int>& local, const Eigen::VectorXd& y, double lengthscale, double noise) const;
+    Prediction predict(const Eigen::VectorXd& x) const;
+    double expectedImprovement(const Eigen::VectorXd& x) const;
+    void box(Eigen::VectorXd& lower, Eigen::VectorXd& upper) const;
+    int threadCount() const;
+    // 把 [0, count) 分块并行执行；每个线程至少 grain 项 (廉价的逐项工作取较大的 grain，避免线程开销占主导)
+    void parallelFor(int count, int grain, const std::function<void(int, int, std::mt19937&)>& body);
+
+    int m_dim;
+    Options m_options;
+    std::mt19937 m_rng;
+
+    // 全部观测
+    std::vector<Eigen::VectorXd> m_x;
+    std::vector<double> m_y;
+    int m_bestIndex = -1;
+    double m_bestCost = 1e300;
+
+    // 当前信赖域
+    Eigen::VectorXd m_center;
+    int m_centerIndex = -1;          // 信赖域内最优观测 (中心)；-1 表示尚在初始设计阶段
+    double m_regionBest = 1e300;
+    double m_length;
+    int m_successes = 0;
+    int m_failures = 0;
+    int m_restarts = 0;
+    std::vector<Eigen::VectorXd> m_pending;     // 尚未发出的初始设计点
+    std::vector<Eigen::VectorXd> m_seedPoints;  // 首个信赖域优先使用的点
+    int m_outstandingInit = 0;                  // 已发出但未报告的初始设计点
+
+    // 局部 GP
+    std::vector<int> m_local;
+    Eigen::MatrixXd m_chol;          // 下三角 Cholesky 因子 (有效部分为前 m_local.size() 行列)
+    Eigen::VectorXd m_alpha;
+    double m_yMean = 0.0, m_yScale = 1.0, m_yBest = 0.0;
+    double m_lengthscale = 0.2;
+    double m_noise = 1e-4;
+    bool m_modelValid = false;
+    int m_sinceRefit = 1 << 30;      // 首次建模时拟合超参数
+    double m_lastSuggestMs = 0.0;
+};
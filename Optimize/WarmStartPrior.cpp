@@ -0,0 +1,320 @@
+#include "WarmStartPrior.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+// Utils/WarmStartPrior.cpp
+
+namespace fs = std::filesystem;
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+static std::vector<std::string> splitCsv(const std::string& line) {
+    std::vector<std::string> cells;
+    std::stringstream ss(line);
+    std::string cell;
+    while (std::getline(ss, cell, ',')) cells.push_back(trim(cell));
+    // 末尾的空字段 (如没有阶段耗时的日志行 "...,Cost,") 也算一列
+    std::string trimmed = trim(line);
+    if (!trimmed.empty() && trimmed.back() == ',') cells.push_back("");
+    return cells;
+}
+
+std::vector<double> WarmStartPrior::stddev() const {
+    std::vector<double> s(mean.size(), 0.0);
+    for (size_t i = 0; i < mean.size(); ++i) s[i] = std::sqrt(std::max(0.0, covariance[i][i]));
+    return s;
+}
+
+std::vector<std::vector<double>> WarmStartPrior::sample(int count, unsigned int seed) const {
+    const size_t d = mean.size();
+
+    // Cholesky 分解 C = L L^T (收缩后的协方差正定，对角线加微小抖动防止数值问题)
+    std::vector<std::vector<double>> L(d, std::vector<double>(d, 0.0));
+    for (size_t i = 0; i < d; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double sum = covariance[i][j];
+            for (size_t k = 0; k < j; ++k) sum -= L[i][k] * L[j][k];
+            if (i == j) L[i][i] = std::sqrt(std::max(sum + 1e-12, 1e-12));
+            else L[i][j] = sum / L[j][j];
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<std::vector<double>> samples;
+    for (int n = 0; n < count; ++n) {
+        std::vector<double> z(d), x(mean);
+        for (auto& v : z) v = normal(rng);
+        for (size_t i = 0; i < d; ++i) {
+            for (size_t k = 0; k <= i; ++k) x[i] += L[i][k] * z[k];
+            x[i] = std::max(0.0, std::min(1.0, x[i]));
+        }
+        samples.push_back(x);
+    }
+    return samples;
+}
+
+std::string WarmStart::patientRootOf(const std::string& outputDir) {
+    fs::path p(outputDir);
+    if (!p.has_filename()) p = p.parent_path(); // 去掉结尾的 '/'
+    return p.parent_path().string() + "/";
+}
+
+std::string WarmStart::datasetRootOf(const std::string& outputDir) {
+    fs::path root(patientRootOf(outputDir));
+    return root.parent_path().parent_path().string() + "/";
+}
+
+std::map<std::string, double> WarmStart::readDescriptors(const std::string& patientRoot) {
+    std::map<std::string, double> descriptors;
+    std::ifstream in(patientRoot + "descriptors.txt");
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::string name;
+        double value;
+        if (ss >> name >> value) descriptors[name] = value;
+    }
+    return descriptors;
+}
+
+void WarmStart::saveResult(const std::string& outputDir, const std::string& stentTypeStr,
+    const std::vector<ParameterSpec>& specs, const std::vector<double>& bestParams, double cost, int evaluations)
+{
+    if (cost >= PENALTY_THRESHOLD || bestParams.size() != specs.size()) return;
+
+    // 重复优化同一病人时只保留更好的结果
+    CalibrationRecord existing;
+    if (loadResult(outputDir + "calibration_result.csv", existing) && existing.cost <= cost) return;
+
+    CalibrationRecord record;
+    record.stentTypeStr = stentTypeStr;
+    record.cost = cost;
+    record.evaluations = evaluations;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        record.physical[specs[i].name] = specs[i].toPhysical(bestParams[i]);
+    }
+    saveRecord(outputDir, record);
+}
+
+void WarmStart::saveRecord(const std::string& outputDir, const CalibrationRecord& record) {
+    std::ofstream out(outputDir + "calibration_result.csv");
+    out << "Key,Value\n";
+    out << "StentType," << record.stentTypeStr << "\n";
+    out << "Cost," << std::setprecision(10) << record.cost << "\n";
+    out << "Evaluations," << record.evaluations << "\n";
+    for (const auto& kv : record.physical) out << "Param." << kv.first << "," << kv.second << "\n";
+}
+
+bool WarmStart::loadResult(const std::string& path, CalibrationRecord& record) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    std::string line;
+    std::getline(in, line); // 表头
+    while (std::getline(in, line)) {
+        std::vector<std::string> cells = splitCsv(line);
+        if (cells.size() < 2) continue;
+        try {
+            if (cells[0] == "StentType") record.stentTypeStr = cells[1];
+            else if (cells[0] == "Cost") record.cost = std::stod(cells[1]);
+            else if (cells[0] == "Evaluations") record.evaluations = std::stoi(cells[1]);
+            else if (cells[0].rfind("Param.", 0) == 0) record.physical[cells[0].substr(6)] = std::stod(cells[1]);
+        }
+        catch (...) { return false; }
+    }
+    return !record.physical.empty();
+}
+
+bool WarmStart::loadBestFromLog(const std::string& path, CalibrationRecord& record) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    // 表头：Iteration,<参数名>...,Cost[,Phases] (旧版日志没有 Phases 列)，按列名定位误差列
+    std::vector<std::string> header;
+    size_t costIdx = 0;
+    std::vector<std::string> bestRow;
+    double bestCost = 1e9;
+    int rows = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> cells = splitCsv(line);
+        if (cells.empty()) continue;
+        if (cells[0] == "Iteration") {
+            header = cells;
+            auto it = std::find(header.begin(), header.end(), "Cost");
+            costIdx = it == header.end() ? 0 : (size_t)(it - header.begin());
+            continue;
+        }
+        // 列数与表头不一致的行 (写到一半、格式不同) 不使用
+        if (costIdx < 2 || cells.size() != header.size()) continue;
+        rows++;
+        double cost;
+        try { cost = std::stod(cells[costIdx]); }
+        catch (...) { continue; }
+        if (cost < bestCost) { bestCost = cost; bestRow = cells; }
+    }
+    if (bestRow.empty() || bestCost >= PENALTY_THRESHOLD) return false;
+
+    record.cost = bestCost;
+    record.evaluations = rows;
+    for (size_t c = 1; c < costIdx; ++c) {
+        try { record.physical[header[c]] = std::stod(bestRow[c]); }
+        catch (...) { return false; }
+    }
+    return !record.physical.empty();
+}
+
+std::vector<CalibrationRecord> WarmStart::collect(const std::string& datasetRoot, const std::string& excludePatient) {
+    std::vector<CalibrationRecord> records;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(datasetRoot, ec)) {
+        if (!entry.is_directory()) continue;
+        std::string name = entry.path().filename().string();
+        if (name == excludePatient) continue;
+
+        std::string patientRoot = entry.path().string() + "/";
+        std::string outputDir = patientRoot + "output/";
+        CalibrationRecord record;
+        record.patientName = name;
+        bool found = loadResult(outputDir + "calibration_result.csv", record);
+        if (!found) {
+            // 旧数据：取各优化模式日志中最好的一个
+            CalibrationRecord best = record;
+            for (const char* log : { "cmaes_log.csv", "bayesopt_log.csv", "turbo_log.csv" }) {
+                CalibrationRecord fromLog = record;
+                if (loadBestFromLog(outputDir + log, fromLog) && (!found || fromLog.cost < best.cost)) {
+                    best = fromLog;
+                    found = true;
+                }
+            }
+            record = best;
+        }
+        if (!found || record.cost >= PENALTY_THRESHOLD) continue;
+
+        if (record.stentTypeStr.empty()) {
+            std::ifstream config(patientRoot + "config.txt");
+            std::string type;
+            if (std::getline(config, type)) record.stentTypeStr = trim(type);
+            if (record.stentTypeStr.empty()) record.stentTypeStr = "VenusA_L26";
+        }
+        record.descriptors = readDescriptors(patientRoot);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+bool WarmStart::build(const std::vector<CalibrationRecord>& records, const std::string& stentTypeStr,
+    const std::map<std::string, double>& descriptors, const std::vector<ParameterSpec>& specs,
+    WarmStartPrior& prior)
+{
+    return build(records, stentTypeStr, descriptors, specs, Options(), prior);
+}
+
+bool WarmStart::build(const std::vector<CalibrationRecord>& records, const std::string& stentTypeStr,
+    const std::map<std::string, double>& descriptors, const std::vector<ParameterSpec>& specs,
+    const Options& options, WarmStartPrior& prior)
+{
+    const size_t d = specs.size();
+
+    // 1. 归一化到当前参数规格；缺少任一参数的记录无法使用
+    std::vector<std::vector<double>> points;
+    std::vector<const CalibrationRecord*> used;
+    for (const auto& r : records) {
+        std::vector<double> x(d);
+        bool complete = true;
+        for (size_t i = 0; i < d && complete; ++i) {
+            auto it = r.physical.find(specs[i].name);
+            if (it == r.physical.end()) { complete = false; break; }
+            x[i] = specs[i].toNormalized(it->second);
+        }
+        if (!complete) continue;
+        points.push_back(x);
+        used.push_back(&r);
+    }
+    if ((int)points.size() < options.minPatients) return false;
+
+    // 2. 描述量尺度：所有病人上的标准差
+    std::map<std::string, double> scale;
+    for (const auto& kv : descriptors) {
+        double sum = 0.0, sum2 = 0.0;
+        int n = 0;
+        for (const auto* r : used) {
+            auto it = r->descriptors.find(kv.first);
+            if (it == r->descriptors.end()) continue;
+            sum += it->second; sum2 += it->second * it->second; n++;
+        }
+        if (n < 2) continue;
+        double var = sum2 / n - (sum / n) * (sum / n);
+        if (var > 1e-12) scale[kv.first] = std::sqrt(var);
+    }
+
+    // 3. 权重：支架型号 * 描述量高斯核
+    std::vector<double> w(points.size(), 1.0);
+    for (size_t p = 0; p < points.size(); ++p) {
+        if (used[p]->stentTypeStr != stentTypeStr) w[p] *= options.otherStentWeight;
+        double dist2 = 0.0;
+        for (const auto& kv : scale) {
+            auto mine = descriptors.find(kv.first);
+            auto theirs = used[p]->descriptors.find(kv.first);
+            if (theirs == used[p]->descriptors.end()) { dist2 += 1.0; continue; } // 缺失按一个核宽度的距离计
+            double z = (mine->second - theirs->second) / (kv.second * options.bandwidth);
+            dist2 += z * z;
+        }
+        w[p] *= std::exp(-0.5 * dist2);
+    }
+    double wSum = 0.0, w2Sum = 0.0;
+    for (double v : w) { wSum += v; w2Sum += v * v; }
+    if (wSum <= 1e-12) return false;
+
+    // 4. 加权均值与协方差，再向各向同性的默认宽度收缩
+    prior = WarmStartPrior();
+    prior.patients = (int)points.size();
+    prior.effectiveSamples = wSum * wSum / w2Sum;
+    prior.mean.assign(d, 0.0);
+    for (size_t p = 0; p < points.size(); ++p)
+        for (size_t i = 0; i < d; ++i) prior.mean[i] += w[p] * points[p][i] / wSum;
+
+    prior.covariance.assign(d, std::vector<double>(d, 0.0));
+    for (size_t p = 0; p < points.size(); ++p)
+        for (size_t i = 0; i < d; ++i)
+            for (size_t j = 0; j < d; ++j)
+                prior.covariance[i][j] += w[p] * (points[p][i] - prior.mean[i]) * (points[p][j] - prior.mean[j]) / wSum;
+
+    double n = prior.effectiveSamples;
+    double k = options.shrinkage;
+    double s0 = options.defaultSigma * options.defaultSigma;
+    for (size_t i = 0; i < d; ++i)
+        for (size_t j = 0; j < d; ++j)
+            prior.covariance[i][j] = (n * prior.covariance[i][j] + (i == j ? k * s0 : 0.0)) / (n + k);
+
+    // 每维标准差限制在 [floor, ceiling]，相关系数保持不变
+    std::vector<double> s = prior.stddev(), clamped(d);
+    for (size_t i = 0; i < d; ++i) clamped[i] = std::max(options.sigmaFloor, std::min(options.sigmaCeiling, s[i]));
+    for (size_t i = 0; i < d; ++i)
+        for (size_t j = 0; j < d; ++j)
+            prior.covariance[i][j] *= (clamped[i] / s[i]) * (clamped[j] / s[j]);
+    return true;
+}
+
+void WarmStart::print(const std::string& patientName, const WarmStartPrior& prior, const std::vector<ParameterSpec>& specs) {
+    std::vector<double> s = prior.stddev();
+    std::cout << "[WarmStart] " << patientName << " | prior from " << prior.patients << " patients (effective "
+        << std::round(prior.effectiveSamples * 10.0) / 10.0 << ")" << std::endl;
+    for (size_t i = 0; i < specs.size() && i < prior.mean.size(); ++i) {
+        std::cout << "  " << std::left << std::setw(22) << specs[i].name << std::right
+            << " mean " << std::setw(12) << specs[i].toPhysical(prior.mean[i])
+            << "  sigma " << std::setw(8) << s[i] << " (normalized)" << std::endl;
+    }
+}
@@ -0,0 +1,78 @@
+// Utils/WarmStartPrior.h
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "Common.h"
+
+// 一个已完成病人的标定结果
+// 来源：outputDir/calibration_result.csv (优化结束时写入)；
+// 旧数据没有该文件时，从 cmaes_log.csv / bayesopt_log.csv / turbo_log.csv 中误差最小的一行恢复
+struct CalibrationRecord {
+    std::string patientName;
+    std::string stentTypeStr;
+    double cost = 1e9;
+    int evaluations = 0;
+    std::map<std::string, double> physical;      // 参数名 -> 物理值 (按名字匹配，参数规格增减后仍可用)
+    std::map<std::string, double> descriptors;   // 解剖描述量 (patientRoot/descriptors.txt，可缺省)
+};
+
+// 跨病人先验 (归一化参数空间)
+struct WarmStartPrior {
+    std::vector<double> mean;
+    std::vector<std::vector<double>> covariance;
+    int patients = 0;                 // 参与的病人数
+    double effectiveSamples = 0.0;    // 加权后的有效样本数 (Σw)² / Σw²
+
+    std::vector<double> stddev() const;
+
+    // 从 N(mean, covariance) 抽样并钳制到 [0,1]，用作 BayesOpt 的初始设计点
+    std::vector<std::vector<double>> sample(int count, unsigned int seed) const;
+};
+
+// 用已标定病人的最优参数为新病人构造优化起点：
+// 同支架型号的病人权重为 1，其他型号按 otherStentWeight 降权；
+// 新病人有 descriptors.txt 时再按描述量的标准化距离做高斯核加权 (每个描述量按所有病人的标准差缩放，缺失的描述量按一个核宽度计)。
+// 协方差向宽度 defaultSigma 的各向同性先验收缩 (shrinkage 个伪样本)，每维标准差限制在 [sigmaFloor, sigmaCeiling]。
+class WarmStart {
+public:
+    struct Options {
+        int minPatients = 3;            // 少于该数量的已完成病人时不使用先验
+        double otherStentWeight = 0.25;
+        double bandwidth = 2.0;         // 描述量距离的核宽度 (以标准差为单位)
+        double defaultSigma = 0.2;      // 与冷启动 CMA-ES 的步长一致
+        double shrinkage = 2.0;
+        double sigmaFloor = 0.03;
+        double sigmaCeiling = 0.3;
+    };
+
+    // 扫描 datasetRoot 下除 excludePatient 以外的所有病人目录
+    static std::vector<CalibrationRecord> collect(const std::string& datasetRoot, const std::string& excludePatient);
+
+    static bool build(const std::vector<CalibrationRecord>& records, const std::string& stentTypeStr,
+        const std::map<std::string, double>& descriptors, const std::vector<ParameterSpec>& specs,
+        WarmStartPrior& prior);
+    static bool build(const std::vector<CalibrationRecord>& records, const std::string& stentTypeStr,
+        const std::map<std::string, double>& descriptors, const std::vector<ParameterSpec>& specs,
+        const Options& options, WarmStartPrior& prior);
+
+    // descriptors.txt：每行 "<名称> <数值>"，# 开头为注释
+    static std::map<std::string, double> readDescriptors(const std::string& patientRoot);
+
+    // 优化结束时写入 outputDir/calibration_result.csv (bestParams 为归一化值)；已有更好的结果时不覆盖
+    static void saveResult(const std::string& outputDir, const std::string& stentTypeStr,
+        const std::vector<ParameterSpec>& specs, const std::vector<double>& bestParams, double cost, int evaluations);
+
+    // 直接写入 (覆盖) 标定结果，例如更换误差定义并重新评分之后
+    static void saveRecord(const std::string& outputDir, const CalibrationRecord& record);
+
+    // outputDir (patientRoot/output/) -> patientRoot / datasetRoot
+    static std::string patientRootOf(const std::string& outputDir);
+    static std::string datasetRootOf(const std::string& outputDir);
+
+    static void print(const std::string& patientName, const WarmStartPrior& prior, const std::vector<ParameterSpec>& specs);
+
+private:
+    static bool loadResult(const std::string& path, CalibrationRecord& record);
+    static bool loadBestFromLog(const std::string& path, CalibrationRecord& record);
+};
@@ -0,0 +1,226 @@
+// Rescore/Rescore.cpp
+// 离线重新评分：更换误差定义 (loss_config.txt) 后，用每次评估保存的最终几何 (output/geometry/archive.*)
+// 重新计算误差，无需重新仿真。评估之间并行，目标支架及其 LOD (或目标切面测量值) 每个病人只加载一次。
+//
+// 用法: Rescore (--data-root <dir> | --patient <patientRoot>) [--loss <exeDir>/loss_config.txt]
+//               [--threads <硬件线程数>] [--lod <体素边长，默认 0 即全分辨率>] [--update-calibration]
+//
+// 输出: 每个病人的 output/geometry/rescored.csv (Id,Iteration,OldCost,NewCost,<参数>...)；
+// --update-calibration 时用新误差下的最优结果覆盖 output/calibration_result.csv (供热启动使用)
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include "../SimWork/Core/GeometryUtils.h"
+#include "../SimWork/Core/LossFunction.h"
+#include "../Optimize/Utils/WarmStartPrior.h"
+#include "../Optimize/Utils/GeometryArchive.h"
+#include "../Optimize/Utils/PathUtils.h"
+
+namespace fs = std::filesystem;
+
+// 与 SimWorker 一致的支架型号解析
+static Simulation::StentType parseStentType(const std::string& typeStr) {
+    if (typeStr == "VenusA_L32") return Simulation::StentType::VenusA_L32;
+    if (typeStr == "VenusA_L29") return Simulation::StentType::VenusA_L29;
+    if (typeStr == "VenusA_L23") return Simulation::StentType::VenusA_L23;
+    return Simulation::StentType::VenusA_L26;
+}
+
+struct IndexRow {
+    int id = -1;         // 几何归档条目
+    std::string iteration;
+    double oldCost = 1e9;
+    std::vector<std::string> params;   // 物理值 (原样写回)
+    double newCost = -1.0;
+};
+
+struct Options {
+    LossConfig loss;
+    int threads = 1;
+    double lodVoxelSize = 0.0;     // 与 SimWorker 的 SIMWORKER_LOD_VOXEL 保持一致
+    bool updateCalibration = false;
+};
+
+static void rescorePatient(const fs::path& patientRoot, const Options& options) {
+    std::string name = patientRoot.filename().string();
+    std::string root = patientRoot.string() + "/";
+    std::string meshDir = fs::exists(root + "mesh/") ? root + "mesh/" : root + "meshes/";
+    std::string geometryDir = root + "output/geometry/";
+
+    // 1. 读取几何索引
+    std::ifstream in(geometryDir + "index.csv");
+    if (!in.is_open()) return;
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::string> header;
+    {
+        std::stringstream ss(line);
+        std::string cell;
+        while (std::getline(ss, cell, ',')) header.push_back(cell);
+    }
+    std::vector<IndexRow> rows;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        IndexRow row;
+        std::string idCell, cell;
+        if (!std::getline(ss, idCell, ',') || !std::getline(ss, row.iteration, ',') || !std::getline(ss, cell, ',')) continue;
+        try { row.id = std::stoi(idCell); row.oldCost = std::stod(cell); }
+        catch (...) { continue; }
+        while (std::getline(ss, cell, ',')) row.params.push_back(cell);
+        rows.push_back(row);
+    }
+    if (rows.empty()) return;
+
+    GeometryArchive archive;
+    if (!archive.open(geometryDir, false)) {
+        std::cerr << "[Rescore] " << name << ": geometry archive not found in " << geometryDir << std::endl;
+        return;
+    }
+
+    // 2. 目标支架与 LOD (所有评估共享)
+    std::string stentTypeStr = "VenusA_L26";
+    {
+        std::ifstream config(root + "config.txt");
+        std::string type;
+        if (std::getline(config, type)) {
+            type.erase(0, type.find_first_not_of(" \t\r\n"));
+            type.erase(type.find_last_not_of(" \t\r\n") + 1);
+            if (!type.empty()) stentTypeStr = type;
+        }
+    }
+    std::string targetPath = meshDir + "target_stent.stl";
+    Simulation::StentType stentType = parseStentType(stentTypeStr);
+
+    // 测量值模式 (或没有目标 STL) 与 SimWorker 相同：使用缓存/临床的目标切面测量值
+    std::vector<TargetSliceData> sliceTargets;
+    if (options.loss.measuredSlices || !fs::exists(targetPath)) {
+        LossFunction::loadOrMeasureTargets(meshDir + "target_slices.csv", targetPath,
+            LossFunction::sliceHeights(stentType, options.loss), sliceTargets);
+    }
+    vtkSmartPointer<vtkPolyData> targetPoly;
+    GeometryUtils::PointLOD targetLOD;
+    const bool useLOD = options.lodVoxelSize > 0.0;
+    if (sliceTargets.empty()) {
+        targetPoly = GeometryUtils::loadSTL(targetPath);
+        if (!targetPoly || targetPoly->GetNumberOfPoints() == 0) {
+            std::cerr << "[Rescore] " << name << ": target not found: " << targetPath << std::endl;
+            return;
+        }
+        if (useLOD) targetLOD = GeometryUtils::loadOrBuildLOD(targetPath, targetPoly, options.lodVoxelSize);
+    }
+
+    // 3. 并行重新评分
+    // VTK 对象的只读访问也会惰性更新内部状态 (边界、质心、单元结构)，每个线程使用目标的独立深拷贝 (在主线程中完成)
+    const int threadCount = std::max(1, options.threads);
+    std::vector<vtkSmartPointer<vtkPolyData>> threadTargets(threadCount);
+    std::vector<GeometryUtils::PointLOD> threadLODs(threadCount, targetLOD);
+    if (targetPoly) {
+        for (int t = 0; t < threadCount; ++t) {
+            threadTargets[t] = vtkSmartPointer<vtkPolyData>::New();
+            threadTargets[t]->DeepCopy(targetPoly);
+            if (useLOD && targetLOD.points) {
+                threadLODs[t].points = vtkSmartPointer<vtkPolyData>::New();
+                threadLODs[t].points->DeepCopy(targetLOD.points);
+            }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next{ 0 };
+    std::atomic<int> done{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t k = next.fetch_add(1); k < rows.size(); k = next.fetch_add(1)) {
+                std::vector<float> coords;
+                if (!archive.read(rows[k].id, coords)) continue;
+                auto simPoly = GeometryUtils::fromArrays(coords, archive.triangles());
+                LossResult loss = !sliceTargets.empty()
+                    ? LossFunction::evaluateMeasured(simPoly, sliceTargets, options.loss)
+                    : LossFunction::evaluate(simPoly, threadTargets[t], useLOD ? &threadLODs[t] : nullptr,
+                        options.lodVoxelSize, stentType, true, options.loss);
+                rows[k].newCost = loss.total;
+                int n = ++done;
+                if (n % 100 == 0) std::cout << "[Rescore] " << name << ": " << n << "/" << rows.size() << std::endl;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 4. 写出结果
+    std::ofstream out(geometryDir + "rescored.csv");
+    out << "Id,Iteration,OldCost,NewCost";
+    for (size_t c = 3; c < header.size(); ++c) out << "," << header[c];
+    out << "\n";
+    const IndexRow* best = nullptr;
+    for (const auto& row : rows) {
+        if (row.newCost < 0) continue;
+        out << row.id << "," << row.iteration << "," << row.oldCost << "," << row.newCost;
+        for (const auto& p : row.params) out << "," << p;
+        out << "\n";
+        if (!best || row.newCost < best->newCost) best = &row;
+    }
+    std::cout << "[Rescore] " << name << ": " << done.load() << "/" << rows.size() << " evaluations rescored in "
+        << seconds << " s" << std::endl;
+    if (!best) return;
+    std::cout << "  best under new loss: #" << best->id << " (iteration " << best->iteration << ") cost " << best->newCost << " (was " << best->oldCost << ")" << std::endl;
+
+    if (options.updateCalibration) {
+        CalibrationRecord record;
+        record.stentTypeStr = stentTypeStr;
+        record.cost = best->newCost;
+        record.evaluations = (int)rows.size();
+        for (size_t c = 3; c < header.size() && c - 3 < best->params.size(); ++c) {
+            try { record.physical[header[c]] = std::stod(best->params[c - 3]); }
+            catch (...) {}
+        }
+        WarmStart::saveRecord(root + "output/", record);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string dataRoot, patient;
+    std::string lossPath = PathUtils::getExeDir() + "loss_config.txt";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--update-calibration") { options.updateCalibration = true; continue; }
+        std::string val = i + 1 < argc ? argv[++i] : "";
+        if (key == "--data-root") dataRoot = val;
+        else if (key == "--patient") patient = val;
+        else if (key == "--loss") lossPath = val;
+        else if (key == "--threads") options.threads = std::stoi(val);
+        else if (key == "--lod") options.lodVoxelSize = std::stod(val);
+        else { std::cerr << "Unknown option: " << key << std::endl; return -1; }
+    }
+    if (dataRoot.empty() && patient.empty()) {
+        std::cerr << "Usage: Rescore (--data-root <dir> | --patient <patientRoot>) [--loss <file>] [--threads N] [--lod <voxel, default 0>] [--update-calibration]" << std::endl;
+        return -1;
+    }
+    if (!LossFunction::load(lossPath, options.loss)) {
+        std::cout << "[Rescore] " << lossPath << " not found, using default loss" << std::endl;
+    }
+
+    if (!patient.empty()) {
+        fs::path p(patient);
+        if (!p.has_filename()) p = p.parent_path(); // 去掉结尾的 '/'
+        rescorePatient(p, options);
+    }
+    else {
+        for (const auto& entry : fs::directory_iterator(dataRoot)) {
+            if (entry.is_directory()) rescorePatient(entry.path(), options);
+        }
+    }
+    return 0;
+}
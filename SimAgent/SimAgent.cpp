@@ -0,0 +1,323 @@
+// SimAgent/SimAgent.cpp
+// 计算节点上的轻量代理：连接优化器的 DistributedCoordinator，
+// 接收评估请求后在本机用自己的数据副本运行 SimWorker，并回传结果与心跳。
+// 断线后自动重连；协调器确认为全局最优的评估会在本机发布为 best_output。
+//
+// 用法: SimAgent --coordinator <host:port> [--slots 1] [--name <hostname>]
+//                [--data-root <exeDir>/data/patient/] [--worker <exeDir>/SimWorker.exe]
+//                [--heartbeat-ms 3000] [--layout compact|numa_spread|unpinned] [--threads 0]
+
+#include "../Optimize/Utils/NetUtils.h" // 必须最先包含 (winsock2.h 早于 windows.h)
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include "../Optimize/Utils/ProcessUtils.h"
+#include "../Optimize/Utils/BestOutputSnapshot.h"
+#include "../Optimize/Utils/PathUtils.h"
+#include "../Optimize/Utils/CpuTopology.h"
+
+namespace fs = std::filesystem;
+
+struct AgentOptions {
+    std::string host = "127.0.0.1";
+    int port = 0;
+    std::string name;
+    int slots = 1;
+    std::string dataRoot;
+    std::string workerExe;
+    int heartbeatMs = 3000;
+    CpuLayoutPolicy cpuLayout;   // 本节点各槽位的 CPU 划分与每个 Worker 的线程预算
+};
+
+class SimAgent {
+public:
+    explicit SimAgent(const AgentOptions& options) : m_options(options) {
+        CpuTopology topology = CpuTopology::detect();
+        m_cpuSets = topology.plan(m_options.slots, m_options.cpuLayout);
+        for (int s = (int)m_cpuSets.size() - 1; s >= 0; --s) m_freeSlots.push_back(s);
+        std::cout << "[Agent] CPU: " << topology.describe() << std::endl;
+        std::cout << "[Agent] Workers: " << CpuTopology::describe(m_cpuSets, m_options.cpuLayout) << std::endl;
+    }
+
+    // 主循环：连接 -> 处理消息 -> 断线重连，收到 BYE 后返回
+    void run() {
+        removeStaleEvalDirs();
+        while (!m_bye) {
+            NetUtils::socket_t s = NetUtils::connectTo(m_options.host, m_options.port);
+            if (s == NetUtils::INVALID) {
+                std::cerr << "[Agent] Cannot reach coordinator " << m_options.host << ":" << m_options.port << ", retrying..." << std::endl;
+                std::this_thread::sleep_for(std::chrono::seconds(3));
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_sendMutex);
+                m_sock = s;
+            }
+            std::cout << "[Agent] Connected to " << m_options.host << ":" << m_options.port << std::endl;
+            send("HELLO " + m_options.name + " " + std::to_string(m_options.slots));
+            serve(s);
+            std::cout << "[Agent] Disconnected." << std::endl;
+        }
+
+        // 等待仍在运行的评估结束
+        std::unique_lock<std::mutex> lock(m_stateMutex);
+        m_idleCv.wait(lock, [this] { return m_running == 0; });
+    }
+
+private:
+    struct FinishedEval {
+        std::string patientName;
+        std::string evalDir;
+    };
+
+    void serve(NetUtils::socket_t s) {
+        std::atomic<bool> connected{ true };
+        std::mutex hbMutex;
+        std::condition_variable hbCv;
+        std::thread heartbeat([&]() {
+            std::unique_lock<std::mutex> lock(hbMutex);
+            while (!hbCv.wait_for(lock, std::chrono::milliseconds(m_options.heartbeatMs), [&] { return !connected; })) {
+                send("HEARTBEAT " + std::to_string(m_running.load()));
+            }
+        });
+
+        NetUtils::LineReader reader(s);
+        std::string line;
+        while (true) {
+            int r = reader.readLine(line, 1000);
+            if (r < 0) break;
+            if (r == 0) continue;
+            std::istringstream ss(line);
+            std::string cmd;
+            ss >> cmd;
+            if (cmd == "EVAL") startEval(ss);
+            else if (cmd == "KEEP" || cmd == "DROP") finishEval(ss, cmd == "KEEP");
+            else if (cmd == "BYE") { m_bye = true; break; }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(hbMutex);
+            connected = false;
+        }
+        hbCv.notify_one();
+        heartbeat.join();
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            NetUtils::closeSocket(m_sock);
+            m_sock = NetUtils::INVALID;
+        }
+
+        // 断线后协调器已重新派发这些任务，待确认的输出不再需要
+        std::map<int, FinishedEval> orphaned;
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            orphaned.swap(m_finished);
+        }
+        for (auto& kv : orphaned) snapshotter(kv.second.patientName).discard(kv.second.evalDir);
+    }
+
+    // EVAL <jobId> <stentType> <timeoutMs> <nParams> <p>... <patientName>
+    void startEval(std::istringstream& ss) {
+        int jobId = -1, timeoutMs = 0;
+        size_t n = 0;
+        std::string stentType;
+        ss >> jobId >> stentType >> timeoutMs >> n;
+        std::vector<double> params(n);
+        for (auto& p : params) ss >> p;
+        if (!ss || jobId < 0) {
+            std::cerr << "[Agent] Malformed EVAL request: " << ss.str() << std::endl;
+            return;
+        }
+        std::string patientName;
+        std::getline(ss, patientName);
+        patientName.erase(0, patientName.find_first_not_of(' '));
+
+        m_running++;
+        std::thread([this, jobId, stentType, timeoutMs, params, patientName]() {
+            runEval(jobId, patientName, stentType, params, timeoutMs);
+            {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                m_running--;
+            }
+            m_idleCv.notify_all();
+        }).detach();
+    }
+
+    void runEval(int jobId, const std::string& patientName, const std::string& stentType,
+        const std::vector<double>& params, int timeoutMs)
+    {
+        std::string patientRoot = m_options.dataRoot + patientName + "/";
+        std::string meshDir = patientRoot + "mesh/";
+        if (!fs::exists(meshDir)) meshDir = patientRoot + "meshes/";
+        std::string evalDir = patientRoot + "output/evals/agent_" + m_options.name + "_" + std::to_string(jobId) + "/";
+
+        WorkerResult result;
+        if (!fs::exists(meshDir)) {
+            std::cerr << "[Agent] No mesh folder for patient '" << patientName << "' under " << m_options.dataRoot << std::endl;
+        }
+        else {
+            std::error_code ec;
+            fs::remove_all(evalDir, ec); // 上一次协调器会话残留的同名目录
+            fs::create_directories(evalDir + "output/Obj", ec);
+            // 协调器保证同时运行的评估数不超过槽位数；万一超出 (重连后的残留任务) 则不绑核
+            int slot = -1;
+            {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                if (!m_freeSlots.empty()) {
+                    slot = m_freeSlots.back();
+                    m_freeSlots.pop_back();
+                }
+            }
+            result = ProcessUtils::runWorkerDetailed(m_options.workerExe, meshDir, evalDir, stentType, params, timeoutMs,
+                StallPolicy(), slot >= 0 ? &m_cpuSets[slot] : nullptr);
+            if (slot >= 0) {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                m_freeSlots.push_back(slot);
+            }
+        }
+        std::cout << "[Agent] Job " << jobId << " (" << patientName << ") -> " << result.cost
+            << " in " << result.wallMs << " ms" << std::endl;
+
+        // 先登记再回传，保证随后的 KEEP/DROP 能找到该目录
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            m_finished[jobId] = { patientName, evalDir };
+        }
+        std::ostringstream msg;
+        msg << std::setprecision(17) << "RESULT " << jobId << " " << result.cost << " " << result.wallMs << " "
+            << (result.stalled ? 2 : (result.timedOut ? 1 : 0)) << " " << result.phases.size();
+        for (const auto& phase : result.phases) msg << " " << phase.first << " " << phase.second;
+        if (!send(msg.str())) {
+            // 未连接：协调器会把该任务派发给其他 Agent
+            {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                m_finished.erase(jobId);
+            }
+            snapshotter(patientName).discard(evalDir);
+        }
+    }
+
+    // KEEP <jobId> <cost> / DROP <jobId>
+    void finishEval(std::istringstream& ss, bool keep) {
+        int jobId = -1;
+        double cost = 0.0;
+        ss >> jobId;
+        if (keep) ss >> cost;
+        FinishedEval eval;
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            auto it = m_finished.find(jobId);
+            if (it == m_finished.end()) return;
+            eval = it->second;
+            m_finished.erase(it);
+        }
+        if (keep) snapshotter(eval.patientName).publish(eval.evalDir, cost, jobId);
+        else snapshotter(eval.patientName).discard(eval.evalDir);
+    }
+
+    // 删除本 Agent 上次异常退出时残留的评估目录 (data/patient/<name>/output/evals/agent_<agentName>_*)
+    void removeStaleEvalDirs() {
+        std::string prefix = "agent_" + m_options.name + "_";
+        std::error_code ec;
+        for (const auto& patient : fs::directory_iterator(m_options.dataRoot, ec)) {
+            fs::path evalsDir = patient.path() / "output" / "evals";
+            if (!fs::is_directory(evalsDir, ec)) continue;
+            for (const auto& entry : fs::directory_iterator(evalsDir, ec)) {
+                if (entry.path().filename().string().rfind(prefix, 0) == 0) fs::remove_all(entry.path(), ec);
+            }
+        }
+    }
+
+    BestOutputSnapshotter& snapshotter(const std::string& patientName) {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        auto& slot = m_snapshotters[patientName];
+        if (!slot) {
+            std::string outputDir = m_options.dataRoot + patientName + "/output/";
+            std::error_code ec;
+            fs::create_directories(outputDir, ec);
+            slot = std::make_unique<BestOutputSnapshotter>(outputDir);
+        }
+        return *slot;
+    }
+
+    bool send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        if (m_sock == NetUtils::INVALID) return false;
+        if (NetUtils::sendLine(m_sock, line)) return true;
+        NetUtils::shutdownSocket(m_sock);
+        return false;
+    }
+
+    AgentOptions m_options;
+    std::atomic<bool> m_bye{ false };
+
+    std::mutex m_sendMutex;
+    NetUtils::socket_t m_sock = NetUtils::INVALID;
+
+    std::mutex m_stateMutex;
+    std::condition_variable m_idleCv;
+    std::atomic<int> m_running{ 0 };
+    std::map<int, FinishedEval> m_finished;                                  // 已回传、等待 KEEP/DROP 的评估
+    std::vector<WorkerCpuSet> m_cpuSets;                                     // 槽位编号 -> CPU 与线程预算
+    std::vector<int> m_freeSlots;
+    std::map<std::string, std::unique_ptr<BestOutputSnapshotter>> m_snapshotters;
+};
+
+static std::string defaultAgentName() {
+    char buf[256] = { 0 };
+    if (gethostname(buf, sizeof(buf) - 1) != 0 || !buf[0]) return "agent";
+    return buf;
+}
+
+int main(int argc, char* argv[]) {
+    NetUtils::initialize();
+
+    std::string exeDir = PathUtils::getExeDir();
+    AgentOptions options;
+    options.dataRoot = exeDir + "data/patient/";
+    options.workerExe = exeDir + "SimWorker.exe";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i], val = argv[i + 1];
+        if (key == "--coordinator") {
+            size_t colon = val.rfind(':');
+            if (colon != std::string::npos) {
+                options.host = val.substr(0, colon);
+                options.port = std::stoi(val.substr(colon + 1));
+            }
+        }
+        else if (key == "--slots") options.slots = std::max(1, std::stoi(val));
+        else if (key == "--name") options.name = val;
+        else if (key == "--data-root") options.dataRoot = PathUtils::normalize(val);
+        else if (key == "--worker") options.workerExe = val;
+        else if (key == "--heartbeat-ms") options.heartbeatMs = std::max(100, std::stoi(val));
+        else if (key == "--layout" && !CpuTopology::parseLayout(val, options.cpuLayout.layout)) {
+            std::cerr << "[Agent] Unknown layout '" << val << "', using " << CpuTopology::layoutName(options.cpuLayout.layout) << std::endl;
+        }
+        else if (key == "--threads") options.cpuLayout.threadsPerWorker = std::max(0, std::stoi(val));
+    }
+    if (options.port <= 0) {
+        std::cerr << "Usage: SimAgent --coordinator <host:port> [--slots N] [--name NAME] [--data-root DIR] [--worker EXE]" << std::endl;
+        return -1;
+    }
+    if (options.name.empty()) options.name = defaultAgentName();
+    // 名称会出现在协议字段与目录名中，不能包含空白
+    for (char& c : options.name) if (std::isspace((unsigned char)c)) c = '_';
+
+    std::cout << "[Agent] " << options.name << " | slots " << options.slots << " | data " << options.dataRoot
+        << " | worker " << options.workerExe << std::endl;
+    SimAgent agent(options);
+    agent.run();
+    return 0;
+}
@@ -1,14 +1,15 @@
 #include "GeometryUtils.h"
+#include "PhaseProfiler.h"
+#include "MeshLoader.h"
+#include "ProfileKernel.h"
 #include <vtkSTLReader.h>
 #include <vtkOBJReader.h>
 #include <vtkPlane.h>
 #include <vtkCutter.h>
-#include <vtkStripper.h>
 #include <vtkCenterOfMass.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkCardinalSpline.h>
-#include <vtkKochanekSpline.h> // [新增] 用于带张力的样条
 #include <vtkHausdorffDistancePointSetFilter.h>
 #include <vtkDistancePolyDataFilter.h>
 #include <vtkPointData.h>
@@ -18,9 +19,27 @@
 #include <cmath>
 #include <vtkIterativeClosestPointTransform.h>
 #include <vtkLandmarkTransform.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkCellArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMath.h>
+#include <vtkPoints.h>
+#include <vtkIdList.h>
+#include <unordered_map>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace fs = std::filesystem;
 
 // ... loadSTL 和 loadOBJ 保持不变 ...
 vtkSmartPointer<vtkPolyData> GeometryUtils::loadSTL(const std::string& filepath) {
+    ScopedPhase phase("mesh_load");
+    MeshData mesh;
+    if (MeshLoader::loadSTL(filepath, mesh)) return fromArrays(mesh.coords, mesh.triangles);
+
+    // 原生加载失败 (文件不存在或格式不规范) 时退回 VTK 读取器
     auto reader = vtkSmartPointer<vtkSTLReader>::New();
     reader->SetFileName(filepath.c_str());
     reader->Update();
@@ -28,12 +47,91 @@ vtkSmartPointer<vtkPolyData> GeometryUtils::loadSTL(const std::string& filepath)
 }
 
 vtkSmartPointer<vtkPolyData> GeometryUtils::loadOBJ(const std::string& filepath) {
+    ScopedPhase phase("mesh_load");
+    MeshData mesh;
+    if (MeshLoader::loadOBJ(filepath, mesh)) return fromArrays(mesh.coords, mesh.triangles);
+
     auto reader = vtkSmartPointer<vtkOBJReader>::New();
     reader->SetFileName(filepath.c_str());
     reader->Update();
     return reader->GetOutput();
 }
 
+// 紧凑几何文件头
+struct CompactGeometryHeader {
+    char magic[4];
+    std::uint32_t numPoints;
+    std::uint32_t numTriangles;
+};
+
+bool GeometryUtils::saveCompactGeometry(const std::string& filepath, vtkPolyData* poly) {
+    ScopedPhase phase("geometry_save");
+    if (!poly) return false;
+
+    std::vector<float> coords((size_t)poly->GetNumberOfPoints() * 3);
+    for (vtkIdType i = 0; i < poly->GetNumberOfPoints(); ++i) {
+        double p[3];
+        poly->GetPoint(i, p);
+        coords[i * 3] = (float)p[0]; coords[i * 3 + 1] = (float)p[1]; coords[i * 3 + 2] = (float)p[2];
+    }
+
+    std::vector<std::uint32_t> tris;
+    auto idList = vtkSmartPointer<vtkIdList>::New();
+    vtkCellArray* polys = poly->GetPolys();
+    polys->InitTraversal();
+    while (polys->GetNextCell(idList)) {
+        for (vtkIdType k = 1; k + 1 < idList->GetNumberOfIds(); ++k) {
+            tris.push_back((std::uint32_t)idList->GetId(0));
+            tris.push_back((std::uint32_t)idList->GetId(k));
+            tris.push_back((std::uint32_t)idList->GetId(k + 1));
+        }
+    }
+
+    CompactGeometryHeader header;
+    std::memcpy(header.magic, "GEO1", 4);
+    header.numPoints = (std::uint32_t)poly->GetNumberOfPoints();
+    header.numTriangles = (std::uint32_t)(tris.size() / 3);
+
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(float));
+    out.write(reinterpret_cast<const char*>(tris.data()), tris.size() * sizeof(std::uint32_t));
+    return out.good();
+}
+
+vtkSmartPointer<vtkPolyData> GeometryUtils::loadCompactGeometry(const std::string& filepath) {
+    ScopedPhase phase("mesh_load");
+    std::ifstream in(filepath, std::ios::binary);
+    CompactGeometryHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "GEO1", 4) != 0) return nullptr;
+
+    std::vector<float> coords((size_t)header.numPoints * 3);
+    std::vector<std::uint32_t> tris((size_t)header.numTriangles * 3);
+    if (!in.read(reinterpret_cast<char*>(coords.data()), coords.size() * sizeof(float)) ||
+        !in.read(reinterpret_cast<char*>(tris.data()), tris.size() * sizeof(std::uint32_t))) return nullptr;
+
+    return fromArrays(coords, tris);
+}
+
+vtkSmartPointer<vtkPolyData> GeometryUtils::fromArrays(const std::vector<float>& coords, const std::vector<std::uint32_t>& triangles) {
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    vtkIdType numPoints = (vtkIdType)(coords.size() / 3);
+    points->SetNumberOfPoints(numPoints);
+    for (vtkIdType i = 0; i < numPoints; ++i) {
+        points->SetPoint(i, coords[i * 3], coords[i * 3 + 1], coords[i * 3 + 2]);
+    }
+    auto cells = vtkSmartPointer<vtkCellArray>::New();
+    for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+        vtkIdType ids[3] = { triangles[t], triangles[t + 1], triangles[t + 2] };
+        cells->InsertNextCell(3, ids);
+    }
+    auto poly = vtkSmartPointer<vtkPolyData>::New();
+    poly->SetPoints(points);
+    poly->SetPolys(cells);
+    return poly;
+}
+
 // [新增] 质心对齐
 vtkSmartPointer<vtkPolyData> GeometryUtils::alignToCentroid(vtkPolyData* source, vtkPolyData* target) {
     if (!source || !target) return nullptr;
@@ -67,6 +165,7 @@ vtkSmartPointer<vtkPolyData> GeometryUtils::alignToCentroid(vtkPolyData* source,
 }
 
 vtkSmartPointer<vtkPolyData> GeometryUtils::alignToICP(vtkPolyData* source, vtkPolyData* target) {
+	ScopedPhase phase("icp");
 	// 先进行质心对齐，提供一个好的初始位置
 	auto alignedSource = alignToCentroid(source, target);
 
@@ -87,160 +186,281 @@ vtkSmartPointer<vtkPolyData> GeometryUtils::alignToICP(vtkPolyData* source, vtkP
 	return transformFilter->GetOutput();
 }
 
+// 对 PolyData 施加刚性变换
+static vtkSmartPointer<vtkPolyData> transformPoly(vtkPolyData* poly, vtkTransform* transform) {
+    auto transformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    transformFilter->SetInputData(poly);
+    transformFilter->SetTransform(transform);
+    transformFilter->Update();
+    return transformFilter->GetOutput();
+}
+
+static Eigen::Vector3d weightedCentroid(const GeometryUtils::PointLOD& lod) {
+    Eigen::Vector3d c(0, 0, 0);
+    double wSum = 0.0;
+    for (vtkIdType i = 0; i < lod.points->GetNumberOfPoints(); ++i) {
+        double p[3];
+        lod.points->GetPoint(i, p);
+        c += lod.weights[i] * Eigen::Vector3d(p[0], p[1], p[2]);
+        wSum += lod.weights[i];
+    }
+    return wSum > 0 ? Eigen::Vector3d(c / wSum) : c;
+}
+
+vtkSmartPointer<vtkPolyData> GeometryUtils::alignToICP(vtkPolyData* source, PointLOD& sourceLOD, const PointLOD& targetLOD) {
+    ScopedPhase phase("icp");
+    if (!source || !sourceLOD.points || !targetLOD.points) return nullptr;
+
+    // 1. 加权质心对齐 (与完整模型的质心对齐等价)
+    Eigen::Vector3d shift = weightedCentroid(targetLOD) - weightedCentroid(sourceLOD);
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    transform->PostMultiply();
+    transform->Translate(shift.x(), shift.y(), shift.z());
+    auto shifted = transformPoly(sourceLOD.points, transform);
+
+    // 2. ICP (点集已按加权质心对齐，不再按未加权质心重新匹配)
+    auto icp = vtkSmartPointer<vtkIterativeClosestPointTransform>::New();
+    icp->SetSource(shifted);
+    icp->SetTarget(targetLOD.points);
+    icp->GetLandmarkTransform()->SetModeToRigidBody();
+    icp->SetMaximumNumberOfIterations(50);
+    icp->StartByMatchingCentroidsOff();
+    icp->Update();
+
+    // 3. 平移 + ICP 组合为一个变换，同时作用到完整模型与降采样点集
+    transform->Concatenate(icp->GetMatrix());
+    sourceLOD.points = transformPoly(sourceLOD.points, transform);
+    return transformPoly(source, transform);
+}
+
+GeometryUtils::PointLOD GeometryUtils::voxelSubsample(vtkPolyData* poly, double voxelSize) {
+    ScopedPhase phase("lod_build");
+    PointLOD lod;
+    lod.voxelSize = voxelSize;
+    lod.points = vtkSmartPointer<vtkPolyData>::New();
+    if (!poly || voxelSize <= 0.0) return lod;
+
+    double bounds[6];
+    poly->GetBounds(bounds);
+    vtkIdType n = poly->GetNumberOfPoints();
+    lod.sourcePoints = n;
+
+    // 体素坐标 (每轴 21 位) 打包为 64 位键
+    struct Accum { double x = 0, y = 0, z = 0; double count = 0; };
+    std::unordered_map<std::uint64_t, size_t> voxelIndex;
+    std::vector<Accum> voxels;
+    voxelIndex.reserve((size_t)n / 4 + 16);
+    for (vtkIdType i = 0; i < n; ++i) {
+        double p[3];
+        poly->GetPoint(i, p);
+        std::uint64_t ix = (std::uint64_t)((p[0] - bounds[0]) / voxelSize) & 0x1FFFFF;
+        std::uint64_t iy = (std::uint64_t)((p[1] - bounds[2]) / voxelSize) & 0x1FFFFF;
+        std::uint64_t iz = (std::uint64_t)((p[2] - bounds[4]) / voxelSize) & 0x1FFFFF;
+        std::uint64_t key = ix | (iy << 21) | (iz << 42);
+        auto it = voxelIndex.find(key);
+        size_t idx;
+        if (it == voxelIndex.end()) {
+            idx = voxels.size();
+            voxelIndex.emplace(key, idx);
+            voxels.emplace_back();
+        }
+        else {
+            idx = it->second;
+        }
+        Accum& a = voxels[idx];
+        a.x += p[0]; a.y += p[1]; a.z += p[2]; a.count += 1.0;
+    }
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    auto verts = vtkSmartPointer<vtkCellArray>::New();
+    points->SetNumberOfPoints((vtkIdType)voxels.size());
+    lod.weights.resize(voxels.size());
+    for (size_t i = 0; i < voxels.size(); ++i) {
+        const Accum& a = voxels[i];
+        points->SetPoint((vtkIdType)i, a.x / a.count, a.y / a.count, a.z / a.count);
+        lod.weights[i] = a.count;
+        vtkIdType id = (vtkIdType)i;
+        verts->InsertNextCell(1, &id);
+    }
+    lod.points->SetPoints(points);
+    lod.points->SetVerts(verts);
+    return lod;
+}
+
+// LOD 缓存文件头
+struct LODCacheHeader {
+    char magic[4];
+    std::uint64_t sourceBytes;
+    std::int64_t sourceMtime;
+    double voxelSize;
+    std::uint64_t sourcePoints;
+    std::uint64_t count;
+};
+
+GeometryUtils::PointLOD GeometryUtils::loadOrBuildLOD(const std::string& meshPath, vtkPolyData* poly, double voxelSize) {
+    std::error_code ec;
+    std::uint64_t bytes = fs::file_size(meshPath, ec);
+    std::int64_t mtime = ec ? 0 : (std::int64_t)fs::last_write_time(meshPath, ec).time_since_epoch().count();
+    std::string cachePath = meshPath + ".lod";
+
+    // 1. 读取缓存
+    {
+        std::ifstream in(cachePath, std::ios::binary);
+        LODCacheHeader header;
+        if (in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, "LOD1", 4) == 0 && header.sourceBytes == bytes &&
+            header.sourceMtime == mtime && header.voxelSize == voxelSize)
+        {
+            std::vector<double> data(header.count * 4);
+            if (in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double))) {
+                PointLOD lod;
+                lod.voxelSize = voxelSize;
+                lod.sourcePoints = (vtkIdType)header.sourcePoints;
+                lod.points = vtkSmartPointer<vtkPolyData>::New();
+                auto points = vtkSmartPointer<vtkPoints>::New();
+                auto verts = vtkSmartPointer<vtkCellArray>::New();
+                points->SetNumberOfPoints((vtkIdType)header.count);
+                lod.weights.resize(header.count);
+                for (std::uint64_t i = 0; i < header.count; ++i) {
+                    points->SetPoint((vtkIdType)i, data[i * 4], data[i * 4 + 1], data[i * 4 + 2]);
+                    lod.weights[i] = data[i * 4 + 3];
+                    vtkIdType id = (vtkIdType)i;
+                    verts->InsertNextCell(1, &id);
+                }
+                lod.points->SetPoints(points);
+                lod.points->SetVerts(verts);
+                PhaseProfiler::instance().recordCache("lod", true);
+                return lod;
+            }
+        }
+    }
+
+    // 2. 重新生成并写入 (临时文件 + 改名，避免并发 Worker 读到半个文件)
+    PhaseProfiler::instance().recordCache("lod", false);
+    PointLOD lod = voxelSubsample(poly, voxelSize);
+    LODCacheHeader header;
+    std::memcpy(header.magic, "LOD1", 4);
+    header.sourceBytes = bytes;
+    header.sourceMtime = mtime;
+    header.voxelSize = voxelSize;
+    header.sourcePoints = (std::uint64_t)lod.sourcePoints;
+    header.count = (std::uint64_t)lod.weights.size();
+    std::vector<double> data(header.count * 4);
+    for (std::uint64_t i = 0; i < header.count; ++i) {
+        lod.points->GetPoint((vtkIdType)i, &data[i * 4]);
+        data[i * 4 + 3] = lod.weights[i];
+    }
+    std::string tmpPath = cachePath + ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+    }
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec) fs::remove(tmpPath, ec);
+    return lod;
+}
+
 bool GeometryUtils::computeSliceAndFit(vtkPolyData* poly, const Eigen::Vector3d& origin, const Eigen::Vector3d& normal, ProfileData& outProfile) {
-    outProfile.valid = false;
-    if (!poly || poly->GetNumberOfPoints() == 0) return false;
+    std::vector<ProfileData> profiles;
+    computeSlicesAndFit(poly, { origin }, normal, profiles);
+    outProfile = profiles.front();
+    return outProfile.valid;
+}
+
+int GeometryUtils::computeSlicesAndFit(vtkPolyData* poly, const std::vector<Eigen::Vector3d>& origins, const Eigen::Vector3d& normal,
+    std::vector<ProfileData>& outProfiles)
+{
+    ScopedPhase phase("slice_fit");
+    outProfiles.assign(origins.size(), ProfileData());
+    for (auto& profile : outProfiles) profile.valid = false;
+    if (!poly || poly->GetNumberOfPoints() == 0 || origins.empty()) return 0;
+
+    // 1. 一次切割得到所有截面：平面过 origins[0]，第 k 个截面为等值面 n·(x - origins[0]) = offset_k
+    //    (高度相同的截面共用一组切片点)
+    Eigen::Vector3d n = normal.normalized();
+    std::vector<double> offsets;
+    std::vector<int> group(origins.size());
+    for (size_t k = 0; k < origins.size(); ++k) {
+        double offset = n.dot(origins[k] - origins[0]);
+        auto it = std::find_if(offsets.begin(), offsets.end(), [&](double o) { return std::abs(o - offset) < 1e-9; });
+        group[k] = (int)(it - offsets.begin());
+        if (it == offsets.end()) offsets.push_back(offset);
+    }
 
-    // 1. 切割
     auto plane = vtkSmartPointer<vtkPlane>::New();
-    plane->SetOrigin(origin.x(), origin.y(), origin.z());
-    plane->SetNormal(normal.x(), normal.y(), normal.z());
+    plane->SetOrigin(origins[0].x(), origins[0].y(), origins[0].z());
+    plane->SetNormal(n.x(), n.y(), n.z());
 
     auto cutter = vtkSmartPointer<vtkCutter>::New();
     cutter->SetInputData(poly);
     cutter->SetCutFunction(plane);
+    for (size_t g = 0; g < offsets.size(); ++g) cutter->SetValue((int)g, offsets[g]);
     cutter->Update();
+    vtkPolyData* slicePoly = cutter->GetOutput();
 
-    auto stripper = vtkSmartPointer<vtkStripper>::New();
-    stripper->SetInputConnection(cutter->GetOutputPort());
-    stripper->Update();
-
-    auto slicePoly = stripper->GetOutput();
-    if (slicePoly->GetNumberOfPoints() < 10) return false;
-
-    // 2. 局部坐标系 (u, v) 用于投影和反投影
-    Eigen::Vector3d n = normal.normalized();
-    Eigen::Vector3d u, v;
-    if (std::abs(n.x()) < 0.9) u = n.cross(Eigen::Vector3d(1, 0, 0)).normalized();
-    else u = n.cross(Eigen::Vector3d(0, 1, 0)).normalized();
-    v = n.cross(u).normalized();
-
-    // 3. 质心计算
-    Eigen::Vector3d centroid3D(0, 0, 0);
+    // 2. 切片点按所在等值面分组
+    std::vector<std::vector<Eigen::Vector3d>> groupPoints(offsets.size());
     vtkIdType numPts = slicePoly->GetNumberOfPoints();
-    std::vector<Eigen::Vector3d> points3D;
     for (vtkIdType i = 0; i < numPts; ++i) {
         double p[3];
         slicePoly->GetPoint(i, p);
         Eigen::Vector3d pt(p[0], p[1], p[2]);
-        points3D.push_back(pt);
-        centroid3D += pt;
-    }
-    centroid3D /= (double)numPts;
-    outProfile.centroid = centroid3D;
-
-    // 4. 分桶 (Binning)
-    const int NUM_BINS = 36;
-    struct BinData { double sumR = 0; int count = 0; };
-    std::vector<BinData> bins(NUM_BINS);
-
-    for (const auto& pt : points3D) {
-        Eigen::Vector3d vec = pt - centroid3D;
-        double x_loc = vec.dot(u);
-        double y_loc = vec.dot(v);
-        double theta = std::atan2(y_loc, x_loc);
-        if (theta < 0) theta += 2.0 * EIGEN_PI;
-        double r = std::sqrt(x_loc * x_loc + y_loc * y_loc);
-
-        int idx = (int)(theta / (2.0 * EIGEN_PI) * NUM_BINS);
-        idx = std::clamp(idx, 0, NUM_BINS - 1);
-        bins[idx].sumR += r;
-        bins[idx].count++;
-    }
-
-    // 5. 填补空桶
-    for (int i = 0; i < NUM_BINS; ++i) {
-        if (bins[i].count == 0) {
-            int left = (i - 1 + NUM_BINS) % NUM_BINS;
-            while (bins[left].count == 0 && left != i) left = (left - 1 + NUM_BINS) % NUM_BINS;
-            int right = (i + 1) % NUM_BINS;
-            while (bins[right].count == 0 && right != i) right = (right + 1) % NUM_BINS;
-
-            if (bins[left].count > 0 && bins[right].count > 0) {
-                double rL = bins[left].sumR / bins[left].count;
-                double rR = bins[right].sumR / bins[right].count;
-                bins[i].sumR = (rL + rR) / 2.0;
-                bins[i].count = 1;
-            }
-            else { return false; }
+        double d = n.dot(pt - origins[0]);
+        size_t nearest = 0;
+        for (size_t g = 1; g < offsets.size(); ++g) {
+            if (std::abs(d - offsets[g]) < std::abs(d - offsets[nearest])) nearest = g;
         }
+        groupPoints[nearest].push_back(pt);
     }
 
-    // 6. 样条拟合
-    // =========================================================
-    // [新增] 5.5 数据平滑 (Data Smoothing) - 消除局部抖动
-    // =========================================================
-    // 使用简单的 3 点高斯平滑 [0.25, 0.5, 0.25]
-    std::vector<double> smoothedRadii(NUM_BINS);
-    for (int i = 0; i < NUM_BINS; ++i) {
-        // 处理周期性边界 (圆环首尾相接)
-        int prev = (i - 1 + NUM_BINS) % NUM_BINS;
-        int next = (i + 1) % NUM_BINS;
-
-        double rPrev = bins[prev].sumR / bins[prev].count;
-        double rCurr = bins[i].sumR / bins[i].count;
-        double rNext = bins[next].sumR / bins[next].count;
-
-        // 加权平均 (权重可调，中间越大越保持原形，越小越平滑)
-        smoothedRadii[i] = 0.25 * rPrev + 0.5 * rCurr + 0.25 * rNext;
-    }
+    // 3. 局部坐标系 (u, v) 用于投影和反投影
+    Eigen::Vector3d u, v;
+    if (std::abs(n.x()) < 0.9) u = n.cross(Eigen::Vector3d(1, 0, 0)).normalized();
+    else u = n.cross(Eigen::Vector3d(0, 1, 0)).normalized();
+    v = n.cross(u).normalized();
 
-    // =========================================================
-    // [修改] 6. 样条拟合 (Spline Fitting)
-    // =========================================================
-    // 改用 KochanekSpline，因为它支持 Tension (张力) 参数
-    auto spline = vtkSmartPointer<vtkKochanekSpline>::New();
-    spline->ClosedOn();
-
-    // [关键参数] Tension (张力): 范围 [-1, 1]
-    // 0.0 = Catmull-Rom (类似 Cardinal Spline，适中)
-    // >0.0 (如 0.5) = 曲线更紧凑 (Tight)，减少起伏和过冲，适合支架轮廓
-    // <0.0 (如 -0.5) = 曲线更松弛 (Round)，更圆
-    spline->SetDefaultTension(0.5);
-
-    for (int i = 0; i < NUM_BINS; ++i) {
-        // 使用平滑后的数据
-        spline->AddPoint(i, smoothedRadii[i]);
+    // 4. 各截面质心与局部坐标 (点数不足的截面不送入内核，视为拟合失败)，批量拟合
+    std::vector<Eigen::Vector3d> centroids(offsets.size(), Eigen::Vector3d::Zero());
+    ProfileKernel::Batch batch;
+    for (size_t g = 0; g < offsets.size(); ++g) {
+        const auto& pts = groupPoints[g];
+        if (pts.size() >= 10) {
+            for (const auto& pt : pts) centroids[g] += pt;
+            centroids[g] /= (double)pts.size();
+            for (const auto& pt : pts) {
+                Eigen::Vector3d vec = pt - centroids[g];
+                batch.push(vec.dot(u), vec.dot(v));
+            }
+        }
+        batch.close();
     }
-
-    // 7. 重采样并还原为 3D 坐标
-    outProfile.radii.resize(360);
-    outProfile.points3D.resize(360); // [新增]
-
-    double areaSum = 0;
-    double periSum = 0;
-    Eigen::Vector2d prevPt2D(0, 0);
-
-    for (int i = 0; i < 360; ++i) {
-        double t = (double)i / 360.0 * NUM_BINS;
-        double r = spline->Evaluate(t);
-        outProfile.radii[i] = r;
-
-        double theta = (double)i / 360.0 * 2.0 * EIGEN_PI;
-        double cosT = std::cos(theta);
-        double sinT = std::sin(theta);
-
-        // 计算 3D 坐标: P = C + r*cos(t)*u + r*sin(t)*v
-        outProfile.points3D[i] = centroid3D + r * cosT * u + r * sinT * v;
-
-        // 计算面积/周长用的 2D 坐标
-        Eigen::Vector2d currPt2D(r * cosT, r * sinT);
-        if (i > 0) {
-            areaSum += 0.5 * std::abs(prevPt2D.x() * currPt2D.y() - prevPt2D.y() * currPt2D.x());
-            periSum += (currPt2D - prevPt2D).norm();
+    ProfileKernel::Result fit;
+    ProfileKernel::fit(batch, fit);
+
+    // 5. 还原为 3D 坐标：P = C + r*cos(t)*u + r*sin(t)*v
+    const auto& cosT = ProfileKernel::cosTable();
+    const auto& sinT = ProfileKernel::sinTable();
+    int validCount = 0;
+    for (size_t k = 0; k < origins.size(); ++k) {
+        int g = group[k];
+        if (!fit.valid[g]) continue;
+        ProfileData& out = outProfiles[k];
+        const double* radii = fit.radii.data() + (size_t)g * ProfileKernel::kSamples;
+        out.centroid = centroids[g];
+        out.radii.assign(radii, radii + ProfileKernel::kSamples);
+        out.points3D.resize(ProfileKernel::kSamples);
+        for (int i = 0; i < ProfileKernel::kSamples; ++i) {
+            out.points3D[i] = centroids[g] + radii[i] * cosT[i] * u + radii[i] * sinT[i] * v;
         }
-        prevPt2D = currPt2D;
+        out.area = fit.area[g];
+        out.circumference = fit.circumference[g];
+        out.longAxis = fit.longAxis[g];
+        out.shortAxis = fit.shortAxis[g];
+        out.valid = true;
+        validCount++;
     }
-    // Close loop
-    double r0 = outProfile.radii[0];
-    Eigen::Vector2d pt0_2D(r0, 0);
-    areaSum += 0.5 * std::abs(prevPt2D.x() * pt0_2D.y() - prevPt2D.y() * pt0_2D.x());
-    periSum += (pt0_2D - prevPt2D).norm();
-
-    outProfile.area = areaSum;
-    outProfile.circumference = periSum;
-    outProfile.valid = true;
-    return true;
+    return validCount;
 }
 
 // 导出 CSV
@@ -279,6 +499,7 @@ void GeometryUtils::saveProfileGeometry(const std::string& filepath, const Profi
 
 // 计算基础误差 (不配准)
 GeometryUtils::SimilarityMetrics GeometryUtils::computeErrors(vtkPolyData* source, vtkPolyData* target) {
+    ScopedPhase phase("compute_errors");
     if (!source || !target) return { 1e9, 1e9, 1e9 };
 
     auto distFilter = vtkSmartPointer<vtkDistancePolyDataFilter>::New();
@@ -301,6 +522,37 @@ GeometryUtils::SimilarityMetrics GeometryUtils::computeErrors(vtkPolyData* sourc
     return { maxDist, sumDist / n, std::sqrt(sumSqDist / n) };
 }
 
+// 在降采样点集上计算误差
+GeometryUtils::SimilarityMetrics GeometryUtils::computeErrors(const PointLOD& source, vtkPolyData* target) {
+    ScopedPhase phase("compute_errors");
+    if (!source.points || !target || source.points->GetNumberOfPoints() == 0 || target->GetNumberOfCells() == 0) {
+        return { 1e9, 1e9, 1e9 };
+    }
+
+    // 完整分辨率表面上的最近点 (与 vtkDistancePolyDataFilter 的点到面距离一致)
+    auto locator = vtkSmartPointer<vtkStaticCellLocator>::New();
+    locator->SetDataSet(target);
+    locator->BuildLocator();
+
+    double maxDist = 0, sumDist = 0, sumSqDist = 0, wSum = 0;
+    for (vtkIdType i = 0; i < source.points->GetNumberOfPoints(); ++i) {
+        double p[3], q[3], dist2;
+        vtkIdType cellId;
+        int subId;
+        source.points->GetPoint(i, p);
+        locator->FindClosestPoint(p, q, cellId, subId, dist2);
+        double val = std::sqrt(dist2);
+        double w = source.weights[i];
+        if (val > maxDist) maxDist = val;
+        sumDist += w * val;
+        sumSqDist += w * val * val;
+        wSum += w;
+    }
+    SimilarityMetrics metrics{ maxDist, sumDist / wSum, std::sqrt(sumSqDist / wSum) };
+    metrics.errorBound = source.pointBound();
+    return metrics;
+}
+
 double GeometryUtils::getDistanceToMesh(const Eigen::Vector3d& point, vtkImplicitPolyDataDistance* distanceFunc) {
     double p[3] = { point.x(), point.y(), point.z() };
     return distanceFunc->EvaluateFunction(p);
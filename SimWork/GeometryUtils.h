@@ -6,6 +6,8 @@
 #include <vtkImplicitPolyDataDistance.h>
 #include <Eigen/Dense>
 #include <tuple>
+#include <cmath>
+#include <cstdint>
 
 class GeometryUtils {
 public:
@@ -18,6 +20,8 @@ public:
         double area;
         double circumference;
         double circularity;
+        double longAxis = 0.0;          // 等效椭圆 (与闭合曲线围成区域的二阶矩相同) 的长轴/短轴长度
+        double shortAxis = 0.0;
     };
 
     // [结构体] 基础误差指标
@@ -25,12 +29,35 @@ public:
         double maxDistance;  // Hausdorff
         double meanDistance; // 平均距离
         double rmse;         // RMSE
+        double errorBound = 0.0; // 在降采样点集上计算时，同一配准下三项指标与全分辨率结果之差的上界 (不含 ICP 在降采样点集上收敛到不同位姿的差异)
+    };
+
+    // [结构体] 体素降采样后的点集 (LOD)
+    // 每个非空体素保留一个代表点 (体素内原始点的质心)，权重为原始点数，因此加权质心与原模型一致
+    struct PointLOD {
+        vtkSmartPointer<vtkPolyData> points;   // 代表点 (每点一个 vertex 单元，可直接用于 ICP 的定位器)
+        std::vector<double> weights;
+        double voxelSize = 0.0;
+        vtkIdType sourcePoints = 0;
+
+        // 任一原始点到其代表点的最大距离 (体素对角线 h√3)
+        double pointBound() const { return voxelSize * std::sqrt(3.0); }
     };
 
     // ================= 文件加载 =================
+    // 由 MeshLoader 原生解码后转换为 PolyData (STL 合并重复顶点，OBJ 多边形扇形三角化)，失败时退回 VTK 读取器
     static vtkSmartPointer<vtkPolyData> loadSTL(const std::string& filepath);
     static vtkSmartPointer<vtkPolyData> loadOBJ(const std::string& filepath);
 
+    /**
+     * @brief [新增] 紧凑几何格式 (.geo)：float32 顶点 + uint32 三角形索引，多边形按扇形三角化
+     * 用于保存每次评估的最终支架几何 (约为 OBJ 的 1/4)，供离线重新评分
+     */
+    static bool saveCompactGeometry(const std::string& filepath, vtkPolyData* poly);
+    static vtkSmartPointer<vtkPolyData> loadCompactGeometry(const std::string& filepath);
+    // 由 xyz 交错的顶点数组与三角形索引构建 PolyData (几何归档读取的帧)
+    static vtkSmartPointer<vtkPolyData> fromArrays(const std::vector<float>& coords, const std::vector<std::uint32_t>& triangles);
+
     // ================= 核心几何操作 =================
 
     /**
@@ -50,13 +77,44 @@ public:
 	static vtkSmartPointer<vtkPolyData> alignToICP(vtkPolyData* source, vtkPolyData* target);
 
     /**
-     * @brief [修改] 切割模型并拟合平滑闭合曲线 (Spline Fitting)
+     * @brief [新增] 在降采样点集上求 ICP 刚性变换，再把变换作用到完整的 source 上
+     * @param source 需要移动的完整模型 (切片仍需完整网格)
+     * @param sourceLOD source 的降采样点集，原地变换到配准后的位置 (供 computeErrors 使用)
+     * @param targetLOD 基准模型的降采样点集
+     * @return 配准后的完整 source
+     */
+    static vtkSmartPointer<vtkPolyData> alignToICP(vtkPolyData* source, PointLOD& sourceLOD, const PointLOD& targetLOD);
+
+    // ================= 降采样 (LOD) =================
+
+    /**
+     * @brief [新增] 体素降采样，体素边长 voxelSize (与模型同单位)
+     */
+    static PointLOD voxelSubsample(vtkPolyData* poly, double voxelSize);
+
+    /**
+     * @brief [新增] 读取或生成目标模型的 LOD 缓存 (meshPath + ".lod")
+     * 缓存记录源文件大小/修改时间与体素边长，任一不符即重新生成；多个 Worker 并发时先写临时文件再改名
+     */
+    static PointLOD loadOrBuildLOD(const std::string& meshPath, vtkPolyData* poly, double voxelSize);
+
+    /**
+     * @brief [修改] 切割模型并拟合平滑闭合曲线 (傅里叶级数拟合，见 ProfileKernel)
      */
     static bool computeSliceAndFit(vtkPolyData* poly,
         const Eigen::Vector3d& origin,
         const Eigen::Vector3d& normal,
         ProfileData& outProfile);
 
+    /**
+     * @brief [新增] 同一法向的多个截面：一次切割、批量拟合，outProfiles 与 origins 一一对应
+     * @return 拟合成功的截面数
+     */
+    static int computeSlicesAndFit(vtkPolyData* poly,
+        const std::vector<Eigen::Vector3d>& origins,
+        const Eigen::Vector3d& normal,
+        std::vector<ProfileData>& outProfiles);
+
     /**
      * @brief [新增] 将切片数据导出为 CSV 用于调试/绘图
      * @param filepath 输出路径
@@ -79,6 +137,14 @@ public:
      */
     static SimilarityMetrics computeErrors(vtkPolyData* source, vtkPolyData* target);
 
+    /**
+     * @brief [新增] 在降采样点集上计算误差 (source 代表点到完整 target 表面的距离，按原始点数加权)
+     * 与 computeErrors(vtkPolyData*, vtkPolyData*) 同为点到面距离；点到面距离是 1-Lipschitz 的，
+     * 每个原始点被代表点替换最多移动 h√3，因此在同一配准下结果与全分辨率之差不超过 h√3 (写入 errorBound)。
+     * 配准本身也在降采样点集上求得，位姿差异引起的误差不在该上界内
+     */
+    static SimilarityMetrics computeErrors(const PointLOD& source, vtkPolyData* target);
+
     // 计算点到Mesh的有符号距离
     static double getDistanceToMesh(const Eigen::Vector3d& point, vtkImplicitPolyDataDistance* distanceFunc);
 
@@ -0,0 +1,306 @@
+// Core/LossFunction.cpp
+
+#include "LossFunction.h"
+#include "PhaseProfiler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <filesystem>
+
+using namespace Simulation;
+namespace fs = std::filesystem;
+
+std::vector<double> LossFunction::standardSliceHeights(StentType type) {
+    std::vector<double> heights;
+    // 假设支架中心在 Y=0，根据长度分布切片
+    // 注意：这里的单位是 mm
+    switch (type) {
+    case StentType::VenusA_L32: // 长32mm
+        heights = { -6.0, 18.4, 35.4 };
+        break;
+    case StentType::VenusA_L29: // 长29mm
+        heights = { -5.0, 17.3, 35.3 };
+        break;
+    case StentType::VenusA_L26: // 长26mm
+        heights = { -4.5, 16.9, 35.9 };
+        break;
+    case StentType::VenusA_L23: // 长23mm
+        heights = { -7.0, 8.0, 27.5 };
+        break;
+    default: // 默认 L26
+        heights = { -4.5, 16.9, 35.9 };
+        break;
+    }
+    return heights;
+}
+
+std::vector<double> LossFunction::sliceHeights(StentType type, const LossConfig& config) {
+    return config.sliceHeights.empty() ? standardSliceHeights(type) : config.sliceHeights;
+}
+
+LossResult LossFunction::evaluate(vtkPolyData* simPoly, vtkPolyData* targetPoly,
+    const GeometryUtils::PointLOD* targetLOD, double lodVoxelSize,
+    StentType stentType, bool useHausdorff, const LossConfig& config)
+{
+    LossResult result;
+    if (!simPoly || !targetPoly) return result;
+    double totalLoss = 0.0;
+
+    // A. 对齐 (有 LOD 时在降采样点集上求变换，再作用到完整的目标模型上，切片仍使用完整网格)
+    //auto alignedTarget = GeometryUtils::alignToCentroid(targetPoly, simPoly);
+    GeometryUtils::PointLOD simLOD, alignedLOD;
+    if (targetLOD) {
+        simLOD = GeometryUtils::voxelSubsample(simPoly, lodVoxelSize);
+        alignedLOD = *targetLOD;
+        result.alignedTarget = GeometryUtils::alignToICP(targetPoly, alignedLOD, simLOD);
+    }
+    else {
+        result.alignedTarget = GeometryUtils::alignToICP(targetPoly, simPoly);
+    }
+
+    // B. Hausdorff (可选)
+    if (useHausdorff) {
+        result.metrics = targetLOD ? GeometryUtils::computeErrors(alignedLOD, simPoly)
+                                   : GeometryUtils::computeErrors(result.alignedTarget, simPoly);
+        result.hasMetrics = true;
+        result.hausdorffTerm = config.hausdorffWeight * result.metrics.rmse;
+        totalLoss += result.hausdorffTerm;
+    }
+
+    // C. 切片拟合
+    ScopedPhase slicingPhase("slicing");
+    result.sliceHeights = sliceHeights(stentType, config);
+    double sliceLossSum = 0.0;
+
+    // 仿真与目标各自一次切割所有高度、批量拟合
+    std::vector<Eigen::Vector3d> origins;
+    for (double h : result.sliceHeights) origins.push_back(Eigen::Vector3d(0, h, 0));
+    std::vector<GeometryUtils::ProfileData> simProfiles, targetProfiles;
+    GeometryUtils::computeSlicesAndFit(simPoly, origins, Eigen::Vector3d(0, 1, 0), simProfiles);
+    GeometryUtils::computeSlicesAndFit(result.alignedTarget, origins, Eigen::Vector3d(0, 1, 0), targetProfiles);
+
+    for (size_t s = 0; s < origins.size(); ++s) {
+        const GeometryUtils::ProfileData& simProfile = simProfiles[s];
+        const GeometryUtils::ProfileData& targetProfile = targetProfiles[s];
+        bool simOk = simProfile.valid;
+        bool targetOk = targetProfile.valid;
+
+        if (simOk && targetOk) {
+            double sumSqDiff = 0.0;
+            for (int k = 0; k < 360; ++k) {
+                double diff = simProfile.radii[k] - targetProfile.radii[k];
+                sumSqDiff += diff * diff;
+            }
+            double radRMSE = std::sqrt(sumSqDiff / 360.0);
+            double areaPenalty = std::abs(simProfile.area - targetProfile.area) / (targetProfile.area + 1e-6);
+
+            sliceLossSum += (config.radiusWeight * radRMSE + config.areaWeight * areaPenalty);
+            result.validSlices++;
+        }
+        else {
+            sliceLossSum += config.missingSlicePenalty;
+        }
+        result.sliceOk.push_back(simOk && targetOk);
+        result.simProfiles.push_back(simProfile);
+        result.targetProfiles.push_back(targetProfile);
+    }
+
+    result.sliceTerm = result.validSlices > 0 ? sliceLossSum / result.validSlices : config.noSlicePenalty;
+    totalLoss += result.sliceTerm;
+    result.total = totalLoss;
+    return result;
+}
+
+// 单个切面与测量值的误差：轴长为绝对误差 (mm)，面积与周长为相对误差；未测量的项不计入
+static double measuredSliceLoss(const GeometryUtils::ProfileData& sim, const TargetSliceData& target, const LossConfig& config) {
+    double loss = 0.0;
+    if (target.targetLongAxis > 0.0 && target.targetShortAxis > 0.0) {
+        double axisError = 0.5 * (std::abs(sim.longAxis - target.targetLongAxis) + std::abs(sim.shortAxis - target.targetShortAxis));
+        loss += config.axisWeight * axisError;
+    }
+    if (target.targetArea > 0.0) {
+        loss += config.areaWeight * std::abs(sim.area - target.targetArea) / target.targetArea;
+    }
+    if (target.targetCircumference > 0.0) {
+        loss += config.circumferenceWeight * std::abs(sim.circumference - target.targetCircumference) / target.targetCircumference;
+    }
+    return loss;
+}
+
+LossResult LossFunction::evaluateMeasured(vtkPolyData* simPoly, const std::vector<TargetSliceData>& targets, const LossConfig& config) {
+    LossResult result;
+    result.measured = true;
+    if (!simPoly || targets.empty()) return result;
+
+    ScopedPhase slicingPhase("slicing");
+    double sliceLossSum = 0.0;
+    std::vector<Eigen::Vector3d> origins;
+    for (const auto& target : targets) origins.push_back(Eigen::Vector3d(0, target.yHeight, 0));
+    std::vector<GeometryUtils::ProfileData> simProfiles;
+    GeometryUtils::computeSlicesAndFit(simPoly, origins, Eigen::Vector3d(0, 1, 0), simProfiles);
+
+    for (size_t s = 0; s < targets.size(); ++s) {
+        const TargetSliceData& target = targets[s];
+        const GeometryUtils::ProfileData& simProfile = simProfiles[s];
+        bool simOk = simProfile.valid;
+        if (simOk) {
+            sliceLossSum += measuredSliceLoss(simProfile, target, config);
+            result.validSlices++;
+        }
+        else {
+            sliceLossSum += config.missingSlicePenalty;
+        }
+        result.sliceHeights.push_back(target.yHeight);
+        result.sliceOk.push_back(simOk);
+        result.simProfiles.push_back(simProfile);
+    }
+
+    result.sliceTerm = result.validSlices > 0 ? sliceLossSum / result.validSlices : config.noSlicePenalty;
+    result.total = result.sliceTerm;
+    return result;
+}
+
+std::vector<TargetSliceData> LossFunction::measureTarget(vtkPolyData* targetPoly, const std::vector<double>& heights) {
+    std::vector<TargetSliceData> targets;
+    std::vector<Eigen::Vector3d> origins;
+    for (double h : heights) origins.push_back(Eigen::Vector3d(0, h, 0));
+    std::vector<GeometryUtils::ProfileData> profiles;
+    GeometryUtils::computeSlicesAndFit(targetPoly, origins, Eigen::Vector3d(0, 1, 0), profiles);
+    for (size_t s = 0; s < heights.size(); ++s) {
+        const auto& profile = profiles[s];
+        if (!profile.valid) {
+            std::cerr << "[Loss] Target slice at height " << heights[s] << " could not be measured, skipped" << std::endl;
+            continue;
+        }
+        targets.push_back({ heights[s], profile.longAxis, profile.shortAxis, profile.area, profile.circumference });
+    }
+    return targets;
+}
+
+bool LossFunction::loadOrMeasureTargets(const std::string& slicesPath, const std::string& meshPath,
+    const std::vector<double>& heights, std::vector<TargetSliceData>& targets)
+{
+    targets.clear();
+    std::error_code ec;
+    bool haveMesh = fs::exists(meshPath, ec);
+    std::uint64_t bytes = haveMesh ? fs::file_size(meshPath, ec) : 0;
+    std::int64_t mtime = haveMesh && !ec ? (std::int64_t)fs::last_write_time(meshPath, ec).time_since_epoch().count() : 0;
+
+    // 1. 读取已有文件
+    {
+        std::ifstream in(slicesPath);
+        if (in.is_open()) {
+            bool generated = false, fresh = true;
+            std::vector<TargetSliceData> records;
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.empty()) continue;
+                std::stringstream ss(line);
+                if (line[0] == '#') {
+                    std::string hash, key;
+                    ss >> hash >> key;
+                    if (key == "source") {
+                        std::uint64_t fileBytes = 0;
+                        std::int64_t fileMtime = 0;
+                        ss >> fileBytes >> fileMtime;
+                        generated = true;
+                        if (haveMesh && (fileBytes != bytes || fileMtime != mtime)) fresh = false;
+                    }
+                    else if (key == "heights") {
+                        std::vector<double> fileHeights;
+                        double h;
+                        while (ss >> h) fileHeights.push_back(h);
+                        bool same = fileHeights.size() == heights.size();
+                        for (size_t i = 0; same && i < heights.size(); ++i) same = std::abs(fileHeights[i] - heights[i]) < 1e-6;
+                        if (haveMesh && !same) fresh = false;
+                    }
+                    continue;
+                }
+                TargetSliceData record{};
+                char comma;
+                if (ss >> record.yHeight >> comma >> record.targetLongAxis >> comma >> record.targetShortAxis
+                    >> comma >> record.targetArea >> comma >> record.targetCircumference) {
+                    records.push_back(record);
+                }
+            }
+            if (!generated || fresh) {
+                targets = records;
+                std::cout << "[Loss] " << targets.size() << " target slice measurement(s) from " << slicesPath
+                    << (generated ? "" : " (clinical)") << std::endl;
+                return !targets.empty();
+            }
+        }
+    }
+    if (!haveMesh) return false;
+
+    // 2. 由目标 STL 测量并写入 (临时文件 + 改名，避免并发 Worker 读到半个文件)
+    auto targetPoly = GeometryUtils::loadSTL(meshPath);
+    if (!targetPoly || targetPoly->GetNumberOfPoints() == 0) return false;
+    targets = measureTarget(targetPoly, heights);
+    if (targets.empty()) return false;
+
+    std::string tmpPath = slicesPath + ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream out(tmpPath);
+        out.precision(10);
+        out << "# source " << bytes << " " << mtime << "\n";
+        out << "# heights";
+        for (double h : heights) out << " " << h;
+        out << "\n";
+        out << "Height,LongAxis,ShortAxis,Area,Circumference\n";
+        for (const auto& t : targets) {
+            out << t.yHeight << "," << t.targetLongAxis << "," << t.targetShortAxis << ","
+                << t.targetArea << "," << t.targetCircumference << "\n";
+        }
+    }
+    fs::rename(tmpPath, slicesPath, ec);
+    if (ec) fs::remove(tmpPath, ec);
+    std::cout << "[Loss] Measured " << targets.size() << " target slice(s), cached in " << slicesPath << std::endl;
+    return true;
+}
+
+bool LossFunction::load(const std::string& path, LossConfig& config) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string key;
+        if (!(ss >> key) || key[0] == '#') continue;
+        if (key == "hausdorff_weight") ss >> config.hausdorffWeight;
+        else if (key == "radius_weight") ss >> config.radiusWeight;
+        else if (key == "area_weight") ss >> config.areaWeight;
+        else if (key == "missing_slice_penalty") ss >> config.missingSlicePenalty;
+        else if (key == "no_slice_penalty") ss >> config.noSlicePenalty;
+        else if (key == "measured_slices") ss >> config.measuredSlices;
+        else if (key == "axis_weight") ss >> config.axisWeight;
+        else if (key == "circumference_weight") ss >> config.circumferenceWeight;
+        else if (key == "slice_heights") {
+            config.sliceHeights.clear();
+            double h;
+            while (ss >> h) config.sliceHeights.push_back(h);
+        }
+        else std::cerr << "[Loss] Unknown key in " << path << ": " << key << std::endl;
+    }
+    return true;
+}
+
+void LossFunction::save(const std::string& path, const LossConfig& config) {
+    std::ofstream out(path);
+    out << "hausdorff_weight " << config.hausdorffWeight << "\n";
+    out << "radius_weight " << config.radiusWeight << "\n";
+    out << "area_weight " << config.areaWeight << "\n";
+    out << "missing_slice_penalty " << config.missingSlicePenalty << "\n";
+    out << "no_slice_penalty " << config.noSlicePenalty << "\n";
+    out << "measured_slices " << (config.measuredSlices ? 1 : 0) << "\n";
+    out << "axis_weight " << config.axisWeight << "\n";
+    out << "circumference_weight " << config.circumferenceWeight << "\n";
+    if (!config.sliceHeights.empty()) {
+        out << "slice_heights";
+        for (double h : config.sliceHeights) out << " " << h;
+        out << "\n";
+    }
+}
@@ -0,0 +1,79 @@
+// Core/LossFunction.h
+
+#pragma once
+#include <string>
+#include <vector>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include "GeometryUtils.h"
+#include "Common.h"
+
+// 目标切面的测量数据 (真实值)，高度为支架坐标系下的 Y (mm)；
+// 由目标 STL 测量一次后缓存，或直接来自临床测量 (某项 <= 0 表示未测量，不参与误差)
+struct TargetSliceData {
+    double yHeight;
+    double targetLongAxis;
+    double targetShortAxis;
+    double targetArea;
+    double targetCircumference;
+};
+
+// 误差计算的中间结果 (用于导出切片与打印)
+struct LossResult {
+    double total = 1e9;
+    double hausdorffTerm = 0.0;
+    double sliceTerm = 0.0;
+    int validSlices = 0;
+    bool hasMetrics = false;
+    GeometryUtils::SimilarityMetrics metrics{ 0, 0, 0 };
+    vtkSmartPointer<vtkPolyData> alignedTarget;
+    std::vector<double> sliceHeights;
+    std::vector<bool> sliceOk;
+    std::vector<GeometryUtils::ProfileData> simProfiles;
+    std::vector<GeometryUtils::ProfileData> targetProfiles;   // 测量值模式下为空
+    bool measured = false;                                    // 是否为测量值模式 (见 evaluateMeasured)
+};
+
+// 由仿真得到的支架几何与目标支架计算误差：配准 -> (可选) 点集距离 -> 切片拟合
+// SimulationRunner 与离线重新评分工具 (Rescore) 共用，保证同一 LossConfig 下两者结果一致
+class LossFunction {
+public:
+    /**
+     * @brief 计算误差
+     * @param simPoly 仿真结束时的支架几何
+     * @param targetPoly 目标支架 (未配准)
+     * @param targetLOD 目标支架的降采样点集 (为空时在全分辨率上配准与计算距离)
+     * @param lodVoxelSize 仿真几何的降采样体素边长 (targetLOD 非空时使用)
+     */
+    static LossResult evaluate(vtkPolyData* simPoly, vtkPolyData* targetPoly,
+        const GeometryUtils::PointLOD* targetLOD, double lodVoxelSize,
+        Simulation::StentType stentType, bool useHausdorff, const LossConfig& config);
+
+    /**
+     * @brief 测量值模式：只切割仿真几何，与目标切面测量值比较 (长/短轴、面积、周长)
+     * 不涉及目标网格，因此没有配准与点集距离项；切片高度取各测量值的 yHeight
+     */
+    static LossResult evaluateMeasured(vtkPolyData* simPoly, const std::vector<TargetSliceData>& targets, const LossConfig& config);
+
+    // 各支架型号的标准切片高度 (mm)
+    static std::vector<double> standardSliceHeights(Simulation::StentType type);
+    // 实际使用的切片高度 (config.sliceHeights 为空时取标准高度)
+    static std::vector<double> sliceHeights(Simulation::StentType type, const LossConfig& config);
+
+    // ================= 目标切面测量值 =================
+
+    // 在给定高度切割目标网格 (目标须位于支架坐标系中) 并测量，拟合失败的高度不记录
+    static std::vector<TargetSliceData> measureTarget(vtkPolyData* targetPoly, const std::vector<double>& heights);
+
+    /**
+     * @brief 读取或生成目标切面测量值 (CSV: Height,LongAxis,ShortAxis,Area,Circumference)
+     * 由目标 STL 生成的文件带 "# source <大小> <修改时间>" 与 "# heights ..." 注释，与当前 STL 或切片高度不符时重新测量；
+     * 没有这两行的文件视为临床测量，始终直接使用 (此时可以没有目标 STL)。多个 Worker 并发时先写临时文件再改名
+     */
+    static bool loadOrMeasureTargets(const std::string& slicesPath, const std::string& meshPath,
+        const std::vector<double>& heights, std::vector<TargetSliceData>& targets);
+
+    // 文本格式：每行 "<键> <值>"，slice_heights 后跟任意个高度；# 开头为注释
+    static bool load(const std::string& path, LossConfig& config);
+    static void save(const std::string& path, const LossConfig& config);
+};
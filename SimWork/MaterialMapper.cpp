@@ -2,6 +2,7 @@
 
 #include "MaterialMapper.h"
 #include "GeometryUtils.h"
+#include "PhaseProfiler.h"
 #include <algorithm>
 #include <iostream>
 #include <omp.h>
@@ -51,6 +52,7 @@ void MaterialMapper::applyMaterials(Simulation::Model* model, const std::map<std
     }
 
     int updatedCount = 0;
+    ScopedPhase queryPhase("material_query");   // 单元质心到各区域的距离查询 (material_apply 的主体)
 
     // [调试建议] 暂时注释掉 OpenMP，防止多线程掩盖具体的越界错误
     // #pragma omp parallel for reduction(+:updatedCount)
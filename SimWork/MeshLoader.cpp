@@ -0,0 +1,214 @@
+// Core/MeshLoader.cpp
+
+#include "MeshLoader.h"
+#include "../../Optimize/Utils/MappedFile.h"
+#include <iostream>
+#include <cstring>
+#include <charconv>
+
+// ================= 文本解析辅助 =================
+
+static inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+// 无 locale 的浮点解析 (std::from_chars)，p 前移到数字之后
+static inline bool parseFloat(const char*& p, const char* end, float& value) {
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+static inline bool parseInt(const char*& p, const char* end, long& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+// ================= STL =================
+
+bool MeshLoader::loadSTL(const std::string& filepath, MeshData& mesh, bool dedup) {
+    mesh.coords.clear();
+    mesh.triangles.clear();
+    MappedFile file;
+    if (!file.open(filepath) || file.size() < 15) return false;
+
+    // 二进制 STL 的长度严格等于 84 + 50 * 三角形数 (部分二进制文件头也以 "solid" 开头，不能只看前缀)
+    bool ok = false;
+    if (file.size() >= 84) {
+        std::uint32_t count;
+        std::memcpy(&count, file.data() + 80, sizeof(count));
+        if (84 + 50ull * count == file.size()) ok = parseBinarySTL(file.data(), file.size(), mesh);
+    }
+    if (!ok) {
+        const char* text = reinterpret_cast<const char*>(file.data());
+        ok = parseAsciiSTL(text, text + file.size(), mesh);
+    }
+    if (!ok) return false;
+    if (dedup) dedupVertices(mesh);
+    return true;
+}
+
+bool MeshLoader::parseBinarySTL(const std::uint8_t* data, size_t size, MeshData& mesh) {
+    std::uint32_t count;
+    std::memcpy(&count, data + 80, sizeof(count));
+    if (size < 84 + 50ull * count) return false;
+    mesh.coords.resize((size_t)count * 9);
+    mesh.triangles.resize((size_t)count * 3);
+    const std::uint8_t* p = data + 84;
+    float* out = mesh.coords.data();
+    // 每条记录: 法向 12 字节 + 3 顶点 36 字节 + 属性 2 字节 (记录未对齐，逐条 memcpy)
+    for (std::uint32_t t = 0; t < count; ++t, p += 50, out += 9) {
+        std::memcpy(out, p + 12, 36);
+        mesh.triangles[t * 3] = t * 3;
+        mesh.triangles[t * 3 + 1] = t * 3 + 1;
+        mesh.triangles[t * 3 + 2] = t * 3 + 2;
+    }
+    return count > 0;
+}
+
+bool MeshLoader::parseAsciiSTL(const char* begin, const char* end, MeshData& mesh) {
+    // 只需要 "vertex x y z"，facet/outer loop 等关键字无需解析
+    const char* p = begin;
+    while (p < end) {
+        const char* v = static_cast<const char*>(std::memchr(p, 'v', end - p));
+        if (!v) break;
+        p = v + 1;
+        if (end - v < 7 || std::memcmp(v, "vertex", 6) != 0 || !isBlank(v[6])) continue;
+        if (v > begin && !isBlank(v[-1]) && v[-1] != '\n') continue;
+        p = v + 6;
+        float xyz[3];
+        if (!parseFloat(p, end, xyz[0]) || !parseFloat(p, end, xyz[1]) || !parseFloat(p, end, xyz[2])) return false;
+        mesh.coords.insert(mesh.coords.end(), xyz, xyz + 3);
+    }
+    size_t numTriangles = mesh.coords.size() / 9;
+    if (numTriangles == 0) return false;
+    mesh.coords.resize(numTriangles * 9);
+    mesh.triangles.resize(numTriangles * 3);
+    for (size_t i = 0; i < mesh.triangles.size(); ++i) mesh.triangles[i] = (std::uint32_t)i;
+    return true;
+}
+
+// ================= OBJ =================
+
+bool MeshLoader::loadOBJ(const std::string& filepath, MeshData& mesh) {
+    mesh.coords.clear();
+    mesh.triangles.clear();
+    MappedFile file;
+    if (!file.open(filepath) || file.size() == 0) return false;
+
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* end = p + file.size();
+    mesh.coords.reserve(file.size() / 12);
+    mesh.triangles.reserve(file.size() / 8);
+
+    std::vector<long> face;   // 当前面的顶点索引 (复用，不逐面分配)
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* q = skipBlanks(p, lineEnd);
+
+        if (lineEnd - q >= 2 && q[0] == 'v' && isBlank(q[1])) {
+            // 顶点 (忽略可选的 w / 颜色分量)
+            q += 1;
+            float xyz[3];
+            if (!parseFloat(q, lineEnd, xyz[0]) || !parseFloat(q, lineEnd, xyz[1]) || !parseFloat(q, lineEnd, xyz[2])) return false;
+            mesh.coords.insert(mesh.coords.end(), xyz, xyz + 3);
+        }
+        else if (lineEnd - q >= 2 && q[0] == 'f' && isBlank(q[1])) {
+            // 面：每个顶点取第一个索引，跳过 /vt/vn
+            q += 1;
+            face.clear();
+            long numVertices = (long)(mesh.coords.size() / 3);
+            while (true) {
+                q = skipBlanks(q, lineEnd);
+                if (q >= lineEnd) break;
+                long idx;
+                if (!parseInt(q, lineEnd, idx) || idx == 0) return false;
+                face.push_back(idx > 0 ? idx - 1 : numVertices + idx);
+                while (q < lineEnd && !isBlank(*q)) ++q;
+            }
+            for (size_t k = 1; k + 1 < face.size(); ++k) {
+                mesh.triangles.push_back((std::uint32_t)face[0]);
+                mesh.triangles.push_back((std::uint32_t)face[k]);
+                mesh.triangles.push_back((std::uint32_t)face[k + 1]);
+            }
+        }
+        p = lineEnd + 1;
+    }
+
+    // 索引可能引用后面才定义的顶点，全部读完后再检查范围
+    size_t numPoints = mesh.numPoints();
+    for (std::uint32_t idx : mesh.triangles) {
+        if (idx >= numPoints) {
+            std::cerr << "[MeshLoader] Face index out of range in " << filepath << std::endl;
+            return false;
+        }
+    }
+    return numPoints > 0;
+}
+
+// ================= 顶点合并 =================
+
+static inline std::uint32_t floatBits(float v) {
+    if (v == 0.0f) v = 0.0f;   // -0 与 +0 视为同一坐标
+    std::uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+void MeshLoader::dedupVertices(MeshData& mesh) {
+    size_t n = mesh.numPoints();
+    if (n == 0) return;
+    size_t capacity = 16;
+    while (capacity < n * 2) capacity <<= 1;
+    const std::uint32_t EMPTY = 0xFFFFFFFFu;
+    std::vector<std::uint32_t> table(capacity, EMPTY);   // 存放合并后的顶点编号
+    std::vector<std::uint32_t> remap(n);
+    std::vector<float> merged;
+    merged.reserve(n * 3 / 4);
+
+    for (size_t i = 0; i < n; ++i) {
+        const float* v = &mesh.coords[i * 3];
+        std::uint32_t bx = floatBits(v[0]), by = floatBits(v[1]), bz = floatBits(v[2]);
+        std::uint64_t h = (std::uint64_t)bx * 0x9E3779B97F4A7C15ull;
+        h ^= ((std::uint64_t)by + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= ((std::uint64_t)bz + 0x165667B19E3779F9ull) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 29;
+        size_t slot = (size_t)h & (capacity - 1);
+        while (true) {
+            std::uint32_t id = table[slot];
+            if (id == EMPTY) {
+                id = (std::uint32_t)(merged.size() / 3);
+                table[slot] = id;
+                merged.push_back(v[0]); merged.push_back(v[1]); merged.push_back(v[2]);
+                remap[i] = id;
+                break;
+            }
+            const float* m = &merged[(size_t)id * 3];
+            if (floatBits(m[0]) == bx && floatBits(m[1]) == by && floatBits(m[2]) == bz) {
+                remap[i] = id;
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+    // 合并后退化 (有重复顶点) 的三角形丢弃
+    size_t kept = 0;
+    for (size_t t = 0; t + 2 < mesh.triangles.size(); t += 3) {
+        std::uint32_t a = remap[mesh.triangles[t]], b = remap[mesh.triangles[t + 1]], c = remap[mesh.triangles[t + 2]];
+        if (a == b || a == c || b == c) continue;
+        mesh.triangles[kept++] = a;
+        mesh.triangles[kept++] = b;
+        mesh.triangles[kept++] = c;
+    }
+    mesh.triangles.resize(kept);
+    mesh.coords.swap(merged);
+}
@@ -0,0 +1,34 @@
+// Core/MeshLoader.h
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 原生网格加载：内存映射文件后直接解码到扁平数组 (float32 顶点 xyz 交错 + uint32 三角形索引)，
+// 不经过 VTK 的通用容器，也没有逐三角形的内存分配。
+//   STL: 二进制直接从映射内存解码；ASCII 按 "vertex x y z" 解析。每个三角形 3 个独立顶点，
+//        dedup 时按坐标 (位模式) 哈希合并，与 vtkSTLReader 的默认合并行为一致
+//   OBJ: 解析 v / f 行 (支持 i、i/j、i//k、i/j/k 与负索引)，多边形按扇形三角化，其余行忽略
+// 需要 vtkPolyData 的调用方使用 GeometryUtils::loadSTL / loadOBJ (内部调用本类再转换)
+struct MeshData {
+    std::vector<float> coords;
+    std::vector<std::uint32_t> triangles;
+
+    size_t numPoints() const { return coords.size() / 3; }
+    size_t numTriangles() const { return triangles.size() / 3; }
+};
+
+class MeshLoader {
+public:
+    static bool loadSTL(const std::string& filepath, MeshData& mesh, bool dedup = true);
+    static bool loadOBJ(const std::string& filepath, MeshData& mesh);
+
+    // 合并坐标完全相同的顶点并重写三角形索引 (开放寻址哈希，保持首次出现的顺序)；
+    // 合并后退化的三角形被丢弃 (与 vtkSTLReader 相同)
+    static void dedupVertices(MeshData& mesh);
+
+private:
+    static bool parseBinarySTL(const std::uint8_t* data, size_t size, MeshData& mesh);
+    static bool parseAsciiSTL(const char* begin, const char* end, MeshData& mesh);
+};
@@ -0,0 +1,153 @@
+// Core/PerfCounters.cpp
+
+#include "PerfCounters.h"
+#include <iostream>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#else
+#include <unistd.h>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <dirent.h>
+#include <cstdlib>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#endif
+
+const char* PerfCounters::counterName(int counter) {
+    static const char* names[CounterCount] = { "cycles", "instructions", "cache_misses", "dtlb_misses" };
+    return names[counter];
+}
+
+PerfCounters::~PerfCounters() {
+#if !defined(_WIN32)
+    for (const auto& thread : m_threads) {
+        for (int fd : thread.second) {
+            if (fd >= 0) close(fd);
+        }
+    }
+#endif
+}
+
+// probe 为 true 时尝试所有计数器 (enable 时在当前线程上探测可用性)，否则只打开已知可用的
+PerfCounters::ThreadFds PerfCounters::openThread(long tid, bool probe) const {
+    ThreadFds fds;
+    fds.fill(-1);
+#ifdef __linux__
+    struct Config { std::uint32_t type; std::uint64_t config; };
+    const Config configs[CounterCount] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    };
+    for (int c = 0; c < CounterCount; ++c) {
+        if (!probe && !m_available[c]) continue;
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = configs[c].type;
+        attr.config = configs[c].config;
+        attr.exclude_kernel = 1;   // perf_event_paranoid = 2 时仍可用
+        attr.exclude_hv = 1;
+        // 不使用 inherit：继承的计数要到子线程退出才并入，读不到并行阶段中线程池的计数
+        int fd = (int)syscall(SYS_perf_event_open, &attr, (pid_t)tid, -1, -1, 0);
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        fds[c] = fd;
+    }
+#else
+    (void)tid;
+    (void)probe;
+#endif
+    return fds;
+}
+
+void PerfCounters::attachNewThreads() const {
+#ifdef __linux__
+    bool any = false;
+    for (int c = 0; c < CounterCount; ++c) any = any || m_available[c];
+    if (!any) return;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return;
+    while (dirent* entry = readdir(dir)) {
+        long tid = std::atol(entry->d_name);
+        if (tid <= 0 || m_threads.count(tid)) continue;
+        m_threads[tid] = openThread(tid, false);
+    }
+    closedir(dir);
+#endif
+}
+
+bool PerfCounters::enable() {
+    if (m_enabled) return true;
+#ifdef _WIN32
+    m_available[Cycles] = true;
+#elif defined(__linux__)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    long self = (long)syscall(SYS_gettid);
+    ThreadFds fds = openThread(self, true);
+    for (int c = 0; c < CounterCount; ++c) m_available[c] = fds[c] >= 0;
+    m_threads[self] = fds;
+    attachNewThreads();
+    if (!m_available[Cycles]) {
+        std::cerr << "[PerfCounters] Hardware counters unavailable (perf_event_open failed), reporting memory only" << std::endl;
+    }
+#endif
+    m_enabled = true;
+    return true;
+}
+
+PerfCounters::Sample PerfCounters::read() const {
+    Sample sample;
+    if (!m_enabled) return sample;
+#ifdef _WIN32
+    ULONG64 cycles = 0;
+    if (QueryProcessCycleTime(GetCurrentProcess(), &cycles)) sample.hw[Cycles] = cycles;
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        sample.minorFaults = (double)pmc.PageFaultCount;   // Windows 不区分软/硬页错误
+        sample.peakRssMb = pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        attachNewThreads();
+        for (const auto& thread : m_threads) {
+            for (int c = 0; c < CounterCount; ++c) {
+                if (thread.second[c] < 0) continue;
+                std::uint64_t value = 0;
+                if (::read(thread.second[c], &value, sizeof(value)) == (ssize_t)sizeof(value)) sample.hw[c] += value;
+            }
+        }
+    }
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        sample.minorFaults = (double)usage.ru_minflt;
+        sample.majorFaults = (double)usage.ru_majflt;
+#ifdef __APPLE__
+        sample.peakRssMb = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        sample.peakRssMb = usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+    return sample;
+}
+
+std::vector<std::pair<std::string, double>> PerfCounters::delta(const Sample& begin, const Sample& end) const {
+    std::vector<std::pair<std::string, double>> out;
+    if (!m_enabled) return out;
+    for (int c = 0; c < CounterCount; ++c) {
+        if (m_available[c]) out.emplace_back(counterName(c), (double)(end.hw[c] - begin.hw[c]));
+    }
+    out.emplace_back("minor_faults", end.minorFaults - begin.minorFaults);
+    out.emplace_back("major_faults", end.majorFaults - begin.majorFaults);
+    return out;
+}
@@ -0,0 +1,61 @@
+// Core/PerfCounters.h
+
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <array>
+#include <map>
+#include <mutex>
+
+// 进程级硬件性能计数器与内存指标 (可选，环境变量 SIMWORKER_PERF_COUNTERS=1 启用)
+//   Linux:   perf_event_open (cycles / instructions / LLC 缺失 / dTLB 缺失，仅用户态) + getrusage
+//   Windows: QueryProcessCycleTime (cycles) + GetProcessMemoryInfo
+// 不可用的计数器 (权限、虚拟机、平台) 自动跳过，不影响仿真；
+// Linux 上计数器按线程打开、读取时求和：每次采样为新出现的线程 (OpenMP 线程池等) 打开计数器，
+// 线程从被发现的那次采样 (通常是下一个阶段边界) 起计入，已退出线程的计数保留
+class PerfCounters {
+public:
+    enum Counter { Cycles, Instructions, CacheMisses, DtlbMisses, CounterCount };
+
+    struct Sample {
+        std::uint64_t hw[CounterCount] = { 0, 0, 0, 0 };
+        double minorFaults = 0.0;
+        double majorFaults = 0.0;
+        double peakRssMb = 0.0;
+    };
+
+    static PerfCounters& instance() {
+        static PerfCounters counters;
+        return counters;
+    }
+
+    // 打开计数器，返回是否至少有一项可用 (页错误/峰值内存在支持的平台上总是可用)
+    bool enable();
+    bool enabled() const { return m_enabled; }
+
+    Sample read() const;
+
+    // 两次采样之差，按 "<名称> <值>" 输出可用的项
+    std::vector<std::pair<std::string, double>> delta(const Sample& begin, const Sample& end) const;
+
+    static const char* counterName(int counter);
+
+private:
+    PerfCounters() = default;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    using ThreadFds = std::array<int, CounterCount>;
+
+    // 为尚未打开计数器的线程打开计数器 (持有 m_mutex 调用)
+    void attachNewThreads() const;
+    ThreadFds openThread(long tid, bool probe) const;
+
+    bool m_enabled = false;
+    bool m_available[CounterCount] = { false, false, false, false };
+    mutable std::mutex m_mutex;
+    mutable std::map<long, ThreadFds> m_threads;   // 线程 id -> 各计数器的 fd (不可用为 -1)
+};
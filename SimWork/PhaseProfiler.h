@@ -0,0 +1,122 @@
+// Core/PhaseProfiler.h
+
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include "PerfCounters.h"
+
+// 进程级的阶段计时器：同名阶段累加 (例如多次切片)，按首次出现的顺序输出
+// 嵌套阶段各自计时，外层时间包含内层
+// 启用 PerfCounters 时同时累加各阶段的硬件计数器与页错误增量
+class PhaseProfiler {
+public:
+    static PhaseProfiler& instance() {
+        static PhaseProfiler profiler;
+        return profiler;
+    }
+
+    void record(const std::string& phase, double ms) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : m_phases) {
+            if (entry.first == phase) { entry.second += ms; return; }
+        }
+        m_phases.emplace_back(phase, ms);
+    }
+
+    void recordCounters(const std::string& phase, const std::vector<std::pair<std::string, double>>& deltas) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& d : deltas) {
+            std::string key = phase + "." + d.first;
+            bool found = false;
+            for (auto& entry : m_counters) {
+                if (entry.first == key) { entry.second += d.second; found = true; break; }
+            }
+            if (!found) m_counters.emplace_back(key, d.second);
+        }
+    }
+
+    // 磁盘缓存的查找结果 (如目标 LOD)，随输出文件上报给 Optimizer 的运行指标
+    void recordCache(const std::string& cache, bool hit) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_caches.emplace_back(cache, hit);
+    }
+
+    std::vector<std::pair<std::string, double>> snapshot() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_phases;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_phases.clear();
+        m_counters.clear();
+        m_caches.clear();
+    }
+
+    // 以 "phase <name> <ms>" 的行格式写出 (SimWorker 输出文件协议)，缓存查找为 "cache <name> <0|1>"；
+    // 启用计数器时另有 "counter <phase>.<name> <value>" 与进程峰值内存 "counter peak_rss_mb <MB>"
+    void writeTo(std::ostream& out) const {
+        for (const auto& entry : snapshot()) {
+            out << "phase " << entry.first << " " << entry.second << "\n";
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : m_caches) out << "cache " << entry.first << " " << (entry.second ? 1 : 0) << "\n";
+        }
+        PerfCounters& counters = PerfCounters::instance();
+        if (!counters.enabled()) return;
+        std::vector<std::pair<std::string, double>> values;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            values = m_counters;
+        }
+        for (const auto& entry : values) {
+            out << "counter " << entry.first << " " << (long long)entry.second << "\n";
+        }
+        out << "counter peak_rss_mb " << counters.read().peakRssMb << "\n";
+    }
+
+private:
+    PhaseProfiler() = default;
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<std::string, double>> m_phases;
+    std::vector<std::pair<std::string, double>> m_counters;
+    std::vector<std::pair<std::string, bool>> m_caches;
+};
+
+// RAII 计时：构造时开始，析构 (或 stop) 时记录，使用单调时钟
+class ScopedPhase {
+public:
+    explicit ScopedPhase(const char* name)
+        : m_name(name), m_counting(PerfCounters::instance().enabled()), m_start(std::chrono::steady_clock::now())
+    {
+        if (m_counting) m_counters = PerfCounters::instance().read();
+    }
+
+    ~ScopedPhase() { stop(); }
+
+    void stop() {
+        if (m_stopped) return;
+        m_stopped = true;
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        PhaseProfiler::instance().record(m_name, std::chrono::duration<double, std::milli>(elapsed).count());
+        if (m_counting) {
+            PerfCounters& counters = PerfCounters::instance();
+            PhaseProfiler::instance().recordCounters(m_name, counters.delta(m_counters, counters.read()));
+        }
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    const char* m_name;
+    bool m_counting;
+    PerfCounters::Sample m_counters;
+    std::chrono::steady_clock::time_point m_start;
+    bool m_stopped = false;
+};
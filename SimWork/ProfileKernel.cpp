@@ -0,0 +1,193 @@
+// Core/ProfileKernel.cpp
+
+#include "ProfileKernel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int N = ProfileKernel::kBins;
+constexpr int M = ProfileKernel::kSamples;
+
+// |x| <= π/4 时的泰勒级数 (截断误差远小于 double 精度)
+constexpr double taylorSin(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n <= 10; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double taylorCos(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n <= 10; ++n) {
+        term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// 整数角度 (度) 的正弦：按半周与象限对称归约到 [0°, 45°]，整数角度的归约是精确的
+constexpr double sinDegrees(int d) {
+    d %= 360;
+    if (d < 0) d += 360;
+    if (d >= 180) return -sinDegrees(d - 180);
+    if (d > 90) d = 180 - d;
+    return d <= 45 ? taylorSin(d * kPi / 180.0) : taylorCos((90 - d) * kPi / 180.0);
+}
+
+template <bool Cosine>
+constexpr std::array<double, M> makeTable() {
+    std::array<double, M> table{};
+    for (int i = 0; i < M; ++i) table[i] = Cosine ? sinDegrees(i + 90) : sinDegrees(i);
+    return table;
+}
+
+constexpr std::array<double, M> kCos = makeTable<true>();
+constexpr std::array<double, M> kSin = makeTable<false>();
+static_assert(kCos[0] == 1.0 && kSin[90] == 1.0 && kCos[180] == -1.0, "trig table");
+
+// 无分支的 atan2 近似 (11 阶极小极大多项式，误差约 1e-5 rad，远小于 10° 的桶宽)，返回 [0, 2π)
+inline double polarAngle(double x, double y) {
+    double ax = std::abs(x), ay = std::abs(y);
+    double mx = std::max(ax, ay), mn = std::min(ax, ay);
+    double t = mn / (mx > 0.0 ? mx : 1.0);
+    double t2 = t * t;
+    double a = t * (0.99997726 + t2 * (-0.33262347 + t2 * (0.19354346 + t2 * (-0.11643287 + t2 * (0.05265332 + t2 * -0.01172120)))));
+    a = ay > ax ? 0.5 * kPi - a : a;
+    a = x < 0.0 ? kPi - a : a;
+    return y < 0.0 ? 2.0 * kPi - a : a;
+}
+
+// 单个截面：分桶 -> 填补 -> 平滑，得到 36 个结点值 (第 j 个结点位于 10j°，与原样条拟合的结点位置相同)
+bool binProfile(const double* x, const double* y, std::size_t n, std::vector<double>& r, std::vector<int>& bin, double* knots) {
+    if (n == 0) return false;
+    r.resize(n);
+    bin.resize(n);
+    // 极坐标转换 (无分支，可向量化)
+    const double binScale = N / (2.0 * kPi);
+    for (std::size_t i = 0; i < n; ++i) {
+        r[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        bin[i] = std::min(N - 1, (int)(polarAngle(x[i], y[i]) * binScale));
+    }
+    double sum[N] = {};
+    int count[N] = {};
+    for (std::size_t i = 0; i < n; ++i) {
+        sum[bin[i]] += r[i];
+        count[bin[i]]++;
+    }
+
+    // 空桶：左右最近的非空桶 (含已填补的桶) 的均值
+    double mean[N];
+    bool has[N];
+    for (int i = 0; i < N; ++i) {
+        has[i] = count[i] > 0;
+        mean[i] = has[i] ? sum[i] / count[i] : 0.0;
+    }
+    for (int i = 0; i < N; ++i) {
+        if (has[i]) continue;
+        int left = (i - 1 + N) % N;
+        while (!has[left] && left != i) left = (left - 1 + N) % N;
+        int right = (i + 1) % N;
+        while (!has[right] && right != i) right = (right + 1) % N;
+        if (!has[left] || !has[right]) return false;
+        mean[i] = 0.5 * (mean[left] + mean[right]);
+        has[i] = true;
+    }
+
+    // 3 点周期平滑 [0.25, 0.5, 0.25]
+    for (int i = 0; i < N; ++i) {
+        knots[i] = 0.25 * mean[(i - 1 + N) % N] + 0.5 * mean[i] + 0.25 * mean[(i + 1) % N];
+    }
+    return true;
+}
+
+} // namespace
+
+const std::array<double, ProfileKernel::kSamples>& ProfileKernel::cosTable() { return kCos; }
+const std::array<double, ProfileKernel::kSamples>& ProfileKernel::sinTable() { return kSin; }
+
+void ProfileKernel::fit(const Batch& batch, Result& result, int order) {
+    const int count = batch.size();
+    order = std::clamp(order, 1, N / 2);
+    result.radii.assign((std::size_t)count * M, 0.0);
+    result.area.assign(count, 0.0);
+    result.circumference.assign(count, 0.0);
+    result.longAxis.assign(count, 0.0);
+    result.shortAxis.assign(count, 0.0);
+    result.valid.assign(count, 0);
+
+    std::vector<double> r;
+    std::vector<int> bin;
+    std::vector<double> deriv(M);
+    const double dTheta = 2.0 * kPi / M;
+    const int knotStep = M / N;   // 结点间隔 (度)
+
+    for (int p = 0; p < count; ++p) {
+        const std::size_t begin = batch.offsets[p], end = batch.offsets[p + 1];
+        double knots[N];
+        if (!binProfile(batch.x.data() + begin, batch.y.data() + begin, end - begin, r, bin, knots)) continue;
+
+        // 1. 傅里叶系数 (36 个等距结点上的离散傅里叶变换，k = N/2 为奈奎斯特项)
+        double a[N / 2 + 1] = {}, b[N / 2 + 1] = {};
+        for (int k = 0; k <= order; ++k) {
+            int idx = 0;
+            for (int j = 0; j < N; ++j) {
+                a[k] += knots[j] * kCos[idx];
+                b[k] += knots[j] * kSin[idx];
+                idx += k * knotStep;
+                if (idx >= M) idx %= M;
+            }
+            double scale = (k == 0 || k == N / 2) ? 1.0 / N : 2.0 / N;
+            a[k] *= scale;
+            b[k] *= scale;
+        }
+
+        // 2. 查表重采样半径与导数
+        double* radii = result.radii.data() + (std::size_t)p * M;
+        std::fill(radii, radii + M, a[0]);
+        std::fill(deriv.begin(), deriv.end(), 0.0);
+        for (int k = 1; k <= order; ++k) {
+            int idx = 0;
+            for (int i = 0; i < M; ++i) {
+                radii[i] += a[k] * kCos[idx] + b[k] * kSin[idx];
+                deriv[i] += k * (b[k] * kCos[idx] - a[k] * kSin[idx]);
+                idx += k;
+                if (idx >= M) idx -= M;
+            }
+        }
+
+        // 3. 面积 (解析)、周长与二阶矩 (周期梯形求积)
+        double area = a[0] * a[0];
+        for (int k = 1; k <= order; ++k) area += 0.5 * (a[k] * a[k] + b[k] * b[k]);
+        area *= kPi;
+        double perimeter = 0.0, mx = 0.0, my = 0.0, mxx = 0.0, myy = 0.0, mxy = 0.0;
+        for (int i = 0; i < M; ++i) {
+            double ri = radii[i];
+            perimeter += std::sqrt(ri * ri + deriv[i] * deriv[i]);
+            double r3 = ri * ri * ri / 3.0, r4 = ri * ri * ri * ri / 4.0;
+            mx += r3 * kCos[i];
+            my += r3 * kSin[i];
+            mxx += r4 * kCos[i] * kCos[i];
+            myy += r4 * kSin[i] * kSin[i];
+            mxy += r4 * kCos[i] * kSin[i];
+        }
+        result.area[p] = area;
+        result.circumference[p] = perimeter * dTheta;
+
+        // 等效椭圆：二阶中心矩的特征值 λ = (半轴)² / 4，轴长为 4√λ
+        if (area > 1e-12) {
+            double cx = mx * dTheta / area, cy = my * dTheta / area;
+            double sxx = mxx * dTheta / area - cx * cx;
+            double syy = myy * dTheta / area - cy * cy;
+            double sxy = mxy * dTheta / area - cx * cy;
+            double mean = 0.5 * (sxx + syy);
+            double delta = std::sqrt(0.25 * (sxx - syy) * (sxx - syy) + sxy * sxy);
+            result.longAxis[p] = 4.0 * std::sqrt(std::max(0.0, mean + delta));
+            result.shortAxis[p] = 4.0 * std::sqrt(std::max(0.0, mean - delta));
+        }
+        result.valid[p] = 1;
+    }
+}
@@ -0,0 +1,50 @@
+// Core/ProfileKernel.h
+
+#pragma once
+#include <array>
+#include <vector>
+#include <cstddef>
+
+// 截面轮廓拟合内核 (不依赖 VTK，供 GeometryUtils::computeSliceAndFit 使用)
+//
+// 输入为切片点在截面局部坐标系 (u, v) 中相对质心的坐标，每个截面：
+//   1. 极坐标分桶：36 个 10° 桶，桶内取平均半径 (角度用无分支的多项式 atan2，可向量化)
+//   2. 空桶用左右最近的非空桶的均值填补，再做 [0.25, 0.5, 0.25] 周期平滑 (与原样条拟合的前处理相同)
+//   3. 平滑后的 36 个值拟合低阶傅里叶级数 r(θ) = a0 + Σ (ak cos kθ + bk sin kθ)，k <= order
+//   4. 用编译期三角函数表在 360 个整数角度上重采样
+// 面积由系数解析得到 (π (a0² + Σ (ak² + bk²) / 2))；周长 ∫ sqrt(r² + r'²) dθ 与等效椭圆轴长所需的二阶矩
+// 在 360 个采样点上做周期梯形求积 (对三角多项式是谱精度)。
+// 多个截面以 SoA 形式成批处理 (一次评估的仿真/目标各 3 个截面)。
+class ProfileKernel {
+public:
+    static constexpr int kBins = 36;
+    static constexpr int kSamples = 360;    // 重采样点数 (每 1° 一个)
+    static constexpr int kDefaultOrder = 12;
+
+    // 多个截面的切片点 (SoA)：截面 p 的点为 x/y 的 [offsets[p], offsets[p + 1])
+    struct Batch {
+        std::vector<double> x, y;
+        std::vector<std::size_t> offsets{ 0 };
+
+        void push(double px, double py) { x.push_back(px); y.push_back(py); }
+        void close() { offsets.push_back(x.size()); }   // 结束当前截面
+        int size() const { return (int)offsets.size() - 1; }
+        void clear() { x.clear(); y.clear(); offsets.assign(1, 0); }
+    };
+
+    // 拟合结果 (SoA)：截面 p 的半径为 radii[p * kSamples, (p + 1) * kSamples)，第 i 个对应角度 i°
+    struct Result {
+        std::vector<double> radii;
+        std::vector<double> area;
+        std::vector<double> circumference;
+        std::vector<double> longAxis;         // 等效椭圆 (二阶矩相同) 的长轴/短轴长度
+        std::vector<double> shortAxis;
+        std::vector<unsigned char> valid;     // 没有任何点的截面无效
+    };
+
+    static void fit(const Batch& batch, Result& result, int order = kDefaultOrder);
+
+    // cos/sin(i°)，i = 0..359 (编译期生成)
+    static const std::array<double, kSamples>& cosTable();
+    static const std::array<double, kSamples>& sinTable();
+};
@@ -2,11 +2,21 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cstdlib>
+#ifdef _WIN32
 #include <windows.h> 
+#endif
 #include "Core/SimulationRunner.h"
+#include "Core/LossFunction.h"
 #include "Core/MaterialMapper.h"
+#include "Core/PhaseProfiler.h"
+#include "Core/PerfCounters.h"
+#include "Core/WorkerZygote.h"
+#include "Core/ThreadBudget.h"
+#include "../Optimize/Utils/CpuTopology.h"
 #include "Common.h"
 #include "../Optimize/Utils/PathUtils.h"
+#include "../Optimize/Utils/ProgressChannel.h"
 
 // 辅助：字符串转枚举
 Simulation::StentType parseStentType(const std::string& typeStr) {
@@ -19,77 +29,216 @@ Simulation::StentType parseStentType(const std::string& typeStr) {
     return Simulation::StentType::VenusA_L26;
 }
 
+static void setTitle(const std::string& title) {
+#ifdef _WIN32
+    SetConsoleTitleA(title.c_str());
+#else
+    (void)title;
+#endif
+}
+
+// 可选的硬件计数器/内存统计 (需在第一个 ScopedPhase 之前启用)，随阶段耗时一起写入输出文件
+static void enablePerfCountersFromEnv() {
+    if (const char* perf = std::getenv("SIMWORKER_PERF_COUNTERS")) {
+        if (std::atoi(perf) != 0) PerfCounters::instance().enable();
+    }
+}
+
+// 输入文件：meshRoot / outputRoot / 支架型号 各一行，随后是参数个数与参数，
+// 可选的最后一行 "threads <n> [cpus <list>]" 为 Optimizer 分给该槽位的线程预算与 CPU
+static bool readInput(const std::string& inFile, std::string& meshRoot, std::string& outputRoot,
+    std::string& stentTypeStr, std::vector<double>& params, int& threads, std::vector<int>& cpus)
+{
+    std::ifstream in(inFile);
+    if (!in.is_open()) return false;
+
+    // [修改] 1. 读取环境配置
+    std::getline(in, meshRoot);
+    std::getline(in, outputRoot);
+    std::getline(in, stentTypeStr); // 读取支架型号
+
+    // 2. 读取优化参数
+    int size;
+    if (in >> size) {
+        double val;
+        while (in >> val) params.push_back(val);
+    }
+
+    in.clear();
+    std::string key, cpuList;
+    if (in >> key && key == "threads" && in >> threads) {
+        if (in >> key && key == "cpus" && in >> cpuList) CpuTopology::parseCpuList(cpuList, cpus);
+    }
+    return true;
+}
+
+// Optimizer 给出的预算优先，其次是环境变量 (手动运行)
+static void applyThreadBudget(int threads, const std::vector<int>& cpus) {
+    if (threads > 0 || !cpus.empty()) ThreadBudget::apply(threads, cpus);
+    else ThreadBudget::applyFromEnv();
+}
+
+// 3. 配置 Config
+static SimulationConfig buildConfig(const std::string& meshRoot, const std::string& outputRoot, const std::string& stentTypeStr) {
+    SimulationConfig config;
+    config.meshRoot = meshRoot;
+    config.outputRoot = outputRoot;
+
+    // [修改] 文件名统一化
+    config.vesselInpPath = config.meshRoot + "aorta.inp";
+    config.vesselExpandedPath = config.meshRoot + "aorta_expanded.inp";
+    // 假设目标STL文件名也是统一的，或者根据实际情况修改
+    config.targetMeshPath = config.meshRoot + "target_stent.stl";
+    // 目标切面测量值：由目标 STL 测量后缓存，或放入临床测量值 (没有目标 STL 时使用)
+    config.targetSlicesPath = config.meshRoot + "target_slices.csv";
+
+    // [新增] 动态计算支架目录：Exe目录 + data/stent/
+    std::string exeDir = PathUtils::getExeDir();
+    config.stentRoot = exeDir + "data/stent/";
+
+    // [修改] 动态设置支架类型
+    config.stentType = parseStentType(stentTypeStr);
+    config.useHausdorff = true;
+
+    // [新增] 配准/距离误差的降采样体素边长 (网格单位)，默认 0 (全分辨率，误差与已有的标定/日志可比)；
+    // 通过环境变量 SIMWORKER_LOD_VOXEL 开启 (如 0.5)。开启后误差定义改变，不应与全分辨率的结果混用
+    config.lodVoxelSize = 0.0;
+    if (const char* lod = std::getenv("SIMWORKER_LOD_VOXEL")) config.lodVoxelSize = std::atof(lod);
+
+    // [新增] 误差权重/切片高度：Exe 目录下的 loss_config.txt (不存在时使用默认值，Rescore 读取同一格式)
+    LossFunction::load(exeDir + "loss_config.txt", config.loss);
+    return config;
+}
+
+static std::shared_ptr<MaterialMapper> buildMapper(const SimulationConfig& config) {
+    auto mapper = std::make_shared<MaterialMapper>();
+    // 确保这些STL文件在 meshRoot 下存在，如果命名统一则无需修改
+    mapper->addRegion("AorticAnnulus", config.meshRoot + "AorticAnnulus.stl", 10);
+    mapper->addRegion("AortomitralCurtain", config.meshRoot + "AortomitralCurtain.stl", 5);
+    mapper->addRegion("LeftVentricular", config.meshRoot + "LeftVentricular.stl", 1);
+    {
+        ScopedPhase phase("material_init");
+        mapper->initialize();
+    }
+    return mapper;
+}
+
+static void attachProgress(SimulationRunner& runner, ProgressChannel& progress) {
+    runner.setProgressCallback([&progress](const SolveProgress& p) {
+        if (p.finished) progress.setState(ProgressRecord::PostProcessing);
+        else progress.update(p.simTime, p.stopTime, p.step);
+    });
+}
+
+// 输出协议：第一行为误差，其后为 "phase <name> <ms>" 的阶段耗时
+static void writeOutput(const std::string& outFile, double error) {
+    std::ofstream out(outFile);
+    out << error << "\n";
+    PhaseProfiler::instance().writeTo(out);
+}
+
+// Zygote 模式：SimWorker --zygote <meshRoot> <stentType> <socketPath> [parentPid]
+// 预加载网格、支架与血管模型、区域距离结构和目标后，每次评估 fork 一个子进程，子进程只做与参数相关的工作
+static int runZygote(const std::string& meshRoot, const std::string& stentTypeStr, const std::string& socketPath, long parentPid) {
+    if (!WorkerZygote::supported()) return WorkerZygote::serve(socketPath, nullptr);
+    setTitle("SimWorker (zygote) - " + stentTypeStr + " - " + meshRoot);
+
+    // 预加载只做串行工作：fork 前若已启动 OpenMP 线程池，子进程中的并行区会挂起 (libgomp 不支持)
+    SimulationConfig config = buildConfig(meshRoot, "", stentTypeStr);
+    auto mapper = buildMapper(config);
+    SimulationRunner runner(config);
+    runner.setMaterialMapper(mapper);
+    runner.setOptimizationSpecs(defaultParameterSpecs());
+    if (!runner.preload()) {
+        std::cerr << "[Zygote] Failed to preload models for " << meshRoot << std::endl;
+        return 3;
+    }
+
+    return WorkerZygote::serve(socketPath, [&](const std::string& inFile, const std::string& outFile, const std::string& progressFile) {
+        // 子进程：预加载阶段的耗时不属于本次评估；计数器在 fork 后打开，只统计本进程
+        PhaseProfiler::instance().reset();
+        enablePerfCountersFromEnv();
+        ScopedPhase totalPhase("worker_total");
+
+        ProgressChannel progress;
+        if (!progressFile.empty()) progress.open(progressFile, false);
+
+        std::string requestMesh, outputRoot, requestStent;
+        std::vector<double> params;
+        int threads = 0;
+        std::vector<int> cpus;
+        if (!readInput(inFile, requestMesh, outputRoot, requestStent, params, threads, cpus)) return -2;
+        applyThreadBudget(threads, cpus);   // fork 后的子进程是单线程的，绑核对整个进程生效
+        if (requestMesh != meshRoot || requestStent != stentTypeStr) {
+            std::cerr << "[Zygote] Request for " << requestMesh << " (" << requestStent << ") sent to zygote of "
+                << meshRoot << " (" << stentTypeStr << ")" << std::endl;
+            return -3;
+        }
+
+        runner.setOutputRoot(outputRoot);
+        attachProgress(runner, progress);
+        double error = runner.run(params);
+
+        totalPhase.stop();
+        writeOutput(outFile, error);
+        return 0;
+    }, parentPid);
+}
+
 int main(int argc, char* argv[]) {
-    SetConsoleTitleA("SimWorker - Initializing...");
+    if (argc >= 5 && std::string(argv[1]) == "--zygote") {
+        long parentPid = argc >= 6 ? std::atol(argv[5]) : 0;
+        try { return runZygote(argv[2], argv[3], argv[4], parentPid); }
+        catch (...) { return 1; }
+    }
+
+    enablePerfCountersFromEnv();
+
+    // 整个 Worker 的计时，Optimizer 用 (墙钟 - worker_total) 估算进程启动/退出开销
+    ScopedPhase totalPhase("worker_total");
+    ScopedPhase startupPhase("worker_startup");
+    setTitle("SimWorker - Initializing...");
+#ifdef _WIN32
     system("chcp 65001>nul");
+#endif
 
     if (argc < 3) return -1;
     std::string inFile = argv[1];
     std::string outFile = argv[2];
 
-    try {
-        std::ifstream in(inFile);
-        if (!in.is_open()) return -2;
+    // 可选的进度通道 (argv[3])，Optimizer 据此检测求解停滞
+    ProgressChannel progress;
+    if (argc >= 4) progress.open(argv[3], false);
 
-        // [修改] 1. 读取环境配置
+    try {
         std::string meshRoot, outputRoot, stentTypeStr;
-        std::getline(in, meshRoot);
-        std::getline(in, outputRoot);
-        std::getline(in, stentTypeStr); // 读取支架型号
-
-        // 2. 读取优化参数
-        int size;
         std::vector<double> params;
-        if (in >> size) {
-            double val;
-            while (in >> val) params.push_back(val);
-        }
-
-        // 3. 配置 Config
-        SimulationConfig config;
-        config.meshRoot = meshRoot;
-        config.outputRoot = outputRoot;
+        int threads = 0;
+        std::vector<int> cpus;
+        if (!readInput(inFile, meshRoot, outputRoot, stentTypeStr, params, threads, cpus)) return -2;
+        applyThreadBudget(threads, cpus);
 
-        // [修改] 文件名统一化
-        config.vesselInpPath = config.meshRoot + "aorta.inp";
-        config.vesselExpandedPath = config.meshRoot + "aorta_expanded.inp";
-        // 假设目标STL文件名也是统一的，或者根据实际情况修改
-        config.targetMeshPath = config.meshRoot + "target_stent.stl";
-
-        // [新增] 动态计算支架目录：Exe目录 + data/stent/
-        std::string exeDir = PathUtils::getExeDir();
-        config.stentRoot = exeDir + "data/stent/";
-
-        // [修改] 动态设置支架类型
-        config.stentType = parseStentType(stentTypeStr);
-        config.useHausdorff = true;
+        SimulationConfig config = buildConfig(meshRoot, outputRoot, stentTypeStr);
 
         std::string title = "SimWorker - " + stentTypeStr + " - " + meshRoot;
-        SetConsoleTitleA(title.c_str());
+        setTitle(title);
 
         // 4. 初始化 Runner (保持不变)
-        std::vector<ParameterSpec> specs;
-        specs.push_back({ "Aorta_E", "Aorta", "E", 0.1e6, 10e6 });
-        specs.push_back({ "Valve_E", "Valve", "E", 0.1e6, 5e6 });
-        specs.push_back({ "AorticAnnulus_E", "AorticAnnulus", "E", 0.1e6, 20e6 });
-        specs.push_back({ "AortomitralCurtain_E", "AortomitralCurtain", "E", 0.1e6, 5e6 });
-        specs.push_back({ "LeftVentricular_E", "LeftVentricular", "E", 0.5e6, 30e6 });
-
-        auto mapper = std::make_shared<MaterialMapper>();
-        // 确保这些STL文件在 meshRoot 下存在，如果命名统一则无需修改
-        mapper->addRegion("AorticAnnulus", config.meshRoot + "AorticAnnulus.stl", 10);
-        mapper->addRegion("AortomitralCurtain", config.meshRoot + "AortomitralCurtain.stl", 5);
-        mapper->addRegion("LeftVentricular", config.meshRoot + "LeftVentricular.stl", 1);
-        mapper->initialize();
+        std::vector<ParameterSpec> specs = defaultParameterSpecs();
+
+        startupPhase.stop();
+
+        auto mapper = buildMapper(config);
 
         SimulationRunner runner(config);
         runner.setMaterialMapper(mapper);
         runner.setOptimizationSpecs(specs);
+        attachProgress(runner, progress);
 
         double error = runner.run(params);
 
-        std::ofstream out(outFile);
-        out << error;
+        totalPhase.stop();
+        writeOutput(outFile, error);
 
     }
     catch (...) {
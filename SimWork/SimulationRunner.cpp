@@ -2,6 +2,8 @@
 
 #include "SimulationRunner.h"
 #include "GeometryUtils.h"
+#include "LossFunction.h"
+#include "PhaseProfiler.h"
 #include "solver/TetModel.h"
 #include "Utils/IglUtils.h" // 假设你有这个用于导出的工具
 #include <sstream>
@@ -21,7 +23,9 @@ namespace fs = std::filesystem;
 SimulationRunner::SimulationRunner(const SimulationConfig& config)
 	: m_config(config) {}
 
-SimulationRunner::~SimulationRunner() {}
+SimulationRunner::~SimulationRunner() {
+    for (auto m : m_preloadedModels) delete m;
+}
 
 void SimulationRunner::setOptimizationSpecs(const std::vector<ParameterSpec>& specs) {
 	m_paramSpecs = specs;
@@ -35,8 +39,51 @@ void SimulationRunner::setSliceTargets(const std::vector<TargetSliceData>& targe
 	m_sliceTargets = targets;
 }
 
-double SimulationRunner::reNormalize(double val, double min, double max) {
-    return val * (max - min) + min;
+void SimulationRunner::setOutputRoot(const std::string& outputRoot) {
+    m_config.outputRoot = outputRoot;
+}
+
+bool SimulationRunner::preload() {
+    if (m_preloadedModels.empty()) loadModels(m_preloadedModels);
+    if (!targetLoaded()) loadTarget();
+    return m_preloadedModels.size() == 2 && targetLoaded();
+}
+
+void SimulationRunner::loadModels(std::vector<Simulation::Model*>& models) {
+    // (A) 加载支架 - 抽离到辅助函数，使代码整洁
+    {
+        ScopedPhase phase("stent_load");
+        loadStentModel(models);
+    }
+
+    // (B) 加载血管 - 使用 Config 中的路径
+    // 注意：这里需要根据你的 TetModel 构造函数适配
+    {
+        ScopedPhase phase("inp_parse");
+        models.push_back(new Simulation::TetModel(m_config.vesselInpPath, m_config.vesselExpandedPath, "vessel"));
+    }
+}
+
+void SimulationRunner::loadTarget() {
+    // 测量值模式 (或只有临床测量、没有目标 STL)：目标切面每个病人只测量一次，评估时不再处理目标网格
+    std::error_code ec;
+    if (m_config.loss.measuredSlices || !fs::exists(m_config.targetMeshPath, ec)) {
+        if (!m_config.targetSlicesPath.empty()) {
+            ScopedPhase phase("target_prepare");
+            LossFunction::loadOrMeasureTargets(m_config.targetSlicesPath, m_config.targetMeshPath,
+                LossFunction::sliceHeights(m_config.stentType, m_config.loss), m_sliceTargets);
+        }
+        if (!m_sliceTargets.empty()) return;
+    }
+
+    m_targetPoly = GeometryUtils::loadSTL(m_config.targetMeshPath);
+    if (m_targetPoly && m_config.lodVoxelSize > 0.0) {
+        m_targetLOD = GeometryUtils::loadOrBuildLOD(m_config.targetMeshPath, m_targetPoly, m_config.lodVoxelSize);
+    }
+}
+
+void SimulationRunner::setProgressCallback(std::function<void(const SolveProgress&)> callback) {
+    m_progress = std::move(callback);
 }
 
 void SimulationRunner::loadStentModel(std::vector<Simulation::Model*>& models) {
@@ -105,31 +152,6 @@ void SimulationRunner::loadStentModel(std::vector<Simulation::Model*>& models) {
 
 }
 
-// [新增] 辅助函数：获取特定支架的切片高度列表
-std::vector<double> getStandardSliceHeights(StentType type) {
-    std::vector<double> heights;
-    // 假设支架中心在 Y=0，根据长度分布切片
-    // 注意：这里的单位是 mm
-    switch (type) {
-    case StentType::VenusA_L32: // 长32mm
-        heights = { -6.0, 18.4, 35.4 };
-        break;
-    case StentType::VenusA_L29: // 长29mm
-        heights = { -5.0, 17.3, 35.3 };
-        break;
-    case StentType::VenusA_L26: // 长26mm
-        heights = { -4.5, 16.9, 35.9 };
-        break;
-    case StentType::VenusA_L23: // 长23mm
-        heights = { -7.0, 8.0, 27.5 };
-        break;
-    default: // 默认 L26
-        heights = { -4.5, 16.9, 35.9 };
-        break;
-    }
-    return heights;
-}
-
 double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     // 1. 动态解析参数 (不再硬编码索引)
     std::map<std::string, double> paramMap;
@@ -143,7 +165,7 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     for (size_t i = 0; i < m_paramSpecs.size(); ++i) {
         const auto& spec = m_paramSpecs[i];
         // 还原归一化数值
-        double realVal = reNormalize(normalizedParams[i], spec.minVal, spec.maxVal);
+        double realVal = spec.toPhysical(normalizedParams[i]);
 
         // 构建 MaterialMapper 需要的键名，例如 "Plaque_E"
         std::string key = spec.regionName + "_" + spec.paramType;
@@ -155,15 +177,10 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     if (paramMap.count("Vessel_Nu")) paramMap["Default_Nu"] = paramMap["Vessel_Nu"];
 
 
-    // 2. 构建模型 (Models)
+    // 2. 构建模型 (Models)：有预加载 (Zygote) 时直接接管，否则从文件加载
     std::vector<Simulation::Model*> models;
-
-    // (A) 加载支架 - 抽离到辅助函数，使代码整洁
-    loadStentModel(models);
-
-    // (B) 加载血管 - 使用 Config 中的路径
-    // 注意：这里需要根据你的 TetModel 构造函数适配
-    models.push_back(new Simulation::TetModel(m_config.vesselInpPath, m_config.vesselExpandedPath, "vessel"));
+    models.swap(m_preloadedModels);
+    if (models.empty()) loadModels(models);
 
     // 设置边界条件
     std::vector<int> pt_ids_0;
@@ -197,13 +214,18 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
 
     // 3. 应用材料参数
     if (m_mapper) {
+        ScopedPhase phase("material_apply");
         m_mapper->applyMaterials(models.back(), paramMap, 2.5);
     }
 
-	exportElasticModulusToTecplot( static_cast<Simulation::TetModel*>(models.back()), m_config.outputRoot + "elastic_modulus.dat",	"Vessel_ElasticModulus");
+    {
+        ScopedPhase phase("tecplot_export");
+        exportElasticModulusToTecplot(static_cast<Simulation::TetModel*>(models.back()), m_config.outputRoot + "elastic_modulus.dat", "Vessel_ElasticModulus");
+    }
 
     // 4. 初始化引擎 & 5. 运行循环 (保留原逻辑)
     // 4. 初始化引擎
+    ScopedPhase engineInitPhase("engine_init");
     cuda_Engine* engine = new cuda_Engine();
     engine->init(models, 0.1, 1.0, 20, 1.0, m_config.meshRoot, true);
     engine->set_Collision_Coefficient(30);
@@ -218,6 +240,7 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     engine->set_Output_Open(1, true);
     engine->set_Output_Stride(20);
     engine->set_Output_Path(m_config.outputRoot);
+    engineInitPhase.stop();
 
 	// 5. 运行仿真循环
     double stopTime = 14.0;
@@ -227,6 +250,7 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     int nTimeStep = 0;
 
     bool pause = false;
+    ScopedPhase solvePhase("solve_loop");
     do
     {
         nTimeStep++;
@@ -256,10 +280,14 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
             model->set_Vertice(model_verts);
         }
 
+        if (m_progress) m_progress({ currentTime, stopTime, nTimeStep, false });
+
         if (currentTime > stopTime)
             break;
 
     } while (!pause);
+    solvePhase.stop();
+    if (m_progress) m_progress({ currentTime, stopTime, nTimeStep, true });
 
 
     // 假设输出结果路径为 resultObjPath
@@ -269,80 +297,82 @@ double SimulationRunner::run(const std::vector<double>& normalizedParams) {
     // =========================================================
     // 2. 后处理与误差计算 (Heavy Modification)
     // =========================================================
-    double totalLoss = 0.0;
-
     // A. 加载
+    ScopedPhase reloadPhase("obj_reload");
     auto simPoly = GeometryUtils::loadOBJ(resultObjPath);
-    auto targetPoly = GeometryUtils::loadSTL(m_config.targetMeshPath);
-    if (!simPoly || !targetPoly) { return 1e9; }
-
-    // B. 对齐
-    //auto alignedTarget = GeometryUtils::alignToCentroid(targetPoly, simPoly);
-    auto alignedTarget = GeometryUtils::alignToICP(targetPoly, simPoly);
-
-    if (alignedTarget) {
+    if (!targetLoaded()) loadTarget();
+    auto targetPoly = m_targetPoly;
+    const bool measured = !m_sliceTargets.empty();
+    reloadPhase.stop();
+    if (!simPoly || (!targetPoly && !measured)) { return 1e9; }
+
+    // 保存紧凑的最终几何，供更换误差定义后离线重新评分 (Rescore)
+    GeometryUtils::saveCompactGeometry(m_config.outputRoot + "output/final_geometry.geo", simPoly);
+
+    // B. 配准 + 误差 (与 Rescore 共用 LossFunction)；测量值模式只切割仿真几何
+    const bool useLOD = m_config.lodVoxelSize > 0.0;
+    const GeometryUtils::PointLOD& targetLOD = m_targetLOD;
+    LossResult loss = measured
+        ? LossFunction::evaluateMeasured(simPoly, m_sliceTargets, m_config.loss)
+        : LossFunction::evaluate(simPoly, targetPoly, useLOD ? &targetLOD : nullptr, m_config.lodVoxelSize,
+            m_config.stentType, m_config.useHausdorff, m_config.loss);
+    double totalLoss = loss.total;
+
+    if (loss.alignedTarget) {
         // 使用 fs::path 拼接路径，确保跨平台斜杠安全
         std::string alignedOutPath = (fs::path(m_config.outputRoot) / "output/aligned_target.obj").string();
 
         vtkSmartPointer<vtkOBJWriter> writer = vtkSmartPointer<vtkOBJWriter>::New();
         writer->SetFileName(alignedOutPath.c_str());
-        writer->SetInputData(alignedTarget);
+        writer->SetInputData(loss.alignedTarget);
         writer->Write();
     }
 
-    // C. Hausdorff (可选)
-    if (m_config.useHausdorff) {
-        auto metrics = GeometryUtils::computeErrors(alignedTarget, simPoly);
-        totalLoss += 0.2 * metrics.rmse; 
+    if (loss.hasMetrics) {
+        std::cout << "[Metrics] Hausdorff " << loss.metrics.maxDistance << ", Mean " << loss.metrics.meanDistance
+            << ", RMSE " << loss.metrics.rmse;
+        if (useLOD) {
+            std::cout << " (LOD " << targetLOD.weights.size() << "/" << targetLOD.sourcePoints
+                << " target points, sampling bound +/-" << loss.metrics.errorBound << " at fixed alignment)";
+        }
+        std::cout << std::endl;
     }
 
-    // D. 切片计算 & 导出
-    std::vector<double> sliceHeights = getStandardSliceHeights(m_config.stentType);
-    int validSlices = 0;
-    double sliceLossSum = 0.0;
-
+    // C. 切片导出
     std::string baseName = fs::path(resultObjPath).stem().string(); 
     std::string outDir = fs::path(resultObjPath).parent_path().string();
 
-    for (size_t i = 0; i < sliceHeights.size(); ++i) {
-        double h = sliceHeights[i];
-        Eigen::Vector3d origin(0, h, 0);
-        Eigen::Vector3d normal(0, 1, 0);
-
-        GeometryUtils::ProfileData simProfile, targetProfile;
-        bool simOk = GeometryUtils::computeSliceAndFit(simPoly, origin, normal, simProfile);
-        bool targetOk = GeometryUtils::computeSliceAndFit(alignedTarget, origin, normal, targetProfile);
-
-        if (simOk && targetOk) {
-            // 1. 构造文件名
-            std::string prefix = outDir + "/" + baseName + "_slice_" + std::to_string(i);
-            
-            // 2. 导出 CSV 数据
-            GeometryUtils::saveProfileToCSV(prefix + "_sim.csv", simProfile);
-            GeometryUtils::saveProfileToCSV(prefix + "_truth.csv", targetProfile);
-
-            // 3. [新增] 导出可视化模型 (OBJ)
-            GeometryUtils::saveProfileGeometry(prefix + "_sim.obj", simProfile);
-            GeometryUtils::saveProfileGeometry(prefix + "_truth.obj", targetProfile);
-
-            // 4. 计算 Loss (保持之前逻辑)
-            double sumSqDiff = 0.0;
-            for (int k = 0; k < 360; ++k) {
-                double diff = simProfile.radii[k] - targetProfile.radii[k];
-                sumSqDiff += diff * diff;
-            }
-            double radRMSE = std::sqrt(sumSqDiff / 360.0);
-            double areaPenalty = std::abs(simProfile.area - targetProfile.area) / (targetProfile.area + 1e-6);
+    for (size_t i = 0; i < loss.sliceHeights.size(); ++i) {
+        if (!loss.sliceOk[i]) continue;
 
-            sliceLossSum += (1.0 * radRMSE + 2.0 * areaPenalty);
-            validSlices++;
-        } else {
-            sliceLossSum += 10.0;
-        }
+        // 1. 构造文件名
+        std::string prefix = outDir + "/" + baseName + "_slice_" + std::to_string(i);
+
+        // 2. 导出 CSV 数据
+        GeometryUtils::saveProfileToCSV(prefix + "_sim.csv", loss.simProfiles[i]);
+
+        // 3. [新增] 导出可视化模型 (OBJ)
+        GeometryUtils::saveProfileGeometry(prefix + "_sim.obj", loss.simProfiles[i]);
+
+        // 测量值模式没有目标轮廓
+        if (loss.measured) continue;
+        GeometryUtils::saveProfileToCSV(prefix + "_truth.csv", loss.targetProfiles[i]);
+        GeometryUtils::saveProfileGeometry(prefix + "_truth.obj", loss.targetProfiles[i]);
     }
 
-    if (validSlices > 0) totalLoss += sliceLossSum / validSlices;
-    else totalLoss += 100.0;
+    // 测量值模式：各切面的仿真测量值与目标值对照
+    if (loss.measured) {
+        std::ofstream out(outDir + "/" + baseName + "_slice_measurements.csv");
+        out << "Height,SimLongAxis,TargetLongAxis,SimShortAxis,TargetShortAxis,SimArea,TargetArea,SimCircumference,TargetCircumference\n";
+        for (size_t i = 0; i < loss.sliceHeights.size() && i < m_sliceTargets.size(); ++i) {
+            const auto& sim = loss.simProfiles[i];
+            const auto& target = m_sliceTargets[i];
+            out << target.yHeight << ",";
+            if (loss.sliceOk[i]) out << sim.longAxis << "," << target.targetLongAxis << "," << sim.shortAxis << "," << target.targetShortAxis
+                << "," << sim.area << "," << target.targetArea << "," << sim.circumference << "," << target.targetCircumference << "\n";
+            else out << "," << target.targetLongAxis << ",," << target.targetShortAxis << ",," << target.targetArea << ",," << target.targetCircumference << "\n";
+        }
+    }
 
     // 清理
     delete engine;
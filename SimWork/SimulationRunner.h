@@ -5,17 +5,19 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
 #include "MaterialMapper.h"
+#include "GeometryUtils.h"
+#include "LossFunction.h"
 #include "solver/cuda_Simulation_Engine.h"
 #include "Common.h" 
 
-// 存储目标切面的测量数据（真实值）
-struct TargetSliceData {
-    double yHeight;
-    double targetLongAxis;
-    double targetShortAxis;
-    double targetArea;
-    double targetCircumference;
+// 求解循环的进度 (每个时间步回调一次)
+struct SolveProgress {
+    double simTime;
+    double stopTime;
+    int step;
+    bool finished;   // 时间步循环结束 (随后进入后处理)
 };
 
 class SimulationRunner {
@@ -29,9 +31,21 @@ public:
     // 注册要优化的参数列表
     void setOptimizationSpecs(const std::vector<ParameterSpec>& specs);
 
-    // 设置基于切片的目标数据
+    // 设置基于切片的目标数据 (如临床测量值)；非空时误差使用测量值模式，不再加载目标网格
+    // 未设置时由 loadTarget 按 loss.measuredSlices 从 config.targetSlicesPath 读取或测量
     void setSliceTargets(const std::vector<TargetSliceData>& targets);
 
+    // 每次评估的输出目录 (Zygote 子进程在 fork 后按请求设置)
+    void setOutputRoot(const std::string& outputRoot);
+
+    // 预加载与参数无关的数据：支架/血管模型、目标网格及其降采样 (测量值模式下为目标切面测量值)。
+    // 供 Zygote 在 fork 前调用，子进程以写时复制方式共享；预加载的模型只供下一次 run() 使用 (run 会修改顶点与材料)
+    // 只做 CPU 侧加载，GPU 上下文在子进程的 engine_init 中才创建
+    bool preload();
+
+    // 设置进度回调 (在求解线程中同步调用，应保持轻量)
+    void setProgressCallback(std::function<void(const SolveProgress&)> callback);
+
     // 核心运行接口
     double run(const std::vector<double>& normalizedParams);
 
@@ -39,19 +53,6 @@ public:
 		return m_paramSpecs;
 	}
 
-private:
-    SimulationConfig m_config;
-    std::shared_ptr<MaterialMapper> m_mapper;
-    std::vector<TargetSliceData> m_sliceTargets;
-    std::vector<ParameterSpec> m_paramSpecs;
-
-    // 内部辅助：加载支架模型
-    void loadStentModel(std::vector<Simulation::Model*>& models);
-
-    // 内部辅助：归一化还原
-    double reNormalize(double val, double min, double max);
-
-
     /**
      * @brief 导出弹性模量分布到 Tecplot DAT 文件
      *
@@ -65,4 +66,24 @@ private:
         const std::string& zoneName = "ElasticModulus_Zone"
     );
 
+private:
+    SimulationConfig m_config;
+    std::shared_ptr<MaterialMapper> m_mapper;
+    std::vector<TargetSliceData> m_sliceTargets;
+    std::vector<ParameterSpec> m_paramSpecs;
+    std::function<void(const SolveProgress&)> m_progress;
+
+    // 预加载结果 (见 preload)
+    std::vector<Simulation::Model*> m_preloadedModels;
+    vtkSmartPointer<vtkPolyData> m_targetPoly;
+    GeometryUtils::PointLOD m_targetLOD;
+
+    // 内部辅助：加载支架模型
+    void loadStentModel(std::vector<Simulation::Model*>& models);
+    // 支架 + 血管 (计入 stent_load / inp_parse 阶段)
+    void loadModels(std::vector<Simulation::Model*>& models);
+    // 目标网格与 (启用时) 其降采样；测量值模式或没有目标网格时改为读取/测量目标切面
+    void loadTarget();
+    bool targetLoaded() const { return m_targetPoly || !m_sliceTargets.empty(); }
+
 };
\ No newline at end of file
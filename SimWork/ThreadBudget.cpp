@@ -0,0 +1,83 @@
+// Core/ThreadBudget.cpp
+
+#include "ThreadBudget.h"
+#include "../../Optimize/Utils/CpuTopology.h"
+#include <iostream>
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+#include <Eigen/Core>
+#include <vtkSMPTools.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+static int g_budget = 0;
+
+bool ThreadBudget::pin(const std::vector<int>& cpus) {
+    if (cpus.empty()) return true;
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < (int)(sizeof(DWORD_PTR) * 8)) mask |= (DWORD_PTR)1 << cpu;
+    }
+    return mask != 0 && SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+#elif defined(__linux__)
+    // 只作用于调用线程，之后创建的线程继承；Worker 在启动早期 (或 Zygote 子进程 fork 后) 调用
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+    }
+    return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+    return false;
+#endif
+}
+
+int ThreadBudget::allowedCpus() {
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) return std::max(1, CPU_COUNT(&mask));
+#endif
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+int ThreadBudget::apply(int threads, const std::vector<int>& cpus) {
+    if (!pin(cpus)) {
+        std::cerr << "[ThreadBudget] Failed to set CPU affinity, continuing unpinned" << std::endl;
+    }
+    if (threads <= 0) threads = allowedCpus();
+
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+    omp_set_dynamic(0);
+#endif
+    Eigen::setNbThreads(threads);
+    vtkSMPTools::Initialize(threads);
+
+    g_budget = threads;
+    return threads;
+}
+
+int ThreadBudget::applyFromEnv() {
+    const char* threadsEnv = std::getenv("SIMWORKER_THREADS");
+    const char* cpusEnv = std::getenv("SIMWORKER_CPUS");
+    if (!(threadsEnv && *threadsEnv) && !(cpusEnv && *cpusEnv)) return 0;
+    std::vector<int> cpus;
+    if (cpusEnv && *cpusEnv && !CpuTopology::parseCpuList(cpusEnv, cpus)) {
+        std::cerr << "[ThreadBudget] Invalid SIMWORKER_CPUS: " << cpusEnv << std::endl;
+        cpus.clear();
+    }
+    return apply(threadsEnv ? std::atoi(threadsEnv) : 0, cpus);
+}
+
+int ThreadBudget::current() {
+    return g_budget;
+}
@@ -0,0 +1,26 @@
+// Core/ThreadBudget.h
+
+#pragma once
+#include <string>
+#include <vector>
+
+// Worker 的 CPU 绑定与线程预算
+//
+// Optimizer 按布局策略给每个槽位分配 CPU 与线程数，通过输入文件的 "threads <n> [cpus <list>]" 行传入
+// (手动运行时可用环境变量 SIMWORKER_THREADS / SIMWORKER_CPUS)。apply() 绑定当前进程并把
+// OpenMP、VTK SMP 与 Eigen 的线程数统一限制为预算，所有并行区都不再按整机核数启动线程。
+class ThreadBudget {
+public:
+    // threads <= 0 时取绑定后可用的 CPU 数；cpus 为空时不改变亲和性。返回生效的线程数
+    static int apply(int threads, const std::vector<int>& cpus);
+
+    // 从环境变量读取预算并应用 (未设置时不做任何事，返回 0)
+    static int applyFromEnv();
+
+    // 当前生效的预算 (未应用时为 0)
+    static int current();
+
+private:
+    static bool pin(const std::vector<int>& cpus);
+    static int allowedCpus();
+};
@@ -0,0 +1,144 @@
+// Core/WorkerZygote.cpp
+
+#include "WorkerZygote.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <csignal>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#ifdef _WIN32
+
+bool WorkerZygote::supported() { return false; }
+
+int WorkerZygote::serve(const std::string&, const Evaluate&, long) {
+    std::cerr << "[Zygote] fork() is not available on this platform" << std::endl;
+    return 2;
+}
+
+#else
+
+static volatile sig_atomic_t g_stopRequested = 0;
+
+static void onStopSignal(int) { g_stopRequested = 1; }
+
+// 读取请求的三行 (带超时，防止异常客户端阻塞 Zygote)
+static bool readRequest(int fd, std::string lines[3]) {
+    std::string buffer;
+    char chunk[512];
+    while (true) {
+        size_t newlines = 0;
+        for (char c : buffer) if (c == '\n') newlines++;
+        if (newlines >= 3) break;
+        pollfd pfd{ fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 5000) <= 0) return false;
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0 || buffer.size() > 16384) return false;
+        buffer.append(chunk, (size_t)n);
+    }
+    size_t start = 0;
+    for (int i = 0; i < 3; ++i) {
+        size_t end = buffer.find('\n', start);
+        lines[i] = buffer.substr(start, end - start);
+        if (!lines[i].empty() && lines[i].back() == '\r') lines[i].pop_back();
+        start = end + 1;
+    }
+    return !lines[0].empty() && !lines[1].empty();
+}
+
+bool WorkerZygote::supported() { return true; }
+
+int WorkerZygote::serve(const std::string& socketPath, const Evaluate& evaluate, long parentPid) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[Zygote] Socket path too long: " << socketPath << std::endl;
+        return 2;
+    }
+    std::strcpy(addr.sun_path, socketPath.c_str());
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) { perror("[Zygote] socket"); return 2; }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 64) != 0) {
+        perror("[Zygote] bind/listen");
+        close(listenFd);
+        return 2;
+    }
+
+    // 子进程由内核自动回收 (客户端通过连接 EOF 得知结束，不需要退出码)
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStopSignal;
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "[Zygote] Ready on " << socketPath << std::endl;
+    while (!g_stopRequested) {
+        // 每秒检查一次父进程：Optimizer 异常退出 (未调用 stopZygote) 时 Zygote 被过继，getppid 随之改变
+        pollfd pfd{ listenFd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, 1000);
+        if (parentPid > 0 && (long)getppid() != parentPid) {
+            std::cerr << "[Zygote] Parent process " << parentPid << " exited" << std::endl;
+            break;
+        }
+        if (ready == 0 || (ready < 0 && errno == EINTR)) continue;
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            perror("[Zygote] accept");
+            break;
+        }
+        std::string request[3];
+        if (!readRequest(fd, request)) {
+            close(fd);
+            continue;
+        }
+
+        // 继承的 stdio 缓冲在 fork 前清空，避免子进程重复输出
+        std::cout.flush();
+        std::cerr.flush();
+        fflush(nullptr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("[Zygote] fork");
+            close(fd);
+            continue;
+        }
+        if (pid == 0) {
+            // 子进程：恢复默认信号处置，只保留本次请求的连接
+            close(listenFd);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGINT, SIG_DFL);
+            signal(SIGCHLD, SIG_DFL);
+            std::string hello = "pid " + std::to_string((long)getpid()) + "\n";
+            send(fd, hello.data(), hello.size(), MSG_NOSIGNAL);
+
+            int code = 1;
+            try { code = evaluate(request[0], request[1], request[2]); }
+            catch (...) { code = 1; }
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(nullptr);
+            // 不运行静态析构 (其状态属于 Zygote)，连接随进程退出关闭
+            _exit(code);
+        }
+        close(fd);
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    std::cout << "[Zygote] Shutting down" << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,26 @@
+// Core/WorkerZygote.h
+
+#pragma once
+#include <string>
+#include <functional>
+
+// Zygote 服务端 (SimWorker --zygote)：预加载完成后在本地套接字上等待评估请求，
+// 每个请求 fork 一个子进程执行，静态数据 (网格、支架模型、区域距离结构、目标) 以写时复制方式共享，
+// 子进程崩溃不影响 Zygote 与其他评估。
+//
+// 协议 (每个连接一次评估，客户端见 ProcessUtils::runWorkerZygote)：
+//   客户端 -> "<输入文件>\n<输出文件>\n<进度文件>\n"  (与普通 SimWorker 的 argv[1..3] 相同)
+//   子进程 -> "pid <子进程 pid>\n"                      (客户端据此在超时/停滞时直接终止子进程)
+//   子进程退出 -> 连接关闭 (EOF)，客户端读取输出文件
+//
+// 仅支持 POSIX (fork)；Windows 下 serve() 直接返回失败，Optimizer 回退为每次启动新进程
+class WorkerZygote {
+public:
+    // 在子进程中执行一次评估，返回值作为子进程退出码
+    using Evaluate = std::function<int(const std::string& inputFile, const std::string& outputFile, const std::string& progressFile)>;
+
+    static bool supported();
+
+    // 监听 socketPath 并处理请求，直到收到 SIGTERM/SIGINT 或父进程 parentPid 退出 (<= 0 表示不检查)；返回进程退出码
+    static int serve(const std::string& socketPath, const Evaluate& evaluate, long parentPid = 0);
+};